@@ -0,0 +1,7 @@
+namespace MochiSharp.Benchmarks.Managed.Fixtures
+{
+    // No fields and no constructor body: creating it measures the host's instance bookkeeping only.
+    internal class EmptyFixture
+    {
+    }
+}
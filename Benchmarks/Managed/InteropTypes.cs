@@ -0,0 +1,27 @@
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Benchmarks.Managed
+{
+    [StructLayout(LayoutKind.Sequential)]
+    public struct Vector3
+    {
+        public float X;
+        public float Y;
+        public float Z;
+
+        public Vector3(float x, float y, float z)
+        {
+            X = x;
+            Y = y;
+            Z = z;
+        }
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct Transform
+    {
+        public Vector3 Position;
+        public Vector3 Rotation;
+        public Vector3 Scale;
+    }
+}
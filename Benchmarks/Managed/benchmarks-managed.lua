@@ -0,0 +1,28 @@
+project "MochiSharp.Benchmarks.Managed"
+    location "%{wks.location}/Benchmarks/Managed"
+    kind "SharedLib"
+    language "C#"
+    dotnetframework "net9.0"
+
+    targetdir (OUTPUT_DIR)
+    objdir (INTOUTPUT_DIR)
+
+    files {
+        "**.cs"
+    }
+
+    filter { "action:vs* or system:windows" }
+        vsprops {
+            AppendTargetFrameworkToOutputPath = "false",
+            Nullable = "enable",
+            CopyLocalLockFileAssemblies = "true",
+            EnableDynamicLoading = "true",
+            ImplicitUsing = "enable"
+        }
+
+    filter "configurations:Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        optimize "on"
+        symbols "off"
@@ -0,0 +1,132 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+
+namespace MochiSharp::Benchmarks
+{
+    // Linear interpolation between the closest ranks of sorted samples.
+    static double Percentile(const std::vector<double> &sorted, double p)
+    {
+        double rank = p * (sorted.size() - 1);
+        size_t lower = static_cast<size_t>(rank);
+        size_t upper = std::min(lower + 1, sorted.size() - 1);
+        return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+    }
+
+    static std::string EscapeJson(std::string_view text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    escaped += std::format("\\u{:04x}", c);
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+        }
+        return escaped;
+    }
+
+    bool Runner::Enabled(std::string_view name) const
+    {
+        return m_Options.Filter.empty() || name.find(m_Options.Filter) != std::string_view::npos;
+    }
+
+    void Runner::Add(std::string_view name, std::vector<double> nsPerOp, int opsPerSample)
+    {
+        if (nsPerOp.empty())
+        {
+            Skip(name, "no samples");
+            return;
+        }
+
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+
+        Result result;
+        result.Name = name;
+        result.Samples = static_cast<int>(nsPerOp.size());
+        result.OpsPerSample = opsPerSample;
+        result.Min = nsPerOp.front();
+        result.Max = nsPerOp.back();
+        result.Mean = std::accumulate(nsPerOp.begin(), nsPerOp.end(), 0.0) / nsPerOp.size();
+        result.P50 = Percentile(nsPerOp, 0.50);
+        result.P90 = Percentile(nsPerOp, 0.90);
+        result.P99 = Percentile(nsPerOp, 0.99);
+        m_Results.push_back(std::move(result));
+    }
+
+    void Runner::Skip(std::string_view name, std::string_view reason)
+    {
+        Result result;
+        result.Name = name;
+        result.Skipped = reason;
+        m_Results.push_back(std::move(result));
+    }
+
+    void Runner::WriteJson(std::ostream &out) const
+    {
+#ifdef _WIN32
+        constexpr const char *Platform = "windows";
+#else
+        constexpr const char *Platform = "linux";
+#endif
+#ifdef NDEBUG
+        constexpr const char *Configuration = "Release";
+#else
+        constexpr const char *Configuration = "Debug";
+#endif
+        auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+
+        out << "{\n";
+        out << "  \"schema\": 1,\n";
+        out << std::format("  \"platform\": \"{}\",\n", Platform);
+        out << std::format("  \"configuration\": \"{}\",\n", Configuration);
+        out << std::format("  \"timestamp\": \"{:%FT%TZ}\",\n", now);
+        out << "  \"unit\": \"ns\",\n";
+        out << "  \"results\": [";
+        for (size_t i = 0; i < m_Results.size(); i++)
+        {
+            const Result &r = m_Results[i];
+            out << (i == 0 ? "\n" : ",\n");
+            if (!r.Skipped.empty())
+            {
+                out << std::format("    {{ \"name\": \"{}\", \"skipped\": \"{}\" }}", EscapeJson(r.Name), EscapeJson(r.Skipped));
+                continue;
+            }
+
+            out << std::format("    {{ \"name\": \"{}\", \"samples\": {}, \"opsPerSample\": {}, "
+                "\"min\": {:.2f}, \"mean\": {:.2f}, \"p50\": {:.2f}, \"p90\": {:.2f}, \"p99\": {:.2f}, \"max\": {:.2f} }}",
+                EscapeJson(r.Name), r.Samples, r.OpsPerSample, r.Min, r.Mean, r.P50, r.P90, r.P99, r.Max);
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void Runner::WriteTable(std::ostream &out) const
+    {
+        out << std::format("{:<40} {:>12} {:>12} {:>12} {:>12}\n", "benchmark (ns/op)", "p50", "p90", "p99", "max");
+        for (const Result &r : m_Results)
+        {
+            if (!r.Skipped.empty())
+            {
+                out << std::format("{:<40} skipped: {}\n", r.Name, r.Skipped);
+                continue;
+            }
+
+            out << std::format("{:<40} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n", r.Name, r.P50, r.P90, r.P99, r.Max);
+        }
+    }
+}
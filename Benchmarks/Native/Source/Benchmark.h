@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MochiSharp::Benchmarks
+{
+    // Per-operation timings of one benchmark, in nanoseconds. Each sample times OpsPerSample
+    // operations back to back and is divided by that count, which keeps clock overhead out of
+    // fast operations; percentiles are taken over the samples.
+    struct Result
+    {
+        std::string Name;
+        int Samples = 0;
+        int OpsPerSample = 0;
+        double Min = 0.0;
+        double Mean = 0.0;
+        double P50 = 0.0;
+        double P90 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+        std::string Skipped; // why the benchmark did not run, empty if it did
+    };
+
+    struct Options
+    {
+        int Samples = 200;
+        // Untimed calls before the first sample; long enough for tiered JIT to promote the callee.
+        double WarmupMs = 100.0;
+        // Only benchmarks whose name contains this run.
+        std::string Filter;
+    };
+
+    class Runner
+    {
+    public:
+        explicit Runner(Options options) : m_Options(std::move(options)) {}
+
+        const Options &Settings() const { return m_Options; }
+        bool Enabled(std::string_view name) const;
+
+        // Warms up, then times Samples samples of opsPerSample calls to op().
+        template<typename Op>
+        void Measure(std::string_view name, int opsPerSample, Op &&op);
+        // Same, for operations that need untimed work around each sample: setup(), then op(i) for
+        // i in [0, opsPerSample) timed, then teardown().
+        template<typename Setup, typename Op, typename Teardown>
+        void MeasureWith(std::string_view name, int opsPerSample, Setup &&setup, Op &&op, Teardown &&teardown);
+
+        // Records samples that were timed by the caller, e.g. operations that need untimed setup.
+        void Add(std::string_view name, std::vector<double> nsPerOp, int opsPerSample);
+
+        template<typename Fn>
+        static double TimeNs(Fn &&fn);
+
+        // A benchmark that could not run is reported with zero samples instead of being left out.
+        void Skip(std::string_view name, std::string_view reason);
+
+        const std::vector<Result> &Results() const { return m_Results; }
+        void WriteJson(std::ostream &out) const;
+        void WriteTable(std::ostream &out) const;
+
+    private:
+        Options m_Options;
+        std::vector<Result> m_Results;
+    };
+
+    template<typename Op>
+    void Runner::Measure(std::string_view name, int opsPerSample, Op &&op)
+    {
+        MeasureWith(name, opsPerSample, [] {}, [&](int) { op(); }, [] {});
+    }
+
+    template<typename Setup, typename Op, typename Teardown>
+    void Runner::MeasureWith(std::string_view name, int opsPerSample, Setup &&setup, Op &&op, Teardown &&teardown)
+    {
+        if (!Enabled(name))
+        {
+            return;
+        }
+
+        auto runSample = [&]
+        {
+            setup();
+            double ns = TimeNs([&]
+            {
+                for (int i = 0; i < opsPerSample; i++)
+                {
+                    op(i);
+                }
+            });
+            teardown();
+            return ns / opsPerSample;
+        };
+
+        auto warmupEnd = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(m_Options.WarmupMs);
+        do
+        {
+            runSample();
+        } while (std::chrono::steady_clock::now() < warmupEnd);
+
+        std::vector<double> samples(m_Options.Samples);
+        for (double &sample : samples)
+        {
+            sample = runSample();
+        }
+
+        Add(name, std::move(samples), opsPerSample);
+    }
+
+    template<typename Fn>
+    double Runner::TimeNs(Fn &&fn)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+#endif // !BENCHMARK_H
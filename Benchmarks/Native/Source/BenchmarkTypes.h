@@ -0,0 +1,29 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef BENCHMARK_TYPES_H
+#define BENCHMARK_TYPES_H
+
+#include "Host.h"
+
+// Layouts match MochiSharp.Benchmarks.Managed (InteropTypes.cs).
+namespace MochiSharp::Benchmarks
+{
+    struct Vector3
+    {
+        float X;
+        float Y;
+        float Z;
+    };
+
+    struct Transform
+    {
+        Vector3 Position;
+        Vector3 Rotation;
+        Vector3 Scale;
+    };
+}
+
+MOCHI_MANAGED_TYPE(MochiSharp::Benchmarks::Vector3, "MochiSharp.Benchmarks.Managed.Vector3, MochiSharp.Benchmarks.Managed");
+MOCHI_MANAGED_TYPE(MochiSharp::Benchmarks::Transform, "MochiSharp.Benchmarks.Managed.Transform, MochiSharp.Benchmarks.Managed");
+
+#endif // !BENCHMARK_TYPES_H
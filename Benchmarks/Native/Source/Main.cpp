@@ -0,0 +1,395 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+// Interop micro-benchmarks. Writes per-operation percentiles as JSON (--out, default
+// benchmark-results.json) and a summary table to stdout; compare the JSON of two builds to catch
+// regressions. Options: --out <path>, --samples <n>, --warmup-ms <ms>, --filter <substring>.
+
+#include "Host.h"
+#include "Benchmark.h"
+#include "BenchmarkTypes.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace MochiSharp::Benchmarks;
+
+static constexpr const char *FixtureAssembly = "MochiSharp.Benchmarks.Managed.dll";
+static constexpr const char *InvokeFixture = "MochiSharp.Benchmarks.Managed.Fixtures.InvokeFixture";
+static constexpr const char *EmptyFixture = "MochiSharp.Benchmarks.Managed.Fixtures.EmptyFixture";
+
+// Operations per sample for calls that take tens of nanoseconds, and for heavier ones.
+static constexpr int CallOps = 1000;
+static constexpr int BatchOps = 100;
+static constexpr int LoadSamples = 20;
+
+// Signature ids registered for the fixture; they double as indices into Shapes.
+namespace Signature
+{
+    enum : int
+    {
+        Void = 0,
+        Void_Float = 1,
+        Void_Int = 2,
+        Void_Bool = 3,
+        Int_IntInt = 4,
+        Vector3_Vector3Vector3 = 5,
+        Void_Transform = 6,
+        Transform = 7,
+    };
+}
+
+// Every signature shape the benchmarks cover, with its InvokeFixture method.
+struct Shape
+{
+    int Id;
+    const char *Name;
+    const char *Method;
+    const char *ReturnType;
+    const char *ParameterTypes[2];
+    int ParameterCount;
+};
+
+static const char *const Vector3Name = MochiSharp::ManagedType<Vector3>::Name;
+static const char *const TransformName = MochiSharp::ManagedType<Transform>::Name;
+
+static const Shape Shapes[] = {
+    { Signature::Void, "Void", "Nop", "System.Void", {}, 0 },
+    { Signature::Void_Float, "Void_Float", "TakeFloat", "System.Void", { "System.Single" }, 1 },
+    { Signature::Void_Int, "Void_Int", "TakeInt", "System.Void", { "System.Int32" }, 1 },
+    { Signature::Void_Bool, "Void_Bool", "TakeBool", "System.Void", { "System.Boolean" }, 1 },
+    { Signature::Int_IntInt, "Int_IntInt", "AddInt", "System.Int32", { "System.Int32", "System.Int32" }, 2 },
+    { Signature::Vector3_Vector3Vector3, "Vector3_Vector3Vector3", "AddVector", Vector3Name, { Vector3Name, Vector3Name }, 2 },
+    { Signature::Void_Transform, "Void_Transform", "SetTransform", "System.Void", { TransformName }, 1 },
+    { Signature::Transform, "Transform", "GetTransform", TransformName, {}, 0 },
+};
+
+// Argument values and a return buffer for every shape, laid out the way Invoke expects them.
+struct CallArgs
+{
+    float F = 0.016f;
+    int32_t I = 1;
+    int32_t B = 1;
+    int32_t A0 = 2;
+    int32_t A1 = 3;
+    Vector3 V0 = { 1, 2, 3 };
+    Vector3 V1 = { 4, 5, 6 };
+    Transform T = { { 1, 1, 1 }, { 0, 0, 0 }, { 1, 1, 1 } };
+    alignas(16) unsigned char Return[sizeof(Transform)] = {};
+
+    void *Args[8][2] = {
+        {},
+        { &F },
+        { &I },
+        { &B },
+        { &A0, &A1 },
+        { &V0, &V1 },
+        { &T },
+        {},
+    };
+
+    void **For(const Shape &shape) { return shape.ParameterCount ? Args[shape.Id] : nullptr; }
+};
+
+static std::string BenchName(const char *group, const char *shape)
+{
+    return std::string(group) + "/" + shape;
+}
+
+static bool RegisterSignatures(MochiSharp::DotNetHost &host)
+{
+    for (const Shape &shape : Shapes)
+    {
+        if (!host.RegisterSignature(shape.Id, shape.ReturnType, const_cast<const char **>(shape.ParameterTypes), shape.ParameterCount))
+        {
+            std::println("[Bench] Failed to register signature {}", shape.Name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RunLoadBenchmarks(Runner &runner, MochiSharp::DotNetHost &host)
+{
+    // The first load also loads the fixture's dependencies and JITs the loader; later ones replace
+    // the context, as a reload does.
+    double cold = Runner::TimeNs([&] { host.LoadAssembly(FixtureAssembly); });
+    if (runner.Enabled("Host/LoadAssembly.Cold"))
+    {
+        runner.Add("Host/LoadAssembly.Cold", { cold }, 1);
+    }
+
+    if (runner.Enabled("Host/LoadAssembly.Warm"))
+    {
+        std::vector<double> samples(std::min(runner.Settings().Samples, LoadSamples));
+        for (double &sample : samples)
+        {
+            sample = Runner::TimeNs([&] { host.LoadAssembly(FixtureAssembly); });
+            host.PollUnload(1.0);
+        }
+        runner.Add("Host/LoadAssembly.Warm", std::move(samples), 1);
+    }
+
+    constexpr int ShapeCount = static_cast<int>(std::size(Shapes));
+    runner.Measure("Host/RegisterSignature", ShapeCount, [&, i = 0]() mutable
+    {
+        const Shape &shape = Shapes[i++ % ShapeCount];
+        host.RegisterSignature(shape.Id, shape.ReturnType, const_cast<const char **>(shape.ParameterTypes), shape.ParameterCount);
+    });
+}
+
+static void RunInstanceBenchmarks(Runner &runner, MochiSharp::DotNetHost &host)
+{
+    std::vector<MochiSharp::InstanceHandle> instances(BatchOps);
+    auto createAll = [&] { for (auto &instance : instances) instance = host.CreateInstance(EmptyFixture); };
+    auto destroyAll = [&] { for (auto instance : instances) host.DestroyInstance(instance); };
+
+    runner.MeasureWith("Instance/CreateInstance", BatchOps, [] {},
+        [&](int i) { instances[i] = host.CreateInstance(EmptyFixture); }, destroyAll);
+    runner.MeasureWith("Instance/DestroyInstance", BatchOps, createAll,
+        [&](int i) { host.DestroyInstance(instances[i]); }, [] {});
+
+    // New keys every sample, as for entities spawned from a scene.
+    std::vector<MochiSharp::ScriptGuid> guids(BatchOps);
+    std::vector<std::string> guidStrings(BatchOps);
+    uint32_t nextGuid = 1;
+    auto newGuids = [&]
+    {
+        for (int i = 0; i < BatchOps; i++)
+        {
+            guids[i] = {};
+            guids[i].Data1 = nextGuid++;
+            guids[i].Data4[7] = 0xBE;
+            guidStrings[i] = guids[i].ToString();
+        }
+    };
+    auto destroyGuids = [&] { for (const auto &guid : guids) host.DestroyInstanceGuid(guid); };
+
+    runner.MeasureWith("Instance/CreateInstanceGuid", BatchOps, newGuids,
+        [&](int i) { host.CreateInstanceGuid(EmptyFixture, guids[i]); }, destroyGuids);
+    runner.MeasureWith("Instance/CreateInstanceGuid.String", BatchOps, newGuids,
+        [&](int i) { host.CreateInstanceGuid(EmptyFixture, guidStrings[i].c_str()); }, destroyGuids);
+    runner.MeasureWith("Instance/DestroyInstanceGuid", BatchOps, [&] { newGuids(); for (const auto &guid : guids) host.CreateInstanceGuid(EmptyFixture, guid); },
+        [&](int i) { host.DestroyInstanceGuid(guids[i]); }, [] {});
+}
+
+static void RunBindBenchmarks(Runner &runner, MochiSharp::DotNetHost &host)
+{
+    MochiSharp::InstanceHandle instance = host.CreateInstance(InvokeFixture);
+    if (!instance)
+    {
+        runner.Skip("Bind", "failed to create the fixture");
+        return;
+    }
+
+    std::vector<MochiSharp::MethodHandle> methods(BatchOps);
+    auto unbindAll = [&] { for (auto method : methods) host.UnbindMethod(method); };
+
+    runner.MeasureWith("Bind/BindInstanceMethod", BatchOps, [] {},
+        [&](int i) { methods[i] = host.BindInstanceMethod(instance, "TakeFloat", Signature::Void_Float); }, unbindAll);
+    runner.MeasureWith("Bind/BindTypeMethod", BatchOps, [] {},
+        [&](int i) { methods[i] = host.BindTypeMethod(InvokeFixture, "TakeFloat", Signature::Void_Float); }, unbindAll);
+    runner.MeasureWith("Bind/UnbindMethod", BatchOps,
+        [&] { for (auto &method : methods) method = host.BindInstanceMethod(instance, "TakeFloat", Signature::Void_Float); },
+        [&](int i) { host.UnbindMethod(methods[i]); }, [] {});
+    host.DestroyInstance(instance);
+
+    // Direct pointers are released with their instance, so every sample binds on a new one.
+    runner.MeasureWith("Bind/BindInstanceMethodPtr", BatchOps, [&] { instance = host.CreateInstance(InvokeFixture); },
+        [&](int) { host.BindInstanceMethodPtr(instance, "TakeFloat", Signature::Void_Float); }, [&] { host.DestroyInstance(instance); });
+    runner.MeasureWith("Bind/Typed", BatchOps, [&] { instance = host.CreateInstance(InvokeFixture); },
+        [&](int) { host.Bind<void(float)>(instance, "TakeFloat"); }, [&] { host.DestroyInstance(instance); });
+}
+
+static void RunInvokeBenchmarks(Runner &runner, MochiSharp::DotNetHost &host)
+{
+    MochiSharp::InstanceHandle instance = host.CreateInstance(InvokeFixture);
+    if (!instance)
+    {
+        runner.Skip("Invoke", "failed to create the fixture");
+        return;
+    }
+
+    CallArgs call;
+    for (const Shape &shape : Shapes)
+    {
+        std::string name = BenchName("Invoke", shape.Name);
+        MochiSharp::MethodHandle method = host.BindInstanceMethod(instance, shape.Method, shape.Id);
+        if (!method)
+        {
+            runner.Skip(name, "bind failed");
+            continue;
+        }
+
+        void **args = call.For(shape);
+        runner.Measure(name, CallOps, [&] { host.Invoke(method, args, shape.ParameterCount, call.Return); });
+        host.UnbindMethod(method);
+
+        name = BenchName("InvokeOn", shape.Name);
+        MochiSharp::MethodHandle typeMethod = host.BindTypeMethod(InvokeFixture, shape.Method, shape.Id);
+        if (!typeMethod)
+        {
+            runner.Skip(name, "bind failed");
+            continue;
+        }
+
+        runner.Measure(name, CallOps, [&] { host.InvokeOn(typeMethod, instance, args, shape.ParameterCount, call.Return); });
+        host.UnbindMethod(typeMethod);
+    }
+
+    auto direct = [&](const Shape &shape, auto &&invoke)
+    {
+        std::string name = BenchName("Direct", shape.Name);
+        MochiSharp::NativeMethod method = host.BindInstanceMethodPtr(instance, shape.Method, shape.Id);
+        if (!method)
+        {
+            runner.Skip(name, "bind failed");
+            return;
+        }
+        runner.Measure(name, CallOps, [&] { invoke(method); });
+    };
+
+    Vector3 vectorResult{};
+    Transform transformResult{};
+    int32_t intResult = 0;
+    direct(Shapes[Signature::Void], [&](const MochiSharp::NativeMethod &m) { m.Call<void>(); });
+    direct(Shapes[Signature::Void_Float], [&](const MochiSharp::NativeMethod &m) { m.Call<void>(call.F); });
+    direct(Shapes[Signature::Void_Int], [&](const MochiSharp::NativeMethod &m) { m.Call<void>(call.I); });
+    direct(Shapes[Signature::Void_Bool], [&](const MochiSharp::NativeMethod &m) { m.Call<void>(call.B); });
+    direct(Shapes[Signature::Int_IntInt], [&](const MochiSharp::NativeMethod &m) { intResult = m.Call<int32_t>(call.A0, call.A1); });
+    direct(Shapes[Signature::Vector3_Vector3Vector3], [&](const MochiSharp::NativeMethod &m) { vectorResult = m.Call<Vector3>(call.V0, call.V1); });
+    direct(Shapes[Signature::Void_Transform], [&](const MochiSharp::NativeMethod &m) { m.Call<void>(call.T); });
+    direct(Shapes[Signature::Transform], [&](const MochiSharp::NativeMethod &m) { transformResult = m.Call<Transform>(); });
+
+    auto typed = [&](const Shape &shape, const auto &method, auto &&invoke)
+    {
+        std::string name = BenchName("Typed", shape.Name);
+        if (!method)
+        {
+            runner.Skip(name, "bind failed");
+            return;
+        }
+        runner.Measure(name, CallOps, invoke);
+    };
+
+    auto nop = host.Bind<void()>(instance, "Nop");
+    auto takeFloat = host.Bind<void(float)>(instance, "TakeFloat");
+    auto takeInt = host.Bind<void(int32_t)>(instance, "TakeInt");
+    auto takeBool = host.Bind<void(bool)>(instance, "TakeBool");
+    auto addInt = host.Bind<int32_t(int32_t, int32_t)>(instance, "AddInt");
+    auto addVector = host.Bind<Vector3(Vector3, Vector3)>(instance, "AddVector");
+    auto setTransform = host.Bind<void(Transform)>(instance, "SetTransform");
+    auto getTransform = host.Bind<Transform()>(instance, "GetTransform");
+    typed(Shapes[Signature::Void], nop, [&] { nop(); });
+    typed(Shapes[Signature::Void_Float], takeFloat, [&] { takeFloat(call.F); });
+    typed(Shapes[Signature::Void_Int], takeInt, [&] { takeInt(call.I); });
+    typed(Shapes[Signature::Void_Bool], takeBool, [&] { takeBool(true); });
+    typed(Shapes[Signature::Int_IntInt], addInt, [&] { intResult = addInt(call.A0, call.A1); });
+    typed(Shapes[Signature::Vector3_Vector3Vector3], addVector, [&] { vectorResult = addVector(call.V0, call.V1); });
+    typed(Shapes[Signature::Void_Transform], setTransform, [&] { setTransform(call.T); });
+    typed(Shapes[Signature::Transform], getTransform, [&] { transformResult = getTransform(); });
+
+    host.DestroyInstance(instance);
+
+    // Keeps the results observable so the calls are not optimized out.
+    if (intResult != call.A0 + call.A1 || vectorResult.X != call.V0.X + call.V1.X || transformResult.Position.X != call.T.Position.X)
+    {
+        std::println("[Bench] Unexpected call results");
+    }
+}
+
+#ifdef _WIN32
+int __cdecl wmain(int argc, wchar_t *argv[])
+#else
+int main(int argc, char *argv[])
+#endif
+{
+    Options options;
+    std::filesystem::path outPath = "benchmark-results.json";
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string flag = std::filesystem::path(argv[i]).string();
+        std::string value = std::filesystem::path(argv[i + 1]).string();
+        if (flag == "--out")
+        {
+            outPath = argv[i + 1];
+        }
+        else if (flag == "--samples")
+        {
+            options.Samples = std::max(1, std::stoi(value));
+        }
+        else if (flag == "--warmup-ms")
+        {
+            options.WarmupMs = std::stod(value);
+        }
+        else if (flag == "--filter")
+        {
+            options.Filter = value;
+        }
+        else
+        {
+            std::println("[Bench] Unknown option {}", flag);
+            return 1;
+        }
+    }
+
+    Runner runner(options);
+
+    MochiSharp::DotNetHost host;
+    host.Log().SetMinLevel(MochiSharp::LogLevel::Warning);
+
+    bool initialized = false;
+    double initNs = Runner::TimeNs([&] { initialized = host.Init("MochiSharp.Managed.runtimeconfig.json"); });
+    if (!initialized)
+    {
+        std::println("[Bench] Host init failed");
+        return 1;
+    }
+
+    // Init runs once per process, so each phase is a single sample.
+    const MochiSharp::StartupTimings &startup = host.GetStartupTimings();
+    const std::pair<const char *, double> initPhases[] = {
+        { "Host/Init", initNs },
+        { "Host/Init.ResolveHostFxr", startup.ResolveHostFxrMs * 1e6 },
+        { "Host/Init.LoadHostFxr", startup.LoadHostFxrMs * 1e6 },
+        { "Host/Init.InitRuntime", startup.InitRuntimeMs * 1e6 },
+        { "Host/Init.GetDelegate", startup.GetDelegateMs * 1e6 },
+        { "Host/Init.LoadCore", startup.LoadCoreMs * 1e6 },
+        { "Host/Init.ManagedInit", startup.ManagedInitMs * 1e6 },
+    };
+    for (const auto &[name, ns] : initPhases)
+    {
+        if (runner.Enabled(name))
+        {
+            runner.Add(name, { ns }, 1);
+        }
+    }
+
+    RunLoadBenchmarks(runner, host);
+    if (!RegisterSignatures(host))
+    {
+        return 1;
+    }
+
+    RunInstanceBenchmarks(runner, host);
+    RunBindBenchmarks(runner, host);
+    RunInvokeBenchmarks(runner, host);
+
+    host.Log().Flush();
+    runner.WriteTable(std::cout);
+
+    std::ofstream out(outPath);
+    if (!out)
+    {
+        std::println("[Bench] Cannot write {}", outPath.string());
+        return 1;
+    }
+    runner.WriteJson(out);
+    std::println("[Bench] Wrote {}", outPath.string());
+    return 0;
+}
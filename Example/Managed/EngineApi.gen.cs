@@ -0,0 +1,53 @@
+// <auto-generated>
+// Generated by Tools/engine-api.lua from Example/example-engine-api.lua; do not edit.
+// </auto-generated>
+using System.Runtime.InteropServices;
+using MochiSharp.Managed.Core;
+
+namespace Example.Managed.Interop
+{
+    // Layout matches ExampleInterop::EngineApi.
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct EngineApiTable
+    {
+        public const uint CurrentVersion = 1;
+
+        public EngineApiHeader Header;
+        public delegate* unmanaged[Cdecl]<double> GetTime;
+        public delegate* unmanaged[Cdecl]<ulong> GetFrameIndex;
+        public delegate* unmanaged[Cdecl]<int, int> IsKeyDown;
+        public delegate* unmanaged[Cdecl]<Vector3, Vector3, float, Vector3*, int> Raycast;
+    }
+
+    // Calls into the engine: one load of the cached table and an indirect call, nothing marshaled.
+    // Check IsAvailable (or Has<Name> for entries added after the engine was built) before calling.
+    public static unsafe class Engine
+    {
+        private static readonly EngineApiTable* _table = EngineApi.Get<EngineApiTable>(EngineApiTable.CurrentVersion);
+
+        public static bool IsAvailable => _table != null;
+
+        // Seconds since the engine started.
+        public static double GetTime() => _table->GetTime();
+        public static bool HasGetTime => _table != null && _table->GetTime != null;
+
+        // Frames completed so far.
+        public static ulong GetFrameIndex() => _table->GetFrameIndex();
+        public static bool HasGetFrameIndex => _table != null && _table->GetFrameIndex != null;
+
+        // True while the key is held.
+        public static bool IsKeyDown(int key) => _table->IsKeyDown(key) != 0;
+        public static bool HasIsKeyDown => _table != null && _table->IsKeyDown != null;
+
+        // Casts a ray against the scene; hit receives the nearest hit point.
+        public static bool Raycast(Vector3 origin, Vector3 direction, float maxDistance, out Vector3 hit)
+        {
+            hit = default;
+            fixed (Vector3* hitPtr = &hit)
+            {
+                return _table->Raycast(origin, direction, maxDistance, hitPtr) != 0;
+            }
+        }
+        public static bool HasRaycast => _table != null && _table->Raycast != null;
+    }
+}
@@ -0,0 +1,28 @@
+using Example.Managed.Interop;
+
+namespace Example.Managed.Scripts
+{
+    // No-op methods covering every ScriptMethodSignature, used by the native invoke benchmark.
+    internal class InvokeBenchmark
+    {
+        private Transform _transform;
+        private float _accumulator;
+        private int _counter;
+
+        public void Nop() { }
+
+        public void TakeFloat(float value) => _accumulator += value;
+
+        public void TakeInt(int value) => _counter += value;
+
+        public void TakeBool(bool value) => _counter += value ? 1 : 0;
+
+        public int AddInt(int a, int b) => a + b;
+
+        public Vector3 AddVector(Vector3 a, Vector3 b) => new(a.X + b.X, a.Y + b.Y, a.Z + b.Z);
+
+        public void SetTransform(Transform transform) => _transform = transform;
+
+        public Transform GetTransform() => _transform;
+    }
+}
@@ -0,0 +1,36 @@
+using Example.Managed.Interop;
+using MochiSharp.Managed.Core;
+
+namespace Example.Managed.Scripts
+{
+    // Only touches its own fields, so the native ScriptScheduler may update many movers at once.
+    [ParallelSafe]
+    internal class Mover
+    {
+        // The engine's transform array, indexed by entity; written in place, no invoke needed.
+        private static readonly SharedBuffer<Transform> s_transforms = SharedBuffer<Transform>.Get("Transforms");
+
+        private Vector3 _position;
+        private Vector3 _velocity = new(1.0f, 0.5f, 0.25f);
+        private int _entity = -1;
+
+        public void SetEntity(int entity) => _entity = entity;
+
+        public void OnUpdate(float deltaTime)
+        {
+            // Some per-entity work, so the frame is not dominated by call overhead.
+            for (int i = 0; i < 16; i++)
+            {
+                _velocity = new(_velocity.X * 0.999f, _velocity.Y - 9.81f * deltaTime * 0.01f, _velocity.Z);
+                _position = new(_position.X + _velocity.X * deltaTime, _position.Y + _velocity.Y * deltaTime, _position.Z + _velocity.Z * deltaTime);
+            }
+
+            if (s_transforms.Contains(_entity))
+            {
+                s_transforms[_entity].Position = _position;
+            }
+        }
+
+        public Vector3 GetPosition() => _position;
+    }
+}
@@ -1,6 +1,7 @@
 ﻿using GameProject;
 using System;
 using Example.Managed.Interop;
+using MochiSharp.Managed.Core;
 
 namespace Example.Managed.Scripts
 {
@@ -22,7 +23,14 @@ namespace Example.Managed.Scripts
 
         public override void OnUpdate(float deltaTime)
         {
-            Console.WriteLine($"C# Player On Update dt: {deltaTime}");
+            // Formatted only if Script/Info passes the host's log filters.
+            Logger.Write(LogLevel.Info, LogCategory.Script, $"Player On Update dt: {deltaTime}");
+
+            // Engine callbacks through the generated facade: plain function pointer calls.
+            if (Engine.IsAvailable && Engine.IsKeyDown(' ') && Engine.Raycast(_transform.Position, new Vector3(0, -1, 0), 100.0f, out Vector3 ground))
+            {
+                Logger.Write(LogLevel.Info, LogCategory.Script, $"Player jumps off ({ground.X}, {ground.Y}, {ground.Z}) at {Engine.GetTime():F2} s, frame {Engine.GetFrameIndex()}");
+            }
         }
 
         public int AddInt(int a, int b) => a + b;
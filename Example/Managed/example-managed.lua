@@ -3,6 +3,7 @@ project "Example.Managed"
     kind "SharedLib"
     language "C#"
     dotnetframework "net9.0"
+    clr "Unsafe"
 
     targetdir (OUTPUT_DIR)
     objdir (INTOUTPUT_DIR)
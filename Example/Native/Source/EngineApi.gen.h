@@ -0,0 +1,32 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+// Generated by Tools/engine-api.lua from Example/example-engine-api.lua; do not edit.
+
+#ifndef ENGINE_API_GEN_H
+#define ENGINE_API_GEN_H
+
+#include "Host.h"
+#include "InteropTypes.h"
+
+#include <cstdint>
+
+namespace ExampleInterop
+{
+    // Fill in the callbacks and pass &Header to DotNetHost::SetEngineApi before Init. bool is int32_t.
+    struct EngineApi
+    {
+        static constexpr uint32_t CurrentVersion = 1;
+
+        MochiSharp::EngineApiHeader Header = { CurrentVersion, static_cast<uint32_t>(sizeof(EngineApi)) };
+        // Seconds since the engine started.
+        double (*GetTime)() = nullptr;
+        // Frames completed so far.
+        uint64_t (*GetFrameIndex)() = nullptr;
+        // True while the key is held.
+        int32_t (*IsKeyDown)(int32_t key) = nullptr;
+        // Casts a ray against the scene; hit receives the nearest hit point.
+        int32_t (*Raycast)(ExampleInterop::Vector3 origin, ExampleInterop::Vector3 direction, float maxDistance, ExampleInterop::Vector3 *hit) = nullptr;
+    };
+}
+
+#endif // !ENGINE_API_GEN_H
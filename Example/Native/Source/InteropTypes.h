@@ -0,0 +1,24 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef INTEROP_TYPES_H
+#define INTEROP_TYPES_H
+
+// Layouts match Example.Managed.Interop (InteropTypes.cs).
+namespace ExampleInterop
+{
+    struct Vector3
+    {
+        float X;
+        float Y;
+        float Z;
+    };
+
+    struct Transform
+    {
+        Vector3 Position;
+        Vector3 Rotation;
+        Vector3 Scale;
+    };
+}
+
+#endif // !INTEROP_TYPES_H
@@ -1,27 +1,65 @@
 // Copyright (c) 2025 Evangelion Manuhutu
 
 #include "Host.h"
+#include "ScriptScheduler.h"
+#include "InteropTypes.h"
+#include "EngineApi.gen.h"
 
 #include <thread>
 #include <chrono>
 #include <print>
 #include <string>
+#include <vector>
 
-namespace ExampleInterop
+// Engine callbacks scripts reach through Example.Managed.Interop.Engine.
+namespace ExampleEngine
 {
-    struct Vector3
+    static const auto StartTime = std::chrono::steady_clock::now();
+    static uint64_t FrameIndex = 0;
+    static bool Keys[256] = {};
+
+    static double GetTime()
     {
-        float X;
-        float Y;
-        float Z;
-    };
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    }
 
-    struct Transform
+    static uint64_t GetFrameIndex()
     {
-        Vector3 Position;
-        Vector3 Rotation;
-        Vector3 Scale;
-    };
+        return FrameIndex;
+    }
+
+    static int32_t IsKeyDown(int32_t key)
+    {
+        return key >= 0 && key < static_cast<int32_t>(std::size(Keys)) && Keys[key];
+    }
+
+    // The example scene is a ground plane at y = 0.
+    static int32_t Raycast(ExampleInterop::Vector3 origin, ExampleInterop::Vector3 direction, float maxDistance, ExampleInterop::Vector3 *hit)
+    {
+        if (direction.Y >= 0.0f || origin.Y < 0.0f)
+        {
+            return 0;
+        }
+
+        float distance = -origin.Y / direction.Y;
+        if (distance > maxDistance)
+        {
+            return 0;
+        }
+
+        *hit = { origin.X + direction.X * distance, 0.0f, origin.Z + direction.Z * distance };
+        return 1;
+    }
+
+    static ExampleInterop::EngineApi CreateApi()
+    {
+        ExampleInterop::EngineApi api;
+        api.GetTime = &GetTime;
+        api.GetFrameIndex = &GetFrameIndex;
+        api.IsKeyDown = &IsKeyDown;
+        api.Raycast = &Raycast;
+        return api;
+    }
 }
 
 enum ScriptMethodSignature : int
@@ -37,52 +75,335 @@ enum ScriptMethodSignature : int
     Transform = 13,
 };
 
+MOCHI_MANAGED_TYPE(ExampleInterop::Vector3, "Example.Managed.Interop.Vector3, Example.Managed");
+MOCHI_MANAGED_TYPE(ExampleInterop::Transform, "Example.Managed.Interop.Transform, Example.Managed");
+
 struct ScriptInstance
 {
     MochiSharp::DotNetHost* Host;
-    std::string Guid;
-    int OnAwake = 0;
-    int OnStart = 0;
-    int OnUpdate = 0;
-    int SetTransform = 0;
-    int GetTransform = 0;
+    MochiSharp::ScriptGuid Guid;
+    MochiSharp::BoundMethod<void()> OnAwake;
+    MochiSharp::BoundMethod<void()> OnStart;
+    MochiSharp::BoundMethod<void(float)> OnUpdate;
+    MochiSharp::BoundMethod<void(ExampleInterop::Transform)> SetTransform;
+    MochiSharp::BoundMethod<ExampleInterop::Transform()> GetTransform;
 
-    void Init(MochiSharp::DotNetHost* host, const char* guid, const char* typeName)
+    void Init(MochiSharp::DotNetHost* host, const char* guid, const char* typeName, MochiSharp::ContextHandle context = {})
     {
         Host = host;
-        Guid = guid;
-        if (Host->CreateInstanceGuid(typeName, Guid.c_str()))
+        if (!MochiSharp::ScriptGuid::Parse(guid, Guid))
+        {
+            std::println("[C++] Invalid instance GUID {}", guid);
+            return;
+        }
+
+        if (Host->CreateInstanceGuid(context, typeName, Guid))
         {
-            std::println("[C++] Created instance {} of type {}", Guid, typeName);
-            OnAwake = Host->BindInstanceMethodGuid(Guid.c_str(), "OnAwake", ScriptMethodSignature::Void);
-            OnStart = Host->BindInstanceMethodGuid(Guid.c_str(), "OnStart", ScriptMethodSignature::Void);
-            OnUpdate = Host->BindInstanceMethodGuid(Guid.c_str(), "OnUpdate", ScriptMethodSignature::Void_Float);
-            SetTransform = Host->BindInstanceMethodGuid(Guid.c_str(), "SetTransform", ScriptMethodSignature::Void_Transform);
-            GetTransform = Host->BindInstanceMethodGuid(Guid.c_str(), "GetTransform", ScriptMethodSignature::Transform);
+            std::println("[C++] Created instance {} of type {}", Guid.ToString(), typeName);
+            OnAwake = Host->Bind<void()>(Guid, "OnAwake");
+            OnStart = Host->Bind<void()>(Guid, "OnStart");
+            OnUpdate = Host->Bind<void(float)>(Guid, "OnUpdate");
+            SetTransform = Host->Bind<void(ExampleInterop::Transform)>(Guid, "SetTransform");
+            GetTransform = Host->Bind<ExampleInterop::Transform()>(Guid, "GetTransform");
         }
         else
         {
-            std::println("[C++] Failed to create instance {}", Guid);
+            std::println("[C++] Failed to create instance {}", Guid.ToString());
         }
     }
 
-    void Awake() { if (OnAwake) Host->Invoke(OnAwake, nullptr, 0, nullptr); }
-    void Start() { if (OnStart) Host->Invoke(OnStart, nullptr, 0, nullptr); }
-    void Update(float dt) { if (OnUpdate) { void* args[] = { &dt }; Host->Invoke(OnUpdate, args, 1, nullptr); } }
-    
-    void SetTx(const ExampleInterop::Transform& t) { 
-        if (SetTransform) { 
-            void* args[] = { const_cast<ExampleInterop::Transform*>(&t) }; 
-            Host->Invoke(SetTransform, args, 1, nullptr); 
-        } 
+    void Awake() { if (OnAwake) OnAwake(); }
+    void Start() { if (OnStart) OnStart(); }
+    void Update(float dt) { if (OnUpdate) OnUpdate(dt); }
+    void SetTx(const ExampleInterop::Transform& t) { if (SetTransform) SetTransform(t); }
+    ExampleInterop::Transform GetTx() { return GetTransform ? GetTransform() : ExampleInterop::Transform{}; }
+};
+
+// Average ns per call of invoke, after a warmup.
+template<typename Fn>
+static double MeasureInvoke(Fn &&invoke)
+{
+    constexpr int WarmupCalls = 1000;
+    constexpr int MeasuredCalls = 100000;
+
+    for (int i = 0; i < WarmupCalls; i++)
+    {
+        invoke();
     }
-    
-    ExampleInterop::Transform GetTx() {
-        ExampleInterop::Transform t{};
-        if (GetTransform) Host->Invoke(GetTransform, nullptr, 0, &t);
-        return t;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < MeasuredCalls; i++)
+    {
+        invoke();
     }
-};
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+    return elapsed / MeasuredCalls;
+}
+
+template<typename Binding, typename Fn>
+static void BenchmarkInvoke(const char *name, const Binding &binding, Fn &&invoke)
+{
+    if (!binding)
+    {
+        std::println("[C++] {:<24} not bound", name);
+        return;
+    }
+
+    std::println("[C++] {:<24} {:8.1f} ns/call", name, MeasureInvoke(invoke));
+}
+
+// DotNetHost::Invoke of the same method bound in InvokeMode::Reflection and InvokeMode::Compiled.
+static void CompareInvoke(MochiSharp::DotNetHost &host, const char *name, MochiSharp::MethodHandle reflection,
+    MochiSharp::MethodHandle compiled, const void *argsPtr, int argCount, void *returnPtr)
+{
+    if (!reflection || !compiled)
+    {
+        std::println("[C++] {:<24} not bound", name);
+        return;
+    }
+
+    double before = MeasureInvoke([&] { host.Invoke(reflection, argsPtr, argCount, returnPtr); });
+    double after = MeasureInvoke([&] { host.Invoke(compiled, argsPtr, argCount, returnPtr); });
+    std::println("[C++] {:<24} {:8.1f} -> {:8.1f} ns/call ({:.1f}x)", name, before, after, before / after);
+}
+
+// Measures the per-call cost of DotNetHost::Invoke, through MethodInfo.Invoke and through the
+// compiled thunks, and of direct NativeMethod calls for every ScriptMethodSignature.
+static void RunInvokeBenchmark(MochiSharp::DotNetHost &host)
+{
+    MochiSharp::InstanceHandle instance = host.CreateInstance("Example.Managed.Scripts.InvokeBenchmark");
+    if (!instance)
+    {
+        std::println("[C++] Failed to create benchmark instance");
+        return;
+    }
+
+    MochiSharp::MethodHandle nop = host.BindInstanceMethod(instance, "Nop", ScriptMethodSignature::Void);
+    MochiSharp::MethodHandle takeFloat = host.BindInstanceMethod(instance, "TakeFloat", ScriptMethodSignature::Void_Float);
+    MochiSharp::MethodHandle takeInt = host.BindInstanceMethod(instance, "TakeInt", ScriptMethodSignature::Void_Int);
+    MochiSharp::MethodHandle takeBool = host.BindInstanceMethod(instance, "TakeBool", ScriptMethodSignature::Void_Bool);
+    MochiSharp::MethodHandle addInt = host.BindInstanceMethod(instance, "AddInt", ScriptMethodSignature::Int_IntInt);
+    MochiSharp::MethodHandle addVector = host.BindInstanceMethod(instance, "AddVector", ScriptMethodSignature::Vector3_Vector3Vector3);
+    MochiSharp::MethodHandle setTransform = host.BindInstanceMethod(instance, "SetTransform", ScriptMethodSignature::Void_Transform);
+    MochiSharp::MethodHandle getTransform = host.BindInstanceMethod(instance, "GetTransform", ScriptMethodSignature::Transform);
+
+    // The same methods again, called the way Invoke worked before compiled thunks.
+    host.SetInvokeMode(MochiSharp::InvokeMode::Reflection);
+    MochiSharp::MethodHandle nopReflection = host.BindInstanceMethod(instance, "Nop", ScriptMethodSignature::Void);
+    MochiSharp::MethodHandle takeFloatReflection = host.BindInstanceMethod(instance, "TakeFloat", ScriptMethodSignature::Void_Float);
+    MochiSharp::MethodHandle takeIntReflection = host.BindInstanceMethod(instance, "TakeInt", ScriptMethodSignature::Void_Int);
+    MochiSharp::MethodHandle takeBoolReflection = host.BindInstanceMethod(instance, "TakeBool", ScriptMethodSignature::Void_Bool);
+    MochiSharp::MethodHandle addIntReflection = host.BindInstanceMethod(instance, "AddInt", ScriptMethodSignature::Int_IntInt);
+    MochiSharp::MethodHandle addVectorReflection = host.BindInstanceMethod(instance, "AddVector", ScriptMethodSignature::Vector3_Vector3Vector3);
+    MochiSharp::MethodHandle setTransformReflection = host.BindInstanceMethod(instance, "SetTransform", ScriptMethodSignature::Void_Transform);
+    MochiSharp::MethodHandle getTransformReflection = host.BindInstanceMethod(instance, "GetTransform", ScriptMethodSignature::Transform);
+    host.SetInvokeMode(MochiSharp::InvokeMode::Compiled);
+
+    float f = 0.016f;
+    int i = 1;
+    int b = 1;
+    int a0 = 2, a1 = 3, intResult = 0;
+    ExampleInterop::Vector3 v0 = { 1, 2, 3 }, v1 = { 4, 5, 6 }, vectorResult{};
+    ExampleInterop::Transform transform = { {1,1,1}, {0,0,0}, {1,1,1} }, transformResult{};
+
+    void *floatArgs[] = { &f };
+    void *intArgs[] = { &i };
+    void *boolArgs[] = { &b };
+    void *intIntArgs[] = { &a0, &a1 };
+    void *vectorArgs[] = { &v0, &v1 };
+    void *transformArgs[] = { &transform };
+
+    std::println("[C++] Invoke benchmark (MethodInfo.Invoke -> compiled thunk):");
+    CompareInvoke(host, "Void", nopReflection, nop, nullptr, 0, nullptr);
+    CompareInvoke(host, "Void_Float", takeFloatReflection, takeFloat, floatArgs, 1, nullptr);
+    CompareInvoke(host, "Void_Int", takeIntReflection, takeInt, intArgs, 1, nullptr);
+    CompareInvoke(host, "Void_Bool", takeBoolReflection, takeBool, boolArgs, 1, nullptr);
+    CompareInvoke(host, "Int_IntInt", addIntReflection, addInt, intIntArgs, 2, &intResult);
+    CompareInvoke(host, "Vector3_Vector3Vector3", addVectorReflection, addVector, vectorArgs, 2, &vectorResult);
+    CompareInvoke(host, "Void_Transform", setTransformReflection, setTransform, transformArgs, 1, nullptr);
+    CompareInvoke(host, "Transform", getTransformReflection, getTransform, nullptr, 0, &transformResult);
+
+    // One batch per frame: every entity gets the same dt through a single transition.
+    constexpr int BatchSize = 1000;
+    std::vector<MochiSharp::MethodHandle> batchIds(BatchSize, takeFloat);
+    std::vector<int> batchStatuses(BatchSize);
+    const void *sharedArgs[] = { floatArgs };
+    if (takeFloat)
+    {
+        constexpr int Batches = 100;
+        int succeeded = 0;
+        host.InvokeBatch(batchIds.data(), sharedArgs, BatchSize, nullptr, nullptr, MochiSharp::InvokeBatchMode::SharedArgs);
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int n = 0; n < Batches; n++)
+        {
+            succeeded = host.InvokeBatch(batchIds.data(), sharedArgs, BatchSize, nullptr, batchStatuses.data(), MochiSharp::InvokeBatchMode::SharedArgs);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+        std::println("[C++] {:<24} {:8.1f} ns/call ({} of {} succeeded)", "InvokeBatch Void_Float", elapsed / (Batches * BatchSize), succeeded, BatchSize);
+    }
+
+    auto nopPtr = host.BindInstanceMethodPtr(instance, "Nop", ScriptMethodSignature::Void);
+    auto takeFloatPtr = host.BindInstanceMethodPtr(instance, "TakeFloat", ScriptMethodSignature::Void_Float);
+    auto takeIntPtr = host.BindInstanceMethodPtr(instance, "TakeInt", ScriptMethodSignature::Void_Int);
+    auto takeBoolPtr = host.BindInstanceMethodPtr(instance, "TakeBool", ScriptMethodSignature::Void_Bool);
+    auto addIntPtr = host.BindInstanceMethodPtr(instance, "AddInt", ScriptMethodSignature::Int_IntInt);
+    auto addVectorPtr = host.BindInstanceMethodPtr(instance, "AddVector", ScriptMethodSignature::Vector3_Vector3Vector3);
+    auto setTransformPtr = host.BindInstanceMethodPtr(instance, "SetTransform", ScriptMethodSignature::Void_Transform);
+    auto getTransformPtr = host.BindInstanceMethodPtr(instance, "GetTransform", ScriptMethodSignature::Transform);
+
+    std::println("[C++] Direct call benchmark:");
+    BenchmarkInvoke("Void", nopPtr, [&] { nopPtr.Call<void>(); });
+    BenchmarkInvoke("Void_Float", takeFloatPtr, [&] { takeFloatPtr.Call<void>(f); });
+    BenchmarkInvoke("Void_Int", takeIntPtr, [&] { takeIntPtr.Call<void>(i); });
+    BenchmarkInvoke("Void_Bool", takeBoolPtr, [&] { takeBoolPtr.Call<void>(b); });
+    BenchmarkInvoke("Int_IntInt", addIntPtr, [&] { intResult = addIntPtr.Call<int>(a0, a1); });
+    BenchmarkInvoke("Vector3_Vector3Vector3", addVectorPtr, [&] { vectorResult = addVectorPtr.Call<ExampleInterop::Vector3>(v0, v1); });
+    BenchmarkInvoke("Void_Transform", setTransformPtr, [&] { setTransformPtr.Call<void>(transform); });
+    BenchmarkInvoke("Transform", getTransformPtr, [&] { transformResult = getTransformPtr.Call<ExampleInterop::Transform>(); });
+
+    host.DestroyInstance(instance);
+
+    // Handles of the destroyed instance are stale now, even once their slots are reused.
+    MochiSharp::InstanceHandle reused = host.CreateInstance("Example.Managed.Scripts.InvokeBenchmark");
+    std::println("[C++] Stale handle check: slot {} reused (gen {} -> {}), stale invoke {}",
+        reused.Index(), instance.Generation(), reused.Generation(), host.Invoke(nop, nullptr, 0, nullptr) ? "succeeded" : "rejected");
+    host.DestroyInstance(reused);
+}
+
+// Spawns entities with per-instance bindings and with one type-level binding, then updates them
+// through InvokeOn. Type-level spawning does no reflection and adds no method handles.
+static void RunSpawnBenchmark(MochiSharp::DotNetHost &host)
+{
+    constexpr int EntityCount = 1000;
+    const char *typeName = "Example.Managed.Scripts.InvokeBenchmark";
+    std::vector<MochiSharp::InstanceHandle> entities(EntityCount);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (auto &entity : entities)
+    {
+        entity = host.CreateInstance(typeName);
+        host.BindInstanceMethod(entity, "TakeFloat", ScriptMethodSignature::Void_Float);
+    }
+    auto perInstance = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    for (auto entity : entities)
+    {
+        host.DestroyInstance(entity);
+    }
+
+    MochiSharp::MethodHandle takeFloat = host.BindTypeMethod(typeName, "TakeFloat", ScriptMethodSignature::Void_Float);
+    begin = std::chrono::steady_clock::now();
+    for (auto &entity : entities)
+    {
+        entity = host.CreateInstance(typeName);
+    }
+    auto perType = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+    std::println("[C++] Spawn {} entities: {:.0f} us with per-instance binds, {:.0f} us with a type bind", EntityCount, perInstance, perType);
+
+    float dt = 0.016f;
+    void *args[] = { &dt };
+    int updated = 0;
+    begin = std::chrono::steady_clock::now();
+    for (auto entity : entities)
+    {
+        updated += host.InvokeOn(takeFloat, entity, args, 1, nullptr) ? 1 : 0;
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    std::println("[C++] {:<24} {:8.1f} ns/call ({} of {} updated)", "InvokeOn Void_Float", elapsed / EntityCount, updated, EntityCount);
+
+    for (auto entity : entities)
+    {
+        host.DestroyInstance(entity);
+    }
+    host.UnbindMethod(takeFloat);
+
+    MochiSharp::MetadataCacheStats stats;
+    if (host.GetMetadataCacheStats(stats))
+    {
+        std::println("[C++] Metadata cache: types {} hits / {} misses, methods {} hits / {} misses",
+            stats.TypeHits, stats.TypeMisses, stats.MethodHits, stats.MethodMisses);
+    }
+}
+
+// Updates a crowd of [ParallelSafe] movers through ScriptScheduler, with a few serial scripts mixed in.
+static void RunSchedulerBenchmark(MochiSharp::DotNetHost &host)
+{
+    constexpr int MoverCount = 10000;
+    constexpr int SerialCount = 100;
+    constexpr int FrameCount = 60;
+
+    MochiSharp::ScriptScheduler scheduler(host);
+    MochiSharp::ScriptGroupId update = scheduler.CreateGroup("Update");
+
+    const char *moverType = "Example.Managed.Scripts.Mover";
+    const char *serialType = "Example.Managed.Scripts.InvokeBenchmark";
+    MochiSharp::MethodHandle moverUpdate = host.BindTypeMethod(moverType, "OnUpdate", ScriptMethodSignature::Void_Float);
+    MochiSharp::MethodHandle serialUpdate = host.BindTypeMethod(serialType, "TakeFloat", ScriptMethodSignature::Void_Float);
+    MochiSharp::MethodHandle moverSetEntity = host.BindTypeMethod(moverType, "SetEntity", ScriptMethodSignature::Void_Int);
+
+    // Movers write their position straight into this array (SharedBuffer<Transform> on the managed side).
+    std::vector<ExampleInterop::Transform> transforms(MoverCount + SerialCount);
+    host.RegisterBuffer("Transforms", transforms.data(), static_cast<uint32_t>(transforms.size()));
+
+    std::vector<MochiSharp::InstanceHandle> entities;
+    entities.reserve(MoverCount + SerialCount);
+    for (int i = 0; i < MoverCount + SerialCount; i++)
+    {
+        bool serial = i < SerialCount;
+        MochiSharp::InstanceHandle entity = host.CreateInstance(serial ? serialType : moverType);
+        entities.push_back(entity);
+        scheduler.Add(update, { serial ? serialUpdate : moverUpdate, entity });
+        if (!serial)
+        {
+            void *entityArgs[] = { &i };
+            host.InvokeOn(moverSetEntity, entity, entityArgs, 1, nullptr);
+        }
+    }
+
+    float dt = 0.016f;
+    void *args[] = { &dt };
+    double totalMs = 0.0;
+    for (int frame = 0; frame < FrameCount; frame++)
+    {
+        totalMs += scheduler.Run(update, args).TotalMs;
+    }
+
+    const MochiSharp::ScriptPhaseStats &stats = scheduler.Stats(update);
+    std::println("[C++] Scheduler '{}' with {} workers: {} parallel + {} serial calls, {:.3f} ms/frame avg",
+        scheduler.GroupName(update), scheduler.WorkerCount(), stats.ParallelCalls, stats.SerialCalls, totalMs / FrameCount);
+    std::println("[C++]   last frame: parallel {:.3f} ms, serial {:.3f} ms, {} steals, {} failed",
+        stats.ParallelMs, stats.SerialMs, stats.Steals, stats.FailedCalls);
+
+    const ExampleInterop::Vector3 &last = transforms.back().Position;
+    std::println("[C++]   last mover position (shared buffer): {:.3f},{:.3f},{:.3f}", last.X, last.Y, last.Z);
+
+    host.UnregisterBuffer("Transforms");
+    for (auto entity : entities)
+    {
+        host.DestroyInstance(entity);
+    }
+    host.UnbindMethod(moverUpdate);
+    host.UnbindMethod(serialUpdate);
+    host.UnbindMethod(moverSetEntity);
+}
+
+static void PrintProfile(MochiSharp::DotNetHost &host)
+{
+    std::vector<MochiSharp::MethodProfile> profile;
+    if (!host.GetProfile(profile))
+    {
+        return;
+    }
+
+    for (const MochiSharp::MethodProfile &method : profile)
+    {
+        std::println("[C++] Profile {}: {} calls, mean {:.0f} ns, p99 < {} ns, max {} ns, {:.0f} bytes/call",
+            method.Name, method.Calls, method.MeanNs(), method.PercentileNs(0.99), method.MaxNs, method.AllocatedPerCall());
+    }
+}
 
 #ifdef _WIN32
 int __cdecl wmain(int argc, wchar_t *argv[])
@@ -90,19 +411,50 @@ int __cdecl wmain(int argc, wchar_t *argv[])
 int main(int argc, char *argv[])
 #endif
 {
-    // MochiSharp::HostSettings settings;
+    // A game loop wants short pauses over throughput: workstation GC with background collections.
+    MochiSharp::HostSettings settings;
+    settings.ServerGC = false;
+    settings.ConcurrentGC = true;
+    settings.TieredPGO = true;
 
     MochiSharp::DotNetHost host;
-    if (!host.Init(L"MochiSharp.Managed.runtimeconfig.json"))
+    static const ExampleInterop::EngineApi engineApi = ExampleEngine::CreateApi();
+    host.SetEngineApi(&engineApi.Header);
+
+    // Later runs load hostfxr from the cached path instead of probing for it.
+    host.SetHostFxrCache("MochiSharp.hostfxr.cache");
+    if (!host.Init("MochiSharp.Managed.runtimeconfig.json", settings))
     {
         return 1;
     }
+    const MochiSharp::StartupTimings &startup = host.GetStartupTimings();
+    std::println("[C++] Host init took {:.2f} ms: resolve hostfxr {:.2f}{}, load hostfxr {:.2f}, runtime config {:.2f}, "
+        "runtime start {:.2f}, core load {:.2f}, managed init {:.2f}",
+        startup.TotalMs, startup.ResolveHostFxrMs, startup.HostFxrCacheHit ? " (cached)" : "", startup.LoadHostFxrMs,
+        startup.InitRuntimeMs, startup.GetDelegateMs, startup.LoadCoreMs, startup.ManagedInitMs);
+
+    MochiSharp::RuntimeInfo runtime;
+    if (host.GetRuntimeInfo(runtime))
+    {
+        std::println("[C++] Runtime: {} GC{}, latency mode {}, tiered {}, PGO {}, ReadyToRun {}, {} MB available",
+            runtime.ServerGC ? "server" : "workstation", runtime.ConcurrentGC ? " (concurrent)" : "", runtime.GCLatencyMode,
+            runtime.TieredCompilation != 0, runtime.TieredPGO != 0, runtime.ReadyToRun != 0, runtime.TotalAvailableMemory / (1024 * 1024));
+    }
 
-    // Load the script assembly
-    if (!host.LoadAssembly("Example.Managed.dll"))
+    // Load the script assembly in the background, resolving and compiling the scripts used below.
+    const char *preloadTypes[] = {
+        "Example.Managed.Scripts.Player",
+        "Example.Managed.Scripts.InvokeBenchmark",
+        "Example.Managed.Scripts.Mover",
+    };
+    auto loadBegin = std::chrono::steady_clock::now();
+    MochiSharp::LoadTicket load = host.LoadAssemblyAsync("Example.Managed.dll", preloadTypes, static_cast<int>(std::size(preloadTypes)));
+    if (!load || host.WaitLoad(load) != MochiSharp::LoadStatus::Published)
     {
         return 1;
     }
+    auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadBegin).count();
+    std::println("[C++] Script assembly load took {:.2f} ms", loadTime);
 
     // Register signatures (the core stays generic; the app defines what these IDs mean).
     // Note: use assembly-qualified names for app-defined structs.
@@ -118,6 +470,16 @@ int main(int argc, char *argv[])
         host.RegisterSignature(ScriptMethodSignature::Void_Float, "System.Void", p1, 1);
     }
 
+    {
+        const char *p1[] = { "System.Int32" };
+        host.RegisterSignature(ScriptMethodSignature::Void_Int, "System.Void", p1, 1);
+    }
+
+    {
+        const char *p1[] = { "System.Boolean" };
+        host.RegisterSignature(ScriptMethodSignature::Void_Bool, "System.Void", p1, 1);
+    }
+
     {
         const char *p2[] = { "System.Int32", "System.Int32" };
         host.RegisterSignature(ScriptMethodSignature::Int_IntInt, "System.Int32", p2, 2);
@@ -137,6 +499,14 @@ int main(int argc, char *argv[])
         host.RegisterSignature(ScriptMethodSignature::Transform, transformType, nullptr, 0);
     }
 
+    RunInvokeBenchmark(host);
+    RunSpawnBenchmark(host);
+    // Which scripts the scheduled updates spend their time and allocations in.
+    host.StartProfiler();
+    RunSchedulerBenchmark(host);
+    host.StopProfiler();
+    PrintProfile(host);
+
     // Create multiple script instances
     ScriptInstance player1;
     player1.Init(&host, "c3f5a1b7-1c21-4f5f-9e3a-7a9a2bf6b7d1", "Example.Managed.Scripts.Player");
@@ -144,11 +514,22 @@ int main(int argc, char *argv[])
     ScriptInstance player2;
     player2.Init(&host, "d4f6b2c8-2d32-5e6f-af4b-8b0b3cf7c8e2", "Example.Managed.Scripts.Player");
 
+    // A second copy of the scripts in a context of its own, as a mod would be: it keeps running, and
+    // keeps its state, while the default context reloads below.
+    MochiSharp::ContextHandle mod = host.CreateContext("Example.Managed.dll");
+    ScriptInstance modPlayer;
+    if (mod)
+    {
+        modPlayer.Init(&host, "e5a7c3d9-3e43-4f70-b05c-9c1c4d08d9f3", "Example.Managed.Scripts.Player", mod);
+    }
+
     player1.Awake();
     player2.Awake();
+    modPlayer.Awake();
 
     player1.Start();
     player2.Start();
+    modPlayer.Start();
 
     // Set different transforms to prove independence
     ExampleInterop::Transform t1 = { {1,1,1}, {0,0,0}, {1,1,1} };
@@ -157,6 +538,9 @@ int main(int argc, char *argv[])
     ExampleInterop::Transform t2 = { {2,2,2}, {0,45,0}, {2,2,2} };
     player2.SetTx(t2);
 
+    ExampleInterop::Transform t3 = { {3,3,3}, {0,90,0}, {1,1,1} };
+    modPlayer.SetTx(t3);
+
     // Verify state
     auto t1_out = player1.GetTx();
     auto t2_out = player2.GetTx();
@@ -167,19 +551,108 @@ int main(int argc, char *argv[])
     bool running = true;
     auto start = std::chrono::steady_clock::now();
 
+    // Record the frame loop, reload and unload as a timeline; open the file in ui.perfetto.dev.
+    MochiSharp::Trace::SetThreadName("Main");
+    host.StartTrace();
+
+    // The frame loop gets a 16 MB allocation budget with no collections. Entering the region runs one
+    // full blocking collection, so it is entered once here, where a level load would be, not per frame.
+    bool noGC = host.BeginNoGCRegion(16 * 1024 * 1024);
+
+    // Reset the allocation baseline so frame 0 reports only its own allocations.
+    MochiSharp::ManagedMemoryStats memory;
+    host.GetManagedMemoryStats(memory);
+
     int runningCount = 0;
     while (running && runningCount <= 10)
     {
+        MochiSharp::Trace::Scope frameScope("Frame");
         auto end = std::chrono::steady_clock::now();
         float deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0f;
         start = end;
 
-        player1.Update(deltaTime);
-        player2.Update(deltaTime);
-        
+        // Space is held for the second half of the run.
+        ExampleEngine::Keys[' '] = runningCount > 5;
+
+        {
+            MochiSharp::Trace::Scope scriptsScope("Scripts");
+            player1.Update(deltaTime);
+            player2.Update(deltaTime);
+            modPlayer.Update(deltaTime);
+        }
+
+        if (host.GetManagedMemoryStats(memory) && memory.AllocatedBytes > 0)
+        {
+            std::println("[C++] Frame {}: scripts allocated {} bytes, gen0/1/2 {}/{}/{}, heap {} KB, GC pauses {:.2f} ms total",
+                ExampleEngine::FrameIndex, memory.AllocatedBytes, memory.Gen0Collections, memory.Gen1Collections,
+                memory.Gen2Collections, memory.HeapSizeBytes / 1024, memory.TotalPauseMs);
+        }
+
         std::this_thread::sleep_for(std::chrono::milliseconds(16));
         runningCount++;
+        ExampleEngine::FrameIndex++;
+    }
+
+    if (noGC)
+    {
+        std::println("[C++] No-GC region {} for {} frames", host.EndNoGCRegion() ? "held" : "was ended early by a collection", runningCount);
     }
 
+    // Hot reload: keep updating while the new build loads in the background, swap it in between frames.
+    if (host.BeginReload("Example.Managed.dll"))
+    {
+        int loadingFrames = 0;
+        while (host.PollReload() == MochiSharp::ReloadStatus::Loading)
+        {
+            player1.Update(0.016f);
+            player2.Update(0.016f);
+            modPlayer.Update(0.016f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            loadingFrames++;
+        }
+
+        MochiSharp::ReloadStats reload;
+        if (host.CommitReload(&reload))
+        {
+            std::println("[C++] Reloaded after {} frames: commit {:.3f} ms, {} instances, {} methods, {} pointers",
+                loadingFrames, reload.CommitMs, reload.InstancesMigrated, reload.BindingsRebound, reload.PointersRebound);
+
+            // Same bindings, new code, old state.
+            auto reloaded = player1.GetTx();
+            std::println("[C++] Player 1 Pos after reload: {},{},{}", reloaded.Position.X, reloaded.Position.Y, reloaded.Position.Z);
+
+            // Untouched by the reload: its context was not part of it.
+            auto modTx = modPlayer.GetTx();
+            std::println("[C++] Mod player Pos after reload: {},{},{}", modTx.Position.X, modTx.Position.Y, modTx.Position.Z);
+        }
+    }
+
+    // The mod's bound pointers die with its context.
+    if (mod && host.DestroyContext(mod))
+    {
+        modPlayer = {};
+    }
+
+    // The old build is reclaimed over the next frames instead of in one blocking collection.
+    MochiSharp::UnloadStatus unload = host.PollUnload();
+    for (int frame = 0; unload.Pending > 0 && frame < 60; frame++)
+    {
+        player1.Update(0.016f);
+        player2.Update(0.016f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        unload = host.PollUnload(1.0);
+    }
+    std::println("[C++] Unload: {} reclaimed, {} pending, {} leaked, {} collections",
+        unload.Reclaimed, unload.Pending, unload.Leaked, unload.Retries);
+
+    host.StopTrace();
+    if (host.WriteTrace("MochiSharp.trace.json"))
+    {
+        std::println("[C++] Trace written to MochiSharp.trace.json");
+    }
+
+    host.Log().Flush();
+    std::println("[C++] Log messages dropped: {}", host.Log().DroppedCount());
+
     return 0;
 }
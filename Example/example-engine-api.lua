@@ -0,0 +1,23 @@
+-- Engine callbacks the example exposes to scripts (generated by Tools/engine-api.lua into
+-- Native/Source/EngineApi.gen.h and Managed/EngineApi.gen.cs). Append new entries at the end.
+return {
+    Version = 1,
+
+    Native = { Namespace = "ExampleInterop", Struct = "EngineApi", Includes = { "InteropTypes.h" } },
+    Managed = { Namespace = "Example.Managed.Interop", Class = "Engine", Struct = "EngineApiTable" },
+
+    Types = {
+        Vector3 = { Native = "ExampleInterop::Vector3", Managed = "Vector3" },
+    },
+
+    Functions = {
+        { Name = "GetTime", Returns = "double", Doc = "Seconds since the engine started." },
+        { Name = "GetFrameIndex", Returns = "uint64", Doc = "Frames completed so far." },
+        { Name = "IsKeyDown", Returns = "bool", Params = { { "key", "int" } }, Doc = "True while the key is held." },
+        {
+            Name = "Raycast", Returns = "bool",
+            Params = { { "origin", "Vector3" }, { "direction", "Vector3" }, { "maxDistance", "float" }, { "hit", "Vector3", Out = true } },
+            Doc = "Casts a ray against the scene; hit receives the nearest hit point.",
+        },
+    },
+}
@@ -0,0 +1,140 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Managed.Core
+{
+	// Every Bootstrap export in one struct, filled by Bootstrap.GetApiTable so the host resolves a single
+	// entry point at startup (layout matches MochiSharp::ManagedApi).
+	// Entries are append-only. Version changes only when an existing entry changes meaning; Size tells
+	// each side how many entries the other knows about.
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct ApiTable
+	{
+		public const uint CurrentVersion = 1;
+
+		public uint Version;
+		public uint Size;
+		public IntPtr Initialize;
+		public IntPtr LoadAssembly;
+		public IntPtr RegisterSignature;
+		public IntPtr CreateInstance;
+		public IntPtr CreateInstanceGuid;
+		public IntPtr DestroyInstance;
+		public IntPtr DestroyInstanceGuid;
+		public IntPtr BindInstanceMethod;
+		public IntPtr BindInstanceMethodGuid;
+		public IntPtr BindStaticMethod;
+		public IntPtr BindTypeMethod;
+		public IntPtr UnbindMethod;
+		public IntPtr Invoke;
+		public IntPtr InvokeOn;
+		public IntPtr InvokeBatch;
+		public IntPtr BindInstanceMethodPtr;
+		public IntPtr BindInstanceMethodPtrGuid;
+		public IntPtr BindStaticMethodPtr;
+		public IntPtr CreateInstanceGuidBinary;
+		public IntPtr DestroyInstanceGuidBinary;
+		public IntPtr BindInstanceMethodGuidBinary;
+		public IntPtr BindInstanceMethodPtrGuidBinary;
+		public IntPtr GetMetadataCacheStats;
+		public IntPtr InvokeOnBatch;
+		public IntPtr IsParallelSafe;
+		public IntPtr BeginReload;
+		public IntPtr PollReload;
+		public IntPtr CommitReload;
+		public IntPtr PollUnload;
+		public IntPtr LoadAssemblyAsync;
+		public IntPtr PollLoad;
+		public IntPtr WaitLoad;
+		public IntPtr RegisterBuffer;
+		public IntPtr UnregisterBuffer;
+		public IntPtr GetRuntimeInfo;
+		public IntPtr GetManagedMemoryStats;
+		public IntPtr BeginNoGCRegion;
+		public IntPtr EndNoGCRegion;
+		public IntPtr StartProfiler;
+		public IntPtr StopProfiler;
+		public IntPtr GetProfile;
+		public IntPtr StartTrace;
+		public IntPtr StopTrace;
+		public IntPtr DrainTrace;
+		public IntPtr GetTraceName;
+		public IntPtr CreateContext;
+		public IntPtr DestroyContext;
+		public IntPtr CreateInstanceIn;
+		public IntPtr CreateInstanceGuidBinaryIn;
+		public IntPtr BindStaticMethodIn;
+		public IntPtr BindTypeMethodIn;
+		public IntPtr BindStaticMethodPtrIn;
+		public IntPtr BeginReloadIn;
+		public IntPtr PollReloadIn;
+		public IntPtr CommitReloadIn;
+		public IntPtr SetInvokeMode;
+
+		// The typed function pointers make the compiler check each export's signature.
+		public static unsafe ApiTable Create()
+		{
+			return new ApiTable
+			{
+				Version = CurrentVersion,
+				Size = (uint)sizeof(ApiTable),
+				Initialize = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.Initialize,
+				LoadAssembly = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.LoadAssembly,
+				RegisterSignature = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int, int>)&Bootstrap.RegisterSignature,
+				CreateInstance = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.CreateInstance,
+				CreateInstanceGuid = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int>)&Bootstrap.CreateInstanceGuid,
+				DestroyInstance = (IntPtr)(delegate* unmanaged<int, void>)&Bootstrap.DestroyInstance,
+				DestroyInstanceGuid = (IntPtr)(delegate* unmanaged<IntPtr, void>)&Bootstrap.DestroyInstanceGuid,
+				BindInstanceMethod = (IntPtr)(delegate* unmanaged<int, IntPtr, int, int>)&Bootstrap.BindInstanceMethod,
+				BindInstanceMethodGuid = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, int>)&Bootstrap.BindInstanceMethodGuid,
+				BindStaticMethod = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, int>)&Bootstrap.BindStaticMethod,
+				BindTypeMethod = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, int>)&Bootstrap.BindTypeMethod,
+				UnbindMethod = (IntPtr)(delegate* unmanaged<int, void>)&Bootstrap.UnbindMethod,
+				Invoke = (IntPtr)(delegate* unmanaged<int, IntPtr, int, IntPtr, int>)&Bootstrap.Invoke,
+				InvokeOn = (IntPtr)(delegate* unmanaged<int, int, IntPtr, int, IntPtr, int>)&Bootstrap.InvokeOn,
+				InvokeBatch = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, IntPtr, IntPtr, int, int>)&Bootstrap.InvokeBatch,
+				BindInstanceMethodPtr = (IntPtr)(delegate* unmanaged<int, IntPtr, int, IntPtr, int>)&Bootstrap.BindInstanceMethodPtr,
+				BindInstanceMethodPtrGuid = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, IntPtr, int>)&Bootstrap.BindInstanceMethodPtrGuid,
+				BindStaticMethodPtr = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, IntPtr, int>)&Bootstrap.BindStaticMethodPtr,
+				CreateInstanceGuidBinary = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int>)&Bootstrap.CreateInstanceGuidBinary,
+				DestroyInstanceGuidBinary = (IntPtr)(delegate* unmanaged<IntPtr, void>)&Bootstrap.DestroyInstanceGuidBinary,
+				BindInstanceMethodGuidBinary = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, int>)&Bootstrap.BindInstanceMethodGuidBinary,
+				BindInstanceMethodPtrGuidBinary = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, IntPtr, int>)&Bootstrap.BindInstanceMethodPtrGuidBinary,
+				GetMetadataCacheStats = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.GetMetadataCacheStats,
+				InvokeOnBatch = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, IntPtr, IntPtr, int>)&Bootstrap.InvokeOnBatch,
+				IsParallelSafe = (IntPtr)(delegate* unmanaged<int, int, int>)&Bootstrap.IsParallelSafe,
+				BeginReload = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.BeginReload,
+				PollReload = (IntPtr)(delegate* unmanaged<int>)&Bootstrap.PollReload,
+				CommitReload = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.CommitReload,
+				PollUnload = (IntPtr)(delegate* unmanaged<double, IntPtr, int>)&Bootstrap.PollUnload,
+				LoadAssemblyAsync = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, int, int>)&Bootstrap.LoadAssemblyAsync,
+				PollLoad = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.PollLoad,
+				WaitLoad = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.WaitLoad,
+				RegisterBuffer = (IntPtr)(delegate* unmanaged<IntPtr, IntPtr, IntPtr, int, int, uint>)&Bootstrap.RegisterBuffer,
+				UnregisterBuffer = (IntPtr)(delegate* unmanaged<IntPtr, uint>)&Bootstrap.UnregisterBuffer,
+				GetRuntimeInfo = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.GetRuntimeInfo,
+				GetManagedMemoryStats = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.GetManagedMemoryStats,
+				BeginNoGCRegion = (IntPtr)(delegate* unmanaged<long, int>)&Bootstrap.BeginNoGCRegion,
+				EndNoGCRegion = (IntPtr)(delegate* unmanaged<int>)&Bootstrap.EndNoGCRegion,
+				StartProfiler = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.StartProfiler,
+				StopProfiler = (IntPtr)(delegate* unmanaged<void>)&Bootstrap.StopProfiler,
+				GetProfile = (IntPtr)(delegate* unmanaged<IntPtr, int, int>)&Bootstrap.GetProfile,
+				StartTrace = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int>)&Bootstrap.StartTrace,
+				StopTrace = (IntPtr)(delegate* unmanaged<void>)&Bootstrap.StopTrace,
+				DrainTrace = (IntPtr)(delegate* unmanaged<IntPtr, int, int>)&Bootstrap.DrainTrace,
+				GetTraceName = (IntPtr)(delegate* unmanaged<int, IntPtr, int, int>)&Bootstrap.GetTraceName,
+				CreateContext = (IntPtr)(delegate* unmanaged<IntPtr, int>)&Bootstrap.CreateContext,
+				DestroyContext = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.DestroyContext,
+				CreateInstanceIn = (IntPtr)(delegate* unmanaged<int, IntPtr, int>)&Bootstrap.CreateInstanceIn,
+				CreateInstanceGuidBinaryIn = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int>)&Bootstrap.CreateInstanceGuidBinaryIn,
+				BindStaticMethodIn = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int, int>)&Bootstrap.BindStaticMethodIn,
+				BindTypeMethodIn = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int, int>)&Bootstrap.BindTypeMethodIn,
+				BindStaticMethodPtrIn = (IntPtr)(delegate* unmanaged<int, IntPtr, IntPtr, int, IntPtr, int>)&Bootstrap.BindStaticMethodPtrIn,
+				BeginReloadIn = (IntPtr)(delegate* unmanaged<int, IntPtr, int>)&Bootstrap.BeginReloadIn,
+				PollReloadIn = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.PollReloadIn,
+				CommitReloadIn = (IntPtr)(delegate* unmanaged<int, IntPtr, int>)&Bootstrap.CommitReloadIn,
+				SetInvokeMode = (IntPtr)(delegate* unmanaged<int, int>)&Bootstrap.SetInvokeMode,
+			};
+		}
+	}
+}
@@ -0,0 +1,338 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.ExceptionServices;
+using System.Runtime.InteropServices;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace MochiSharp.Managed.Core
+{
+    // Script contexts. Each has its own load context, instances, bindings and reload state, so contexts
+    // load, reload and unload independently and a reload only waits for calls into its own context.
+    // The default context is the one LoadAssembly, LoadAssemblyAsync and the exports without a context
+    // id work on; CreateContext adds more. Instance and method handles come from the process-wide
+    // HandleSpaces, so exports that take a handle find its context by the handle alone.
+    public static partial class Bootstrap
+    {
+        // One script context and its reload state.
+        private sealed class ContextSlot
+        {
+            public int Id;
+            // Reloads are serialized and wait for this context's calls in flight; see EnterContext.
+            public readonly object ReloadLock = new();
+            public readonly ReloadFence Fence = new();
+            // Replaced with the fence closed; null until loaded and after DestroyContext.
+            public ScriptContext? Context;
+            // Background load started by BeginReload; written under ReloadLock.
+            public Task? PendingReload;
+        }
+
+        // Written under _contextsLock; _contextList is a snapshot for enumerating without it.
+        private static readonly object _contextsLock = new();
+        private static readonly HandleTable<ContextSlot> _contexts = new();
+        private static ContextSlot[] _contextList = Array.Empty<ContextSlot>();
+        private static readonly ContextSlot _defaultContext = AddContext();
+
+        // Every registered signature, applied to each context as it loads, with the registry version it was
+        // last set at; locked on itself.
+        private static readonly Dictionary<int, (string ReturnType, string[] ParameterTypes, int Version)> _signatures = new();
+        private static int _signatureVersion;
+
+        private static ContextSlot AddContext()
+        {
+            lock (_contextsLock)
+            {
+                var slot = new ContextSlot();
+                slot.Id = _contexts.Add(slot);
+
+                var list = new ContextSlot[_contextList.Length + 1];
+                _contextList.CopyTo(list, 0);
+                list[^1] = slot;
+                Volatile.Write(ref _contextList, list);
+                return slot;
+            }
+        }
+
+        private static void RemoveContext(ContextSlot slot)
+        {
+            lock (_contextsLock)
+            {
+                _contexts.Remove(slot.Id, out _);
+                Volatile.Write(ref _contextList, Array.FindAll(_contextList, s => s != slot));
+            }
+        }
+
+        // 0 is the default context.
+        private static ContextSlot FindContext(int contextId)
+        {
+            if (contextId == 0 || contextId == _defaultContext.Id)
+            {
+                return _defaultContext;
+            }
+
+            if (!_contexts.TryGetValue(contextId, out var slot))
+            {
+                throw new KeyNotFoundException($"Script context not found or destroyed: {contextId}");
+            }
+
+            return slot;
+        }
+
+        // Builds a context for the slot with every registered signature.
+        private static ScriptContext NewScriptContext(string path, ContextSlot slot)
+        {
+            var context = new ScriptContext(path, _unloads, slot.Id);
+            ApplySignatures(context);
+            return context;
+        }
+
+        // Registers the signatures set since the context last caught up, e.g. while LoadAssemblyAsync built
+        // it. A signature whose types the assembly cannot resolve is skipped; binding with it fails there.
+        private static void ApplySignatures(ScriptContext context)
+        {
+            var signatures = new List<KeyValuePair<int, (string ReturnType, string[] ParameterTypes, int Version)>>();
+            lock (_signatures)
+            {
+                foreach (var pair in _signatures)
+                {
+                    if (pair.Value.Version > context.SignatureVersion)
+                    {
+                        signatures.Add(pair);
+                    }
+                }
+                context.SignatureVersion = _signatureVersion;
+            }
+
+            foreach (var pair in signatures)
+            {
+                try
+                {
+                    context.RegisterSignature(pair.Key, pair.Value.ReturnType, pair.Value.ParameterTypes);
+                }
+                catch (Exception ex)
+                {
+                    Logger.Write(LogLevel.Debug, LogCategory.Core, $"Signature {pair.Key} does not resolve in {context.PluginPath}: {ex.Message}");
+                }
+            }
+        }
+
+        // Applies a signature to every loaded context and remembers it for those loaded later. Throws if
+        // there are loaded contexts and none of them can resolve it.
+        private static void RegisterSignatureEverywhere(int signatureId, string returnTypeName, string[] parameterTypeNames)
+        {
+            bool replaced;
+            (string ReturnType, string[] ParameterTypes, int Version) previous;
+            lock (_signatures)
+            {
+                replaced = _signatures.TryGetValue(signatureId, out previous);
+                _signatures[signatureId] = (returnTypeName, parameterTypeNames, ++_signatureVersion);
+            }
+
+            int registered = 0;
+            Exception? firstError = null;
+            foreach (var slot in Volatile.Read(ref _contextList))
+            {
+                int stripe = slot.Fence.Enter();
+                try
+                {
+                    ScriptContext? context = Volatile.Read(ref slot.Context);
+                    if (context != null)
+                    {
+                        context.RegisterSignature(signatureId, returnTypeName, parameterTypeNames);
+                        registered++;
+                    }
+                }
+                catch (Exception ex)
+                {
+                    firstError ??= ex;
+                }
+                finally
+                {
+                    slot.Fence.Exit(stripe);
+                }
+            }
+
+            if (registered == 0 && firstError != null)
+            {
+                lock (_signatures)
+                {
+                    if (replaced)
+                    {
+                        // A new version, so a context built in between gets the old one back.
+                        _signatures[signatureId] = previous with { Version = ++_signatureVersion };
+                    }
+                    else
+                    {
+                        _signatures.Remove(signatureId);
+                    }
+                }
+                ExceptionDispatchInfo.Throw(firstError);
+            }
+        }
+
+        // Every export that touches a context holds a scope for the duration of the call, so a reload of
+        // that context waits for it. Exports may be called from any thread (see ScriptContext for what runs
+        // in parallel).
+        private static ContextScope EnterContext(ContextSlot slot)
+        {
+            int stripe = slot.Fence.Enter();
+            ScriptContext? context = Volatile.Read(ref slot.Context);
+            if (context == null)
+            {
+                slot.Fence.Exit(stripe);
+                throw new InvalidOperationException(slot == _defaultContext
+                    ? "No ScriptContext loaded. Call LoadAssembly first."
+                    : $"Script context {slot.Id} is not loaded");
+            }
+
+            return new ContextScope(context, slot.Fence, stripe);
+        }
+
+        private static ContextScope EnterContext(int contextId = 0) => EnterContext(FindContext(contextId));
+
+        private static ContextScope EnterInstanceOwner(int instanceId) => EnterContext(FindContext(HandleSpace.Instances.OwnerOf(instanceId)));
+
+        private static ContextScope EnterMethodOwner(int methodId) => EnterContext(FindContext(HandleSpace.Methods.OwnerOf(methodId)));
+
+        // GUIDs are looked up in every context, the default one first; keep them unique across contexts.
+        private static ContextScope EnterGuidOwner(Guid instanceGuid)
+        {
+            foreach (var slot in Volatile.Read(ref _contextList))
+            {
+                if (Volatile.Read(ref slot.Context)?.HasInstance(instanceGuid) == true)
+                {
+                    return EnterContext(slot);
+                }
+            }
+
+            // Reports the unknown GUID.
+            return EnterContext(_defaultContext);
+        }
+
+        // Batches may mix handles of several contexts; each run of consecutive calls into one context goes
+        // through that context's fence. Returns the end of the run that starts at begin.
+        private static unsafe int NextContextRun(int* methodIds, int begin, int callCount, out int contextId)
+        {
+            contextId = HandleSpace.Methods.OwnerOf(methodIds[begin]);
+            int end = begin + 1;
+            while (end < callCount && HandleSpace.Methods.OwnerOf(methodIds[end]) == contextId)
+            {
+                end++;
+            }
+
+            return end;
+        }
+
+        // For reports; null if the handle is not bound.
+        private static string? DescribeMethod(int methodId)
+        {
+            _contexts.TryGetValue(HandleSpace.Methods.OwnerOf(methodId), out var slot);
+            return Volatile.Read(ref (slot ?? _defaultContext).Context)?.DescribeMethod(methodId);
+        }
+
+        private readonly ref struct ContextScope
+        {
+            public readonly ScriptContext Context;
+            private readonly ReloadFence _fence;
+            private readonly int _stripe;
+
+            public ContextScope(ScriptContext context, ReloadFence fence, int stripe)
+            {
+                Context = context;
+                _fence = fence;
+                _stripe = stripe;
+            }
+
+            public void Dispose() => _fence.Exit(_stripe);
+        }
+
+        // Loads an assembly into a new script context alongside the others. Create instances and bind
+        // static or type methods in it with the *In exports; exports that take a handle or GUID find the
+        // context themselves. Returns the context id, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int CreateContext(IntPtr assemblyPathPtr)
+        {
+            ContextSlot? slot = null;
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.LoadAssembly);
+                string path = Path.GetFullPath(Marshal.PtrToStringUTF8(assemblyPathPtr)!);
+                slot = AddContext();
+                ScriptContext context = NewScriptContext(path, slot);
+                lock (slot.ReloadLock)
+                {
+                    slot.Fence.Close();
+                    try
+                    {
+                        // RegisterSignatureEverywhere skips the slot while it is empty; catch up on what it
+                        // skipped, and from here on it waits at the closed fence and finds the context.
+                        ApplySignatures(context);
+                        Volatile.Write(ref slot.Context, context);
+                    }
+                    finally
+                    {
+                        slot.Fence.Open();
+                    }
+                }
+
+                Logger.Write(LogLevel.Info, LogCategory.Core, $"Loaded Script Assembly into context {slot.Id}: {path}");
+                return slot.Id;
+            }
+            catch (Exception ex)
+            {
+                if (slot != null)
+                {
+                    RemoveContext(slot);
+                }
+
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"CreateContext failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Unloads a context made by CreateContext once the calls in flight into it return; other contexts
+        // keep running. Its handles are rejected from then on, and PollUnload reports when it is collected.
+        // Returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int DestroyContext(int contextId)
+        {
+            if (ReloadFence.IsInsideCall)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, "DestroyContext cannot be called from inside a script call");
+                return 0;
+            }
+
+            try
+            {
+                ContextSlot slot = FindContext(contextId);
+                if (slot == _defaultContext)
+                {
+                    throw new InvalidOperationException("The default context is replaced by LoadAssembly, not destroyed");
+                }
+
+                lock (slot.ReloadLock)
+                {
+                    slot.Fence.Close();
+                    try
+                    {
+                        Publish(slot, null);
+                    }
+                    finally
+                    {
+                        slot.Fence.Open();
+                    }
+                }
+
+                RemoveContext(slot);
+                Logger.Write(LogLevel.Info, LogCategory.Core, $"Destroyed script context {contextId}");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"DestroyContext failed: {ex}");
+                return 0;
+            }
+        }
+    }
+}
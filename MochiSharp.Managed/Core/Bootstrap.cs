@@ -1,47 +1,98 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Runtime.Loader;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace MochiSharp.Managed.Core
 {
-    public static class Bootstrap
+    public static partial class Bootstrap
     {
         private static HostHook? _hostHook;
-        private static ScriptContext? _scriptContext;
+
+        // Unloaded contexts waiting for the GC; see PollUnload.
+        private static readonly UnloadTracker _unloads = new();
+        // Contexts being built by LoadAssemblyAsync, by ticket; locked on itself.
+        private static readonly Dictionary<int, Task<ScriptContext>> _loads = new();
+        private static int _lastLoadTicket;
 
         private static int LoadAssemblyCore(string path)
         {
-            if (_scriptContext != null)
+            using var trace = Tracer.Begin(TraceEventKind.LoadAssembly);
+            if (ReloadFence.IsInsideCall)
             {
-                _scriptContext.Unload();
-                _scriptContext = null;
+                // The fence would wait for this very call to return.
+                Logger.Write(LogLevel.Error, LogCategory.Core, "LoadAssembly cannot be called from inside a script call");
+                return 0;
+            }
 
-                GC.Collect();
-                GC.WaitForPendingFinalizers();
+            ContextSlot slot = _defaultContext;
+            lock (slot.ReloadLock)
+            {
+                slot.Fence.Close();
+                try
+                {
+                    return ReloadCore(slot, path);
+                }
+                finally
+                {
+                    slot.Fence.Open();
+                }
             }
+        }
+
+        // Runs with the fence closed: no other thread is using the current context.
+        private static int ReloadCore(ContextSlot slot, string path)
+        {
+            Publish(slot, null);
 
             try
             {
                 string fullPath = System.IO.Path.GetFullPath(path);
-                _scriptContext = new ScriptContext(fullPath);
-                _hostHook?.Log($"Loaded Script Assembly: {fullPath}");
+                Volatile.Write(ref slot.Context, NewScriptContext(fullPath, slot));
+                Logger.Write(LogLevel.Info, LogCategory.Core, $"Loaded Script Assembly: {fullPath}");
                 return 1;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"Failed to load script assembly: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"Failed to load script assembly: {ex}");
                 return 0;
             }
         }
 
-        private static ScriptContext GetContextOrThrow()
+        // Replaces the slot's context. Runs with its fence closed.
+        private static void Publish(ContextSlot slot, ScriptContext? context)
+        {
+            WaitPendingReload(slot);
+
+            // The old context is reclaimed later, as PollUnload drives the GC.
+            slot.Context?.Unload();
+            Volatile.Write(ref slot.Context, context);
+        }
+
+        // Lets a background load finish before the context goes away; Unload drops what it prepared.
+        private static void WaitPendingReload(ContextSlot slot)
         {
-            if (_scriptContext == null)
+            Task? pending = slot.PendingReload;
+            slot.PendingReload = null;
+            if (pending != null)
             {
-                throw new InvalidOperationException("No ScriptContext loaded. Call LoadAssembly first.");
+                try
+                {
+                    pending.Wait();
+                }
+                catch (AggregateException)
+                {
+                }
             }
+        }
 
-            return _scriptContext;
+        internal static void Log(string message)
+        {
+            Logger.Write(LogLevel.Error, LogCategory.Core, message);
         }
 
         // Structure to hold C++ function pointers (Engine API)
@@ -49,6 +100,10 @@ namespace MochiSharp.Managed.Core
         public struct EngineInterface
         {
             public IntPtr LogMessage;
+            // MochiSharp::LogRingHeader shared with the host; null makes Logger fall back to LogMessage.
+            public IntPtr LogRing;
+            // MochiSharp::EngineApiHeader at the start of the engine's callback table, or null.
+            public IntPtr EngineApi;
         }
 
         // Entry point called by C++
@@ -57,14 +112,47 @@ namespace MochiSharp.Managed.Core
         public static int Initialize(IntPtr engineArgs)
         {
             var engineApi = Marshal.PtrToStructure<EngineInterface>(engineArgs);
+            ManagedMemory.Initialize();
 
             _hostHook = new HostHook(engineApi);
-            _hostHook.Log("C# Managed Core Initialized successfully");
+            Logger.Attach(_hostHook, engineApi.LogRing != IntPtr.Zero ? new LogRing(engineApi.LogRing) : null);
+            EngineApi.Attach(engineApi.EngineApi);
+            if (Logger.HasRing)
+            {
+                // Script Console output goes through the ring instead of blocking on stdout.
+                Console.SetOut(TextWriter.Synchronized(new LogTextWriter(LogLevel.Info)));
+                Console.SetError(TextWriter.Synchronized(new LogTextWriter(LogLevel.Error)));
+            }
+
+            Logger.Write(LogLevel.Info, LogCategory.Core, "C# Managed Core Initialized successfully");
 
             return 0;
         }
 
-        // Load/Reload a plugin assembly into a collectible context.
+        // Fill the host's function table (MochiSharp::ManagedApi) in one call.
+        // The caller sets Version and Size; entries beyond the caller's Size are left untouched and
+        // Size is set to the number of bytes written. Returns 1 on success, 0 on a version mismatch.
+        [UnmanagedCallersOnly]
+        public static unsafe int GetApiTable(IntPtr tablePtr)
+        {
+            var table = (ApiTable*)tablePtr;
+            if (table == null || table->Version != ApiTable.CurrentVersion || table->Size < sizeof(uint) * 2)
+            {
+                if (table != null)
+                {
+                    table->Version = ApiTable.CurrentVersion;
+                }
+                return 0;
+            }
+
+            uint size = Math.Min(table->Size, (uint)sizeof(ApiTable));
+            ApiTable source = ApiTable.Create();
+            source.Size = size;
+            Buffer.MemoryCopy(&source, table, size, size);
+            return 1;
+        }
+
+        // Load/Reload a plugin assembly into the default context (a collectible load context).
         [UnmanagedCallersOnly]
         public static int LoadAssembly(IntPtr assemblyPathPtr)
         {
@@ -72,42 +160,198 @@ namespace MochiSharp.Managed.Core
             return LoadAssemblyCore(path);
         }
 
-        // Create a script instance; returns a positive handle, 0 on error.
+        // Builds a new context for the assembly on a background thread: resolves its dependencies, loads
+        // it, and resolves and compiles the given script types (preloadTypeNamePtrs may be null). The
+        // default context keeps running until PollLoad or WaitLoad publishes the new one in its place.
+        // Returns a ticket, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int LoadAssemblyAsync(IntPtr assemblyPathPtr, IntPtr preloadTypeNamePtrs, int preloadTypeCount)
+        {
+            try
+            {
+                string path = System.IO.Path.GetFullPath(Marshal.PtrToStringUTF8(assemblyPathPtr)!);
+                string[] preload = ReadStrings(preloadTypeNamePtrs, preloadTypeCount);
+                var task = Task.Run(() =>
+                {
+                    using var trace = Tracer.Begin(TraceEventKind.LoadAssembly);
+                    var context = NewScriptContext(path, _defaultContext);
+                    try
+                    {
+                        int methods = context.Preload(preload);
+                        Logger.Write(LogLevel.Debug, LogCategory.Core, $"Preloaded {preload.Length} types, {methods} methods: {path}");
+                        return context;
+                    }
+                    catch
+                    {
+                        context.Unload();
+                        throw;
+                    }
+                });
+
+                int ticket;
+                lock (_loads)
+                {
+                    ticket = ++_lastLoadTicket;
+                    _loads.Add(ticket, task);
+                }
+
+                Logger.Write(LogLevel.Info, LogCategory.Core, $"Loading Script Assembly in the background (ticket {ticket}): {path}");
+                return ticket;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"LoadAssemblyAsync failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Returns 1 while the load is running. Once it is done, publishes the new context in place of the
+        // current one (waiting for calls in flight, as LoadAssembly does) and returns 2, or returns -1 if
+        // it failed. A ticket reports its outcome once; afterwards, and for unknown tickets, returns 0.
+        // Must not be called from inside a script call; there it logs an error and returns 1, leaving the
+        // load pending for a later call.
+        [UnmanagedCallersOnly]
+        public static int PollLoad(int ticket)
+        {
+            Task<ScriptContext>? task = FindLoad(ticket);
+            if (task == null)
+            {
+                return 0;
+            }
+
+            return task.IsCompleted ? CompleteLoad(ticket, task) : 1;
+        }
+
+        // Like PollLoad, but blocks until the load is done.
+        [UnmanagedCallersOnly]
+        public static int WaitLoad(int ticket)
+        {
+            Task<ScriptContext>? task = FindLoad(ticket);
+            if (task == null)
+            {
+                return 0;
+            }
+
+            try
+            {
+                task.Wait();
+            }
+            catch (AggregateException)
+            {
+                // Reported by CompleteLoad.
+            }
+
+            return CompleteLoad(ticket, task);
+        }
+
+        private static Task<ScriptContext>? FindLoad(int ticket)
+        {
+            lock (_loads)
+            {
+                return _loads.GetValueOrDefault(ticket);
+            }
+        }
+
+        private static int CompleteLoad(int ticket, Task<ScriptContext> task)
+        {
+            if (ReloadFence.IsInsideCall)
+            {
+                // Still pending: the ticket stays in _loads and a later call outside scripts publishes it.
+                Logger.Write(LogLevel.Error, LogCategory.Core, "PollLoad and WaitLoad cannot publish from inside a script call");
+                return 1;
+            }
+
+            lock (_loads)
+            {
+                if (!_loads.Remove(ticket))
+                {
+                    // Another thread completed it first.
+                    return 0;
+                }
+            }
+
+            if (!task.IsCompletedSuccessfully)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"Failed to load script assembly (ticket {ticket}): {task.Exception?.InnerException}");
+                return -1;
+            }
+
+            using var trace = Tracer.Begin(TraceEventKind.LoadAssembly);
+            // Signatures registered while it was being built.
+            ApplySignatures(task.Result);
+            ContextSlot slot = _defaultContext;
+            lock (slot.ReloadLock)
+            {
+                slot.Fence.Close();
+                try
+                {
+                    // And any registered since: RegisterSignatureEverywhere only saw the old context, and
+                    // from here on it waits at the closed fence and finds the new one.
+                    ApplySignatures(task.Result);
+                    Publish(slot, task.Result);
+                }
+                finally
+                {
+                    slot.Fence.Open();
+                }
+            }
+
+            Logger.Write(LogLevel.Info, LogCategory.Core, $"Loaded Script Assembly (ticket {ticket}): {task.Result.PluginPath}");
+            return 2;
+        }
+
+        // Create a script instance in the default context; returns a positive handle, 0 on error.
         [UnmanagedCallersOnly]
         public static int CreateInstance(IntPtr typeNamePtr)
+        {
+            return CreateInstanceCore(0, typeNamePtr);
+        }
+
+        // CreateInstance in the context with the given id (see CreateContext).
+        [UnmanagedCallersOnly]
+        public static int CreateInstanceIn(int contextId, IntPtr typeNamePtr)
+        {
+            return CreateInstanceCore(contextId, typeNamePtr);
+        }
+
+        private static int CreateInstanceCore(int contextId, IntPtr typeNamePtr)
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.CreateInstance);
+                using var scope = EnterContext(contextId);
                 string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
-                int id = GetContextOrThrow().CreateInstance(typeName);
-                _hostHook?.Log($"Created instance {id}: {typeName}");
+                int id = scope.Context.CreateInstance(typeName);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Created instance {id}: {typeName}");
                 return id;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"CreateInstance failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"CreateInstance failed: {ex}");
                 return 0;
             }
         }
 
         // Create a script instance with a caller-supplied GUID key.
-        // Returns 1 on success, 0 on error.
+        // Returns the instance handle (usable with InvokeOn), 0 on error.
         [UnmanagedCallersOnly]
         public static int CreateInstanceGuid(IntPtr typeNamePtr, IntPtr instanceGuidPtr)
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.CreateInstance);
+                using var scope = EnterContext();
                 string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
                 string guidText = Marshal.PtrToStringUTF8(instanceGuidPtr)!;
                 Guid instanceGuid = Guid.Parse(guidText);
 
-                GetContextOrThrow().CreateInstance(instanceGuid, typeName);
-                _hostHook?.Log($"Created instance {instanceGuid}: {typeName}");
-                return 1;
+                int id = scope.Context.CreateInstance(instanceGuid, typeName);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Created instance {id} ({instanceGuid}): {typeName}");
+                return id;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"CreateInstanceGuid failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"CreateInstanceGuid failed: {ex}");
                 return 0;
             }
         }
@@ -117,11 +361,13 @@ namespace MochiSharp.Managed.Core
         {
             try
             {
-                GetContextOrThrow().DestroyInstance(instanceId);
+                using var trace = Tracer.Begin(TraceEventKind.DestroyInstance);
+                using var scope = EnterInstanceOwner(instanceId);
+                scope.Context.DestroyInstance(instanceId);
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"DestroyInstance failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"DestroyInstance failed: {ex}");
             }
         }
 
@@ -130,13 +376,15 @@ namespace MochiSharp.Managed.Core
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.DestroyInstance);
                 string guidText = Marshal.PtrToStringUTF8(instanceGuidPtr)!;
                 Guid instanceGuid = Guid.Parse(guidText);
-                GetContextOrThrow().DestroyInstance(instanceGuid);
+                using var scope = EnterGuidOwner(instanceGuid);
+                scope.Context.DestroyInstance(instanceGuid);
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"DestroyInstanceGuid failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"DestroyInstanceGuid failed: {ex}");
             }
         }
 
@@ -146,14 +394,16 @@ namespace MochiSharp.Managed.Core
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                using var scope = EnterInstanceOwner(instanceId);
                 string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
-                int id = GetContextOrThrow().BindInstanceMethod(instanceId, methodName, signature);
-                _hostHook?.Log($"Bound instance method {id}: instance {instanceId}.{methodName} (sig={signature})");
+                int id = scope.Context.BindInstanceMethod(instanceId, methodName, signature);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method {id}: instance {instanceId}.{methodName} (sig={signature})");
                 return id;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"BindInstanceMethod failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethod failed: {ex}");
                 return 0;
             }
         }
@@ -164,90 +414,905 @@ namespace MochiSharp.Managed.Core
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
                 string guidText = Marshal.PtrToStringUTF8(instanceGuidPtr)!;
                 Guid instanceGuid = Guid.Parse(guidText);
+                using var scope = EnterGuidOwner(instanceGuid);
                 string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
 
-                int id = GetContextOrThrow().BindInstanceMethod(instanceGuid, methodName, signature);
-                _hostHook?.Log($"Bound instance method {id}: instance {instanceGuid}.{methodName} (sig={signature})");
+                int id = scope.Context.BindInstanceMethod(instanceGuid, methodName, signature);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method {id}: instance {instanceGuid}.{methodName} (sig={signature})");
                 return id;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"BindInstanceMethodGuid failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethodGuid failed: {ex}");
                 return 0;
             }
         }
 
-        // Bind a static method and return a method handle.
+        // Bind a static method of the default context and return a method handle.
         [UnmanagedCallersOnly]
         public static int BindStaticMethod(IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
+        {
+            return BindStaticMethodCore(0, typeNamePtr, methodNamePtr, signature);
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindStaticMethodIn(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
+        {
+            return BindStaticMethodCore(contextId, typeNamePtr, methodNamePtr, signature);
+        }
+
+        private static int BindStaticMethodCore(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
         {
             try
             {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                using var scope = EnterContext(contextId);
                 string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
                 string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
-                int id = GetContextOrThrow().BindStaticMethod(typeName, methodName, signature);
-                _hostHook?.Log($"Bound static method {id}: {typeName}.{methodName} (sig={signature})");
+                int id = scope.Context.BindStaticMethod(typeName, methodName, signature);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound static method {id}: {typeName}.{methodName} (sig={signature})");
                 return id;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"BindStaticMethod failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindStaticMethod failed: {ex}");
                 return 0;
             }
         }
 
+        // Bind an instance method once for a type of the default context and return a method handle
+        // for InvokeOn.
         [UnmanagedCallersOnly]
-        public static int RegisterSignature(int signatureId, IntPtr returnTypeNamePtr, IntPtr parameterTypeNamePtrs, int parameterCount)
+        public static int BindTypeMethod(IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
+        {
+            return BindTypeMethodCore(0, typeNamePtr, methodNamePtr, signature);
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindTypeMethodIn(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
+        {
+            return BindTypeMethodCore(contextId, typeNamePtr, methodNamePtr, signature);
+        }
+
+        private static int BindTypeMethodCore(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature)
         {
             try
             {
-                string returnTypeName = Marshal.PtrToStringUTF8(returnTypeNamePtr)!;
-                var paramNames = parameterCount == 0 ? Array.Empty<string>() : new string[parameterCount];
-                for (int i = 0; i < paramNames.Length; i++)
-                {
-                    IntPtr p = Marshal.ReadIntPtr(parameterTypeNamePtrs, i * IntPtr.Size);
-                    paramNames[i] = Marshal.PtrToStringUTF8(p)!;
-                }
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                using var scope = EnterContext(contextId);
+                string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+                int id = scope.Context.BindTypeMethod(typeName, methodName, signature);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound type method {id}: {typeName}.{methodName} (sig={signature})");
+                return id;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindTypeMethod failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Release a method handle. Handles of an instance are released with it by DestroyInstance.
+        [UnmanagedCallersOnly]
+        public static void UnbindMethod(int methodId)
+        {
+            try
+            {
+                using var scope = EnterMethodOwner(methodId);
+                scope.Context.UnbindMethod(methodId);
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"UnbindMethod failed: {ex}");
+            }
+        }
 
-                GetContextOrThrow().RegisterSignature(signatureId, returnTypeName, paramNames);
-                _hostHook?.Log($"Registered signature {signatureId}: {returnTypeName}({string.Join(",", paramNames)})");
+        // Bind an instance method for direct native calls.
+        // Writes a NativeMethodPointer to outMethodPtr; returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int BindInstanceMethodPtr(int instanceId, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                using var scope = EnterInstanceOwner(instanceId);
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+                var method = scope.Context.BindInstanceMethodPtr(instanceId, methodName, signature);
+                Marshal.StructureToPtr(method, outMethodPtr, fDeleteOld: false);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method pointer: instance {instanceId}.{methodName} (sig={signature})");
                 return 1;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"RegisterSignature failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethodPtr failed: {ex}");
                 return 0;
             }
         }
 
-        // Generic invoke.
-        // argsPtr points to an array of IntPtr, each element points to the value for that argument.
-        // - int: pointer to int32
-        // - float: pointer to float32
-        // - bool: pointer to int32 (0/1)
-        // - struct: pointer to struct bytes (LayoutKind.Sequential)
-        // returnPtr:
-        // - void: can be null
-        // - int/bool: pointer to int32
-        // - float: pointer to float32
-        // - struct: pointer to struct bytes
         [UnmanagedCallersOnly]
-        public static int Invoke(int methodId, IntPtr argsPtr, int argCount, IntPtr returnPtr)
+        public static int BindInstanceMethodPtrGuid(IntPtr instanceGuidPtr, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                string guidText = Marshal.PtrToStringUTF8(instanceGuidPtr)!;
+                Guid instanceGuid = Guid.Parse(guidText);
+                using var scope = EnterGuidOwner(instanceGuid);
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+
+                var method = scope.Context.BindInstanceMethodPtr(instanceGuid, methodName, signature);
+                Marshal.StructureToPtr(method, outMethodPtr, fDeleteOld: false);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method pointer: instance {instanceGuid}.{methodName} (sig={signature})");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethodPtrGuid failed: {ex}");
+                return 0;
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindStaticMethodPtr(IntPtr typeNamePtr, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
+        {
+            return BindStaticMethodPtrCore(0, typeNamePtr, methodNamePtr, signature, outMethodPtr);
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindStaticMethodPtrIn(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
+        {
+            return BindStaticMethodPtrCore(contextId, typeNamePtr, methodNamePtr, signature, outMethodPtr);
+        }
+
+        private static int BindStaticMethodPtrCore(int contextId, IntPtr typeNamePtr, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                using var scope = EnterContext(contextId);
+                string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+                var method = scope.Context.BindStaticMethodPtr(typeName, methodName, signature);
+                Marshal.StructureToPtr(method, outMethodPtr, fDeleteOld: false);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound static method pointer: {typeName}.{methodName} (sig={signature})");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindStaticMethodPtr failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Binary GUID variants: instanceGuidPtr points to 16 bytes laid out like System.Guid
+        // (MochiSharp::ScriptGuid), so no string is allocated or parsed for the key.
+        [UnmanagedCallersOnly]
+        public static int CreateInstanceGuidBinary(IntPtr typeNamePtr, IntPtr instanceGuidPtr)
+        {
+            return CreateInstanceGuidBinaryCore(0, typeNamePtr, instanceGuidPtr);
+        }
+
+        [UnmanagedCallersOnly]
+        public static int CreateInstanceGuidBinaryIn(int contextId, IntPtr typeNamePtr, IntPtr instanceGuidPtr)
+        {
+            return CreateInstanceGuidBinaryCore(contextId, typeNamePtr, instanceGuidPtr);
+        }
+
+        private static int CreateInstanceGuidBinaryCore(int contextId, IntPtr typeNamePtr, IntPtr instanceGuidPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.CreateInstance);
+                using var scope = EnterContext(contextId);
+                string typeName = Marshal.PtrToStringUTF8(typeNamePtr)!;
+                Guid instanceGuid = ReadGuid(instanceGuidPtr);
+
+                int id = scope.Context.CreateInstance(instanceGuid, typeName);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Created instance {id} ({instanceGuid}): {typeName}");
+                return id;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"CreateInstanceGuidBinary failed: {ex}");
+                return 0;
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        public static void DestroyInstanceGuidBinary(IntPtr instanceGuidPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.DestroyInstance);
+                Guid instanceGuid = ReadGuid(instanceGuidPtr);
+                using var scope = EnterGuidOwner(instanceGuid);
+                scope.Context.DestroyInstance(instanceGuid);
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"DestroyInstanceGuidBinary failed: {ex}");
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindInstanceMethodGuidBinary(IntPtr instanceGuidPtr, IntPtr methodNamePtr, int signature)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                Guid instanceGuid = ReadGuid(instanceGuidPtr);
+                using var scope = EnterGuidOwner(instanceGuid);
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+
+                int id = scope.Context.BindInstanceMethod(instanceGuid, methodName, signature);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method {id}: instance {instanceGuid}.{methodName} (sig={signature})");
+                return id;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethodGuidBinary failed: {ex}");
+                return 0;
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        public static int BindInstanceMethodPtrGuidBinary(IntPtr instanceGuidPtr, IntPtr methodNamePtr, int signature, IntPtr outMethodPtr)
         {
             try
             {
-                GetContextOrThrow().Invoke(methodId, argsPtr, argCount, returnPtr);
+                using var trace = Tracer.Begin(TraceEventKind.Bind);
+                Guid instanceGuid = ReadGuid(instanceGuidPtr);
+                using var scope = EnterGuidOwner(instanceGuid);
+                string methodName = Marshal.PtrToStringUTF8(methodNamePtr)!;
+
+                var method = scope.Context.BindInstanceMethodPtr(instanceGuid, methodName, signature);
+                Marshal.StructureToPtr(method, outMethodPtr, fDeleteOld: false);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Bound instance method pointer: instance {instanceGuid}.{methodName} (sig={signature})");
                 return 1;
             }
             catch (Exception ex)
             {
-                _hostHook?.Log($"Invoke failed: {ex}");
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BindInstanceMethodPtrGuidBinary failed: {ex}");
                 return 0;
             }
         }
 
+        private static string[] ReadStrings(IntPtr stringPtrs, int count)
+        {
+            var strings = count <= 0 ? Array.Empty<string>() : new string[count];
+            for (int i = 0; i < strings.Length; i++)
+            {
+                IntPtr p = Marshal.ReadIntPtr(stringPtrs, i * IntPtr.Size);
+                strings[i] = Marshal.PtrToStringUTF8(p)!;
+            }
+
+            return strings;
+        }
+
+        private static unsafe Guid ReadGuid(IntPtr instanceGuidPtr)
+        {
+            if (instanceGuidPtr == IntPtr.Zero)
+            {
+                throw new ArgumentNullException(nameof(instanceGuidPtr));
+            }
+
+            return Unsafe.ReadUnaligned<Guid>((void*)instanceGuidPtr);
+        }
+
+        // Signatures are shared by every context, including those loaded later (see
+        // RegisterSignatureEverywhere).
+        [UnmanagedCallersOnly]
+        public static int RegisterSignature(int signatureId, IntPtr returnTypeNamePtr, IntPtr parameterTypeNamePtrs, int parameterCount)
+        {
+            try
+            {
+                ArgumentOutOfRangeException.ThrowIfNegative(signatureId);
+                string returnTypeName = Marshal.PtrToStringUTF8(returnTypeNamePtr)!;
+                string[] paramNames = ReadStrings(parameterTypeNamePtrs, parameterCount);
+
+                RegisterSignatureEverywhere(signatureId, returnTypeName, paramNames);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Registered signature {signatureId}: {returnTypeName}({string.Join(",", paramNames)})");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"RegisterSignature failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Generic invoke.
+        // argsPtr points to an array of IntPtr, each element points to the value for that argument.
+        // - int: pointer to int32
+        // - float: pointer to float32
+        // - bool: pointer to int32 (0/1)
+        // - struct: pointer to struct bytes (blittable, LayoutKind.Sequential or Explicit)
+        // returnPtr:
+        // - void: can be null
+        // - int/bool: pointer to int32
+        // - float: pointer to float32
+        // - struct: pointer to struct bytes
+        // Signatures with non-blittable types are rejected by RegisterSignature.
+        [UnmanagedCallersOnly]
+        public static int Invoke(int methodId, IntPtr argsPtr, int argCount, IntPtr returnPtr)
+        {
+            try
+            {
+                using var scope = EnterMethodOwner(methodId);
+                scope.Context.Invoke(methodId, argsPtr, argCount, returnPtr);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"Invoke failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Invoke a type-level binding on an instance. Arguments and return as for Invoke.
+        [UnmanagedCallersOnly]
+        public static int InvokeOn(int methodId, int instanceId, IntPtr argsPtr, int argCount, IntPtr returnPtr)
+        {
+            try
+            {
+                using var scope = EnterMethodOwner(methodId);
+                scope.Context.InvokeOn(methodId, instanceId, argsPtr, argCount, returnPtr);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"InvokeOn failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Batched invoke: runs callCount calls in a single transition. Calls may target several contexts;
+        // each run of consecutive calls into one context is entered once.
+        // methodIdsPtr: int32[callCount]
+        // argsPerCallPtr: IntPtr[callCount], each an args array as for Invoke; with mode 1 (shared args)
+        //   only argsPerCallPtr[0] is read and passed to every call. May be null if no call takes arguments.
+        // returnsPtr: optional IntPtr[callCount] of return pointers (entries may be null for void).
+        // statusesPtr: optional int32[callCount], receives 1/0 per call.
+        // Returns the number of calls that succeeded.
+        [UnmanagedCallersOnly]
+        public static unsafe int InvokeBatch(IntPtr methodIdsPtr, IntPtr argsPerCallPtr, int callCount, IntPtr returnsPtr, IntPtr statusesPtr, int mode)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.InvokeBatch, callCount);
+                var methodIds = (int*)methodIdsPtr;
+                var argsPerCall = (IntPtr*)argsPerCallPtr;
+                var returns = (IntPtr*)returnsPtr;
+                var statuses = (int*)statusesPtr;
+                bool sharedArgs = mode == 1;
+                int succeeded = 0;
+                Exception? firstError = null;
+                for (int begin = 0, end; begin < callCount; begin = end)
+                {
+                    end = NextContextRun(methodIds, begin, callCount, out int contextId);
+                    try
+                    {
+                        using var scope = EnterContext(contextId);
+                        succeeded += scope.Context.InvokeBatch((IntPtr)(methodIds + begin),
+                            argsPerCall == null || sharedArgs ? argsPerCallPtr : (IntPtr)(argsPerCall + begin), end - begin,
+                            returns == null ? IntPtr.Zero : (IntPtr)(returns + begin),
+                            statuses == null ? IntPtr.Zero : (IntPtr)(statuses + begin), sharedArgs, out var runError);
+                        firstError ??= runError;
+                    }
+                    catch (Exception ex)
+                    {
+                        firstError ??= ex;
+                        if (statuses != null)
+                        {
+                            new Span<int>(statuses + begin, end - begin).Clear();
+                        }
+                    }
+                }
+
+                if (firstError != null)
+                {
+                    Logger.Write(LogLevel.Error, LogCategory.Core, $"InvokeBatch: {callCount - succeeded} of {callCount} calls failed, first: {firstError}");
+                }
+
+                return succeeded;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"InvokeBatch failed: {ex}");
+                if (statusesPtr != IntPtr.Zero)
+                {
+                    new Span<int>((void*)statusesPtr, callCount).Clear();
+                }
+
+                return 0;
+            }
+        }
+
+        // Batched invoke over (method, instance) pairs with shared arguments, used by the native ScriptScheduler.
+        // methodIdsPtr: int32[callCount]; instanceIdsPtr: optional int32[callCount], 0 for bindings with their
+        // own target; argsPtr: one args array as for Invoke, passed to every call; statusesPtr: optional
+        // int32[callCount], receives 1/0 per call. Returns the number of calls that succeeded.
+        [UnmanagedCallersOnly]
+        public static unsafe int InvokeOnBatch(IntPtr methodIdsPtr, IntPtr instanceIdsPtr, int callCount, IntPtr argsPtr, IntPtr statusesPtr)
+        {
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.InvokeBatch, callCount);
+                var methodIds = (int*)methodIdsPtr;
+                var instanceIds = (int*)instanceIdsPtr;
+                var statuses = (int*)statusesPtr;
+                int succeeded = 0;
+                Exception? firstError = null;
+                for (int begin = 0, end; begin < callCount; begin = end)
+                {
+                    end = NextContextRun(methodIds, begin, callCount, out int contextId);
+                    try
+                    {
+                        using var scope = EnterContext(contextId);
+                        succeeded += scope.Context.InvokeOnBatch((IntPtr)(methodIds + begin),
+                            instanceIds == null ? IntPtr.Zero : (IntPtr)(instanceIds + begin), end - begin, argsPtr,
+                            statuses == null ? IntPtr.Zero : (IntPtr)(statuses + begin), out var runError);
+                        firstError ??= runError;
+                    }
+                    catch (Exception ex)
+                    {
+                        firstError ??= ex;
+                        if (statuses != null)
+                        {
+                            new Span<int>(statuses + begin, end - begin).Clear();
+                        }
+                    }
+                }
+
+                if (firstError != null)
+                {
+                    Logger.Write(LogLevel.Error, LogCategory.Core, $"InvokeOnBatch: {callCount - succeeded} of {callCount} calls failed, first: {firstError}");
+                }
+
+                return succeeded;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"InvokeOnBatch failed: {ex}");
+                if (statusesPtr != IntPtr.Zero)
+                {
+                    new Span<int>((void*)statusesPtr, callCount).Clear();
+                }
+
+                return 0;
+            }
+        }
+
+        // Returns 1 if the call is marked [ParallelSafe], 0 if not, -1 on error.
+        [UnmanagedCallersOnly]
+        public static int IsParallelSafe(int methodId, int instanceId)
+        {
+            try
+            {
+                using var scope = EnterMethodOwner(methodId);
+                return scope.Context.IsParallelSafe(methodId, instanceId) ? 1 : 0;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"IsParallelSafe failed: {ex}");
+                return -1;
+            }
+        }
+
+        // Starts loading a new build of the default context's script assembly on a background thread
+        // while scripts keep running; CommitReload swaps it in. Returns 1 if started, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int BeginReload(IntPtr assemblyPathPtr)
+        {
+            return BeginReloadCore(0, assemblyPathPtr);
+        }
+
+        // BeginReload for one context; the others keep running through its reload.
+        [UnmanagedCallersOnly]
+        public static int BeginReloadIn(int contextId, IntPtr assemblyPathPtr)
+        {
+            return BeginReloadCore(contextId, assemblyPathPtr);
+        }
+
+        private static int BeginReloadCore(int contextId, IntPtr assemblyPathPtr)
+        {
+            try
+            {
+                string path = System.IO.Path.GetFullPath(Marshal.PtrToStringUTF8(assemblyPathPtr)!);
+                ContextSlot slot = FindContext(contextId);
+                lock (slot.ReloadLock)
+                {
+                    ScriptContext context = slot.Context ?? throw new InvalidOperationException(slot == _defaultContext
+                        ? "No ScriptContext loaded. Call LoadAssembly first."
+                        : $"Script context {slot.Id} is not loaded");
+                    if (slot.PendingReload != null)
+                    {
+                        throw new InvalidOperationException("A reload is already in progress");
+                    }
+
+                    slot.PendingReload = Task.Run(() =>
+                    {
+                        using var trace = Tracer.Begin(TraceEventKind.Reload);
+                        context.PrepareReload(path);
+                    });
+                }
+
+                Logger.Write(LogLevel.Info, LogCategory.Core, $"Reloading Script Assembly: {path}");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"BeginReload failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Returns 0 if no reload is pending, 1 while loading, 2 when ready to commit, -1 if the load
+        // failed (logged once; the pending reload is dropped).
+        [UnmanagedCallersOnly]
+        public static int PollReload()
+        {
+            return PollReloadCore(_defaultContext);
+        }
+
+        [UnmanagedCallersOnly]
+        public static int PollReloadIn(int contextId)
+        {
+            ContextSlot slot;
+            try
+            {
+                slot = FindContext(contextId);
+            }
+            catch (KeyNotFoundException)
+            {
+                return 0;
+            }
+
+            return PollReloadCore(slot);
+        }
+
+        private static int PollReloadCore(ContextSlot slot)
+        {
+            Task? pending = Volatile.Read(ref slot.PendingReload);
+            if (pending == null)
+            {
+                return 0;
+            }
+
+            if (!pending.IsCompleted)
+            {
+                return 1;
+            }
+
+            if (!pending.IsFaulted)
+            {
+                return 2;
+            }
+
+            if (Interlocked.CompareExchange(ref slot.PendingReload, null, pending) == pending)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"Reload failed: {pending.Exception!.InnerException}");
+            }
+
+            return -1;
+        }
+
+        // Swaps in the build loaded by BeginReload, waiting for it if needed. Call at a frame boundary:
+        // the swap waits for calls on other threads to return and blocks new ones until it is done.
+        // Handles, GUIDs and direct-call pointers stay valid. Writes MochiSharp::ReloadStats to
+        // outStatsPtr if not null. Returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int CommitReload(IntPtr outStatsPtr)
+        {
+            return CommitReloadCore(0, outStatsPtr);
+        }
+
+        // CommitReload for one context: only calls into that context wait for the swap.
+        [UnmanagedCallersOnly]
+        public static int CommitReloadIn(int contextId, IntPtr outStatsPtr)
+        {
+            return CommitReloadCore(contextId, outStatsPtr);
+        }
+
+        private static int CommitReloadCore(int contextId, IntPtr outStatsPtr)
+        {
+            if (ReloadFence.IsInsideCall)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, "CommitReload cannot be called from inside a script call");
+                return 0;
+            }
+
+            try
+            {
+                using var trace = Tracer.Begin(TraceEventKind.Reload);
+                ContextSlot slot = FindContext(contextId);
+                lock (slot.ReloadLock)
+                {
+                    Task pending = slot.PendingReload ?? throw new InvalidOperationException("No reload in progress. Call BeginReload first.");
+                    slot.PendingReload = null;
+                    pending.GetAwaiter().GetResult();
+
+                    ReloadStats stats;
+                    slot.Fence.Close();
+                    try
+                    {
+                        stats = slot.Context!.CommitReload();
+                    }
+                    finally
+                    {
+                        slot.Fence.Open();
+                    }
+
+                    Logger.Write(LogLevel.Info, LogCategory.Core, $"Reloaded Script Assembly in {stats.CommitMs:F3} ms: {stats.InstancesMigrated} instances, {stats.BindingsRebound} methods, {stats.PointersRebound} pointers");
+                    if (outStatsPtr != IntPtr.Zero)
+                    {
+                        Marshal.StructureToPtr(stats, outStatsPtr, fDeleteOld: false);
+                    }
+                    return 1;
+                }
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"CommitReload failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Drives reclaiming unloaded script contexts: checks which are gone and asks the GC for a
+        // background collection if some are left, waiting at most budgetMs for progress. Call it once per
+        // frame after a reload. Writes MochiSharp::UnloadStatus to outStatusPtr if not null. Returns the
+        // number of contexts still pending, -1 on error.
+        [UnmanagedCallersOnly]
+        public static int PollUnload(double budgetMs, IntPtr outStatusPtr)
+        {
+            long traceBegin = Tracer.IsEnabled ? Tracer.NowNs() : 0;
+            try
+            {
+                UnloadStatus status = _unloads.Poll(budgetMs, static context =>
+                {
+                    var roots = new List<string>();
+                    foreach (var slot in Volatile.Read(ref _contextList))
+                    {
+                        string? description = Volatile.Read(ref slot.Context)?.DescribeRootsInto(context);
+                        if (description != null)
+                        {
+                            roots.Add(slot == _defaultContext ? description : $"context {slot.Id}: {description}");
+                        }
+                    }
+                    return roots.Count == 0 ? null : string.Join("; ", roots);
+                });
+                if (outStatusPtr != IntPtr.Zero)
+                {
+                    Marshal.StructureToPtr(status, outStatusPtr, fDeleteOld: false);
+                }
+                if (traceBegin != 0)
+                {
+                    Tracer.Record(TraceEventKind.Unload, traceBegin, Tracer.NowNs(), count: status.Pending);
+                }
+                return status.Pending;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"PollUnload failed: {ex}");
+                return -1;
+            }
+        }
+
+        // Shares a native array with scripts under a name (see SharedBuffer<T>); registering a name again
+        // replaces the array. elementTypeNamePtr may be null to skip the type check. Independent of the
+        // loaded context. Returns the buffer's new generation, 0 on error.
+        [UnmanagedCallersOnly]
+        public static uint RegisterBuffer(IntPtr namePtr, IntPtr data, IntPtr elementTypeNamePtr, int stride, int count)
+        {
+            try
+            {
+                string name = Marshal.PtrToStringUTF8(namePtr)!;
+                string? elementTypeName = Marshal.PtrToStringUTF8(elementTypeNamePtr);
+                uint generation = SharedBuffers.Register(name, data, elementTypeName, stride, count);
+                Logger.Write(LogLevel.Debug, LogCategory.Core, $"Registered shared buffer '{name}': {count} x {stride} bytes of {elementTypeName} (generation {generation})");
+                return generation;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"RegisterBuffer failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Empties a shared buffer, e.g. before its memory is freed. Returns its new generation.
+        [UnmanagedCallersOnly]
+        public static uint UnregisterBuffer(IntPtr namePtr)
+        {
+            string name = Marshal.PtrToStringUTF8(namePtr)!;
+            return SharedBuffers.Unregister(name);
+        }
+
+        // Writes the reflection cache counters of the loaded context to outStatsPtr
+        // (MochiSharp::MetadataCacheStats). Returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int GetMetadataCacheStats(IntPtr outStatsPtr)
+        {
+            try
+            {
+                using var scope = EnterContext();
+                Marshal.StructureToPtr(scope.Context.MetadataStats, outStatsPtr, fDeleteOld: false);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"GetMetadataCacheStats failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Writes the runtime configuration in effect to outInfoPtr (MochiSharp::RuntimeInfo).
+        // Returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int GetRuntimeInfo(IntPtr outInfoPtr)
+        {
+            try
+            {
+                Marshal.StructureToPtr(RuntimeInfo.Capture(), outInfoPtr, fDeleteOld: false);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"GetRuntimeInfo failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Writes GC counters to outStatsPtr (MochiSharp::ManagedMemoryStats). AllocatedBytes counts from
+        // the previous call, or from Initialize for the first. Returns 1 on success, 0 on error.
+        [UnmanagedCallersOnly]
+        public static int GetManagedMemoryStats(IntPtr outStatsPtr)
+        {
+            try
+            {
+                Marshal.StructureToPtr(ManagedMemory.Capture(), outStatsPtr, fDeleteOld: false);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"GetManagedMemoryStats failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Starts a no-GC region with a budget of totalBytes allocated; the GC runs a full blocking
+        // collection first. Returns 1 if it started, 0 if not.
+        [UnmanagedCallersOnly]
+        public static int BeginNoGCRegion(long totalBytes)
+        {
+            return ManagedMemory.BeginNoGCRegion(totalBytes) ? 1 : 0;
+        }
+
+        // Returns 1 if the region held until now, 0 if none was active or a collection ended it early.
+        [UnmanagedCallersOnly]
+        public static int EndNoGCRegion()
+        {
+            return ManagedMemory.EndNoGCRegion() ? 1 : 0;
+        }
+
+        // Selects how method handles bound from now on are called (see InvokeMode); handles bound
+        // earlier keep theirs. Returns 1 on success, 0 for an unknown mode.
+        [UnmanagedCallersOnly]
+        public static int SetInvokeMode(int mode)
+        {
+            if (!Enum.IsDefined((InvokeMode)mode))
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"SetInvokeMode: unknown mode {mode}");
+                return 0;
+            }
+
+            InvokeThunkCompiler.Mode = (InvokeMode)mode;
+            return 1;
+        }
+
+        // Starts recording calls through method handles (see CallProfiler), with counters for handles
+        // in the first methodCapacity slots. Starting again discards the previous profile.
+        [UnmanagedCallersOnly]
+        public static int StartProfiler(int methodCapacity)
+        {
+            try
+            {
+                CallProfiler.Start(methodCapacity);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"StartProfiler failed: {ex}");
+                return 0;
+            }
+        }
+
+        // Stops recording; the profile can still be read.
+        [UnmanagedCallersOnly]
+        public static void StopProfiler()
+        {
+            CallProfiler.Stop();
+        }
+
+        // Writes up to capacity MochiSharp::MethodProfile entries to outProfilesPtr, busiest first, named
+        // by the loaded context. Returns the number of profiled methods (which may exceed capacity), 0 if
+        // the profiler never ran, -1 on error.
+        [UnmanagedCallersOnly]
+        public static unsafe int GetProfile(IntPtr outProfilesPtr, int capacity)
+        {
+            try
+            {
+                CallProfiler? profiler = CallProfiler.Last;
+                if (profiler == null)
+                {
+                    return 0;
+                }
+
+                if (profiler.Dropped > 0)
+                {
+                    Logger.Write(LogLevel.Warning, LogCategory.Core, $"Call profiler: {profiler.Dropped} calls not recorded; their handles are past the {profiler.Capacity} profiled slots");
+                }
+
+                return profiler.Snapshot((MethodProfile*)outProfilesPtr, capacity, DescribeMethod);
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"GetProfile failed: {ex}");
+                return -1;
+            }
+        }
+
+        // Starts recording managed trace events (see Tracer) into per-thread buffers of eventsPerThread
+        // events. currentThreadId (uint32_t()) and nameThread (void(uint32_t, const char *)) are the
+        // host's, so managed events land on the same thread tracks as native ones.
+        [UnmanagedCallersOnly]
+        public static int StartTrace(int eventsPerThread, IntPtr currentThreadId, IntPtr nameThread)
+        {
+            try
+            {
+                Tracer.Start(eventsPerThread, currentThreadId, nameThread);
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"StartTrace failed: {ex}");
+                return 0;
+            }
+        }
+
+        [UnmanagedCallersOnly]
+        public static void StopTrace()
+        {
+            Tracer.Stop();
+        }
+
+        // Moves up to capacity recorded events to outEventsPtr (MochiSharp::TraceEvent[]). Invoke events
+        // get a name id for GetTraceName. Returns the number written, -1 on error.
+        [UnmanagedCallersOnly]
+        public static unsafe int DrainTrace(IntPtr outEventsPtr, int capacity)
+        {
+            try
+            {
+                return Tracer.Drain((TraceEvent*)outEventsPtr, capacity, DescribeMethod);
+            }
+            catch (Exception ex)
+            {
+                Logger.Write(LogLevel.Error, LogCategory.Core, $"DrainTrace failed: {ex}");
+                return -1;
+            }
+        }
+
+        // Writes the UTF-8 name for a trace name id to bufferPtr (null-terminated, truncated to size).
+        // Returns the name's full length in bytes, -1 for an unknown id.
+        [UnmanagedCallersOnly]
+        public static unsafe int GetTraceName(int id, IntPtr bufferPtr, int size)
+        {
+            return Tracer.GetName(id, (byte*)bufferPtr, size);
+        }
+
         // Back-compat: previous API used by older native hosts.
         [UnmanagedCallersOnly]
         public static int LoadGameAssembly(IntPtr assemblyPathPtr)
@@ -0,0 +1,212 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Numerics;
+using System.Reflection;
+using System.Runtime.InteropServices;
+using System.Text.Unicode;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// One method handle's counters (layout matches MochiSharp::MethodProfile).
+	[StructLayout(LayoutKind.Sequential)]
+	public unsafe struct MethodProfile
+	{
+		public const int HistogramBuckets = 32;
+		public const int NameLength = 128;
+
+		public int Method;
+		public int Failed;
+		public long Calls;
+		public long TotalNs;
+		public long MaxNs;
+		public long AllocatedBytes;
+		public fixed long Histogram[HistogramBuckets];
+		public fixed byte Name[NameLength];
+	}
+
+	// Opt-in counters for calls made through method handles (Invoke, InvokeOn and the batches; direct
+	// pointers bypass it). Counters live in one preallocated array with a row per handle slot, updated
+	// with interlocked adds, so recording takes no lock and does not allocate (beyond naming a row on
+	// its first call). Handles whose slot index is past the capacity are only counted as dropped.
+	// Histogram bucket b counts calls that took [2^b, 2^(b+1)) ns. Allocations are per thread, so they
+	// include whatever the script allocates on the calling thread, nested invokes included. Each row
+	// keeps the name of the method that claimed it, so handles unbound before a snapshot keep theirs.
+	internal sealed class CallProfiler
+	{
+		// Row layout in _rows; the histogram follows the fixed fields.
+		private const int HandleField = 0;
+		private const int CallsField = 1;
+		private const int FailedField = 2;
+		private const int TicksField = 3;
+		private const int MaxTicksField = 4;
+		private const int AllocatedField = 5;
+		private const int HistogramField = 6;
+		private const int RowSize = HistogramField + MethodProfile.HistogramBuckets;
+
+		private static CallProfiler? _active;
+
+		private readonly long[] _rows;
+		private readonly string?[] _names;
+		private readonly int _capacity;
+		private readonly double _nsPerTick = 1_000_000_000.0 / Stopwatch.Frequency;
+		private long _dropped;
+
+		// Read once per call on the invoke path; null while profiling is off.
+		public static CallProfiler? Active => Volatile.Read(ref _active);
+		// The last profiler started, kept after Stop so it can still be read.
+		public static CallProfiler? Last { get; private set; }
+
+		private CallProfiler(int capacity)
+		{
+			_capacity = Math.Clamp(capacity, 1, HandleTable<object>.MaxSlots);
+			_rows = new long[_capacity * RowSize];
+			_names = new string?[_capacity];
+		}
+
+		public int Capacity => _capacity;
+		public long Dropped => Interlocked.Read(ref _dropped);
+
+		// Starts a fresh profile, replacing any running one.
+		public static void Start(int capacity)
+		{
+			var profiler = new CallProfiler(capacity);
+			Last = profiler;
+			Volatile.Write(ref _active, profiler);
+			Logger.Write(LogLevel.Info, LogCategory.Core, $"Call profiler started for {profiler._capacity} method slots");
+		}
+
+		public static void Stop()
+		{
+			Volatile.Write(ref _active, null);
+		}
+
+		// A new binding took this handle's slot; counters left by an earlier handle in it are cleared.
+		// Called under the context's write lock, before the handle is returned to native code.
+		public void Claim(int methodId, MethodInfo method)
+		{
+			int slot = methodId & (HandleTable<object>.MaxSlots - 1);
+			if (slot >= _capacity)
+			{
+				return;
+			}
+
+			int row = slot * RowSize;
+			Array.Clear(_rows, row, RowSize);
+			Volatile.Write(ref _names[slot], ScriptContext.DescribeMethod(method));
+			Volatile.Write(ref _rows[row + HandleField], methodId);
+		}
+
+		public void Invoke(int methodId, MethodInfo method, InvokeThunk thunk, object? target, IntPtr argsPtr, IntPtr returnPtr)
+		{
+			long allocated = GC.GetAllocatedBytesForCurrentThread();
+			long start = Stopwatch.GetTimestamp();
+			bool failed = true;
+			try
+			{
+				thunk(target, argsPtr, returnPtr);
+				failed = false;
+			}
+			finally
+			{
+				long ticks = Stopwatch.GetTimestamp() - start;
+				Record(methodId, method, ticks, GC.GetAllocatedBytesForCurrentThread() - allocated, failed);
+			}
+		}
+
+		private void Record(int methodId, MethodInfo method, long ticks, long allocated, bool failed)
+		{
+			int slot = methodId & (HandleTable<object>.MaxSlots - 1);
+			if (slot >= _capacity)
+			{
+				Interlocked.Increment(ref _dropped);
+				return;
+			}
+
+			int row = slot * RowSize;
+			// Bound before profiling started: the row is still unowned and the first call takes it.
+			long owner = Volatile.Read(ref _rows[row + HandleField]);
+			if (owner != methodId)
+			{
+				if (owner != 0 || Interlocked.CompareExchange(ref _rows[row + HandleField], methodId, 0) != 0)
+				{
+					Interlocked.Increment(ref _dropped);
+					return;
+				}
+
+				Volatile.Write(ref _names[slot], ScriptContext.DescribeMethod(method));
+			}
+
+			Interlocked.Increment(ref _rows[row + CallsField]);
+			if (failed)
+			{
+				Interlocked.Increment(ref _rows[row + FailedField]);
+			}
+			Interlocked.Add(ref _rows[row + TicksField], ticks);
+			Interlocked.Add(ref _rows[row + AllocatedField], allocated);
+
+			long max = Volatile.Read(ref _rows[row + MaxTicksField]);
+			while (ticks > max)
+			{
+				long seen = Interlocked.CompareExchange(ref _rows[row + MaxTicksField], ticks, max);
+				if (seen == max)
+				{
+					break;
+				}
+				max = seen;
+			}
+
+			long ns = (long)(ticks * _nsPerTick);
+			int bucket = ns <= 1 ? 0 : Math.Min(BitOperations.Log2((ulong)ns), MethodProfile.HistogramBuckets - 1);
+			Interlocked.Increment(ref _rows[row + HistogramField + bucket]);
+		}
+
+		// Copies every method with at least one call to output, busiest (by total time) first, naming
+		// each as it was when its row was claimed, or with describe(handle) if that name is not in yet.
+		// Returns how many there are, which may exceed capacity. Counters keep running while this reads
+		// them, so a row may be a few calls out of step with itself.
+		public unsafe int Snapshot(MethodProfile* output, int capacity, Func<int, string?> describe)
+		{
+			var rows = new List<int>();
+			for (int slot = 0; slot < _capacity; slot++)
+			{
+				if (Volatile.Read(ref _rows[slot * RowSize + CallsField]) > 0)
+				{
+					rows.Add(slot * RowSize);
+				}
+			}
+			rows.Sort((a, b) => Volatile.Read(ref _rows[b + TicksField]).CompareTo(Volatile.Read(ref _rows[a + TicksField])));
+
+			int count = Math.Min(rows.Count, Math.Max(capacity, 0));
+			for (int i = 0; i < count; i++)
+			{
+				int row = rows[i];
+				MethodProfile* profile = &output[i];
+				*profile = default;
+				profile->Method = (int)Volatile.Read(ref _rows[row + HandleField]);
+				profile->Calls = Volatile.Read(ref _rows[row + CallsField]);
+				profile->Failed = (int)Volatile.Read(ref _rows[row + FailedField]);
+				profile->TotalNs = (long)(Volatile.Read(ref _rows[row + TicksField]) * _nsPerTick);
+				profile->MaxNs = (long)(Volatile.Read(ref _rows[row + MaxTicksField]) * _nsPerTick);
+				profile->AllocatedBytes = Volatile.Read(ref _rows[row + AllocatedField]);
+				for (int b = 0; b < MethodProfile.HistogramBuckets; b++)
+				{
+					profile->Histogram[b] = Volatile.Read(ref _rows[row + HistogramField + b]);
+				}
+
+				string name = Volatile.Read(ref _names[row / RowSize]) ?? describe(profile->Method) ?? $"(unbound method {profile->Method})";
+				WriteName(name, new Span<byte>(profile->Name, MethodProfile.NameLength));
+			}
+
+			return rows.Count;
+		}
+
+		// UTF-8, null-terminated, truncated to fit on a character boundary.
+		private static void WriteName(string name, Span<byte> destination)
+		{
+			Utf8.FromUtf16(name, destination[..^1], out _, out int written);
+			destination[written] = 0;
+		}
+	}
+}
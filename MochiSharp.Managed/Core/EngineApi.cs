@@ -0,0 +1,74 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Managed.Core
+{
+	// Layout matches MochiSharp::EngineApiHeader.
+	[StructLayout(LayoutKind.Sequential)]
+	public struct EngineApiHeader
+	{
+		public uint Version;
+		public uint Size;
+	}
+
+	// The engine's callback table (DotNetHost::SetEngineApi). Scripts use the facade generated from the
+	// engine's definition by Tools/engine-api.lua, which keeps the typed table in a static readonly
+	// field: a call is then one load and an indirect call.
+	public static unsafe class EngineApi
+	{
+		private static EngineApiHeader* _table;
+		// Zero-padded copies of a table older than the facade, by facade size.
+		private static readonly Dictionary<int, IntPtr> _padded = new();
+		private static readonly object _lock = new();
+
+		internal static void Attach(IntPtr table)
+		{
+			_table = (EngineApiHeader*)table;
+			if (_table != null)
+			{
+				Logger.Write(LogLevel.Info, LogCategory.Core, $"Engine API v{_table->Version} attached ({_table->Size} bytes)");
+			}
+		}
+
+		public static bool IsAttached => _table != null;
+		public static uint Version => _table != null ? _table->Version : 0;
+		public static uint Size => _table != null ? _table->Size : 0;
+
+		// The table as T, whose first field must be an EngineApiHeader; null if the engine passed none
+		// or its version differs. If the engine's table is older (smaller) than T, this is a zero-padded
+		// copy, so the entries it lacks read as null instead of past its end.
+		public static T* Get<T>(uint version) where T : unmanaged
+		{
+			EngineApiHeader* table = _table;
+			if (table == null)
+			{
+				return null;
+			}
+
+			if (table->Version != version || table->Size < sizeof(EngineApiHeader))
+			{
+				Logger.Write(LogLevel.Error, LogCategory.Core, $"{typeof(T).Name} expects engine API v{version}; the engine has v{table->Version}");
+				return null;
+			}
+
+			if (table->Size >= sizeof(T))
+			{
+				return (T*)table;
+			}
+
+			lock (_lock)
+			{
+				if (!_padded.TryGetValue(sizeof(T), out IntPtr copy))
+				{
+					copy = (IntPtr)NativeMemory.AllocZeroed((nuint)sizeof(T));
+					Buffer.MemoryCopy(table, (void*)copy, sizeof(T), table->Size);
+					_padded.Add(sizeof(T), copy);
+					Logger.Write(LogLevel.Warning, LogCategory.Core, $"Engine API is older than {typeof(T).Name} ({table->Size} of {sizeof(T)} bytes); newer entries are unavailable");
+				}
+
+				return (T*)copy;
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Slot indices and generations behind one or more HandleTables. Tables that share a space hand out
+	// disjoint handles, and the space remembers the owner each slot was last allocated for, so a handle
+	// alone says which table it belongs to: every ScriptContext allocates from Instances and Methods,
+	// and Bootstrap routes a call to the context that owns its handle.
+	//
+	// Threading: Allocate and Free lock, so tables guarded by different locks can share a space.
+	// OwnerOf takes no lock.
+	internal sealed class HandleSpace
+	{
+		public const int IndexBits = 20;
+		public const int MaxSlots = 1 << IndexBits;
+		public const int IndexMask = MaxSlots - 1;
+		private const int MaxGeneration = (1 << (31 - IndexBits)) - 1;
+
+		public static readonly HandleSpace Instances = new();
+		public static readonly HandleSpace Methods = new();
+
+		private readonly object _lock = new();
+		private int[] _generations = new int[64];
+		// Replaced, never resized in place, so OwnerOf can read a snapshot.
+		private int[] _owners = new int[64];
+		private int _slotCount;
+		private readonly Queue<int> _freeSlots = new();
+
+		public int Allocate(int owner)
+		{
+			lock (_lock)
+			{
+				int index;
+				if (!_freeSlots.TryDequeue(out index))
+				{
+					if (_slotCount == MaxSlots)
+					{
+						throw new InvalidOperationException($"Handle table is full ({MaxSlots} live entries)");
+					}
+
+					index = _slotCount++;
+					if (index == _generations.Length)
+					{
+						int capacity = Math.Min(_generations.Length * 2, MaxSlots);
+						var owners = new int[capacity];
+						Array.Copy(_owners, owners, index);
+						Volatile.Write(ref _owners, owners);
+						Array.Resize(ref _generations, capacity);
+					}
+
+					_generations[index] = 1;
+				}
+
+				// Written before the handle is returned, so whoever holds the handle sees its owner.
+				Volatile.Write(ref _owners[index], owner);
+				return (_generations[index] << IndexBits) | index;
+			}
+		}
+
+		// Bumps the slot's generation, so the handle is rejected from now on, and queues it for reuse
+		// oldest first to push the generation wrap-around as far out as possible.
+		public void Free(int handle)
+		{
+			int index = handle & IndexMask;
+			lock (_lock)
+			{
+				_generations[index] = _generations[index] == MaxGeneration ? 1 : _generations[index] + 1;
+				_freeSlots.Enqueue(index);
+			}
+		}
+
+		// The owner the handle's slot was last allocated for, 0 if none. The handle itself may be stale;
+		// the owner's table rejects it then.
+		public int OwnerOf(int handle)
+		{
+			int[] owners = Volatile.Read(ref _owners);
+			int index = handle & IndexMask;
+			return handle > 0 && index < owners.Length ? Volatile.Read(ref owners[index]) : 0;
+		}
+	}
+}
@@ -0,0 +1,156 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Dense slot table addressed by generational 32-bit handles (layout matches MochiSharp::Handle):
+	// - bits 0..19: slot index
+	// - bits 20..30: generation, 1..2047, bumped each time the slot is freed
+	// 0 is never a valid handle. Lookups are a bounds check plus a generation compare, and a handle
+	// to a freed slot is detected until the slot's generation wraps around. Slots come from a
+	// HandleSpace, which tables may share to keep their handles apart (see HandleSpace).
+	//
+	// Threading: lookups are lock-free and may run on any thread while one writer adds or removes.
+	// Each live slot holds an immutable entry that is published with a single reference store, so a
+	// reader sees either the whole entry or none of it. Callers serialize Add/Remove/Clear themselves.
+	internal sealed class HandleTable<T>
+	{
+		public const int IndexBits = HandleSpace.IndexBits;
+		public const int MaxSlots = HandleSpace.MaxSlots;
+		private const int IndexMask = HandleSpace.IndexMask;
+
+		private sealed class Entry
+		{
+			public readonly int Handle;
+			public readonly T Value;
+
+			public Entry(int handle, T value)
+			{
+				Handle = handle;
+				Value = value;
+			}
+		}
+
+		// Replaced, never resized in place, so readers can hold on to a snapshot. Indexed by slot, so in
+		// a shared space it also covers slots other tables own.
+		private Entry?[] _entries;
+		private readonly HandleSpace _space;
+		private readonly int _owner;
+		// Writer-only state: every live slot is below it.
+		private int _slotLimit;
+		private int _count;
+
+		public HandleTable(int initialCapacity = 64)
+			: this(new HandleSpace(), 0, initialCapacity)
+		{
+		}
+
+		// owner is what HandleSpace.OwnerOf reports for this table's handles.
+		public HandleTable(HandleSpace space, int owner, int initialCapacity = 64)
+		{
+			_entries = new Entry?[initialCapacity];
+			_space = space;
+			_owner = owner;
+		}
+
+		public int Count => Volatile.Read(ref _count);
+
+		public int Add(T value)
+		{
+			int handle = _space.Allocate(_owner);
+			int index = handle & IndexMask;
+			if (index >= _entries.Length)
+			{
+				int capacity = Math.Min(Math.Max(_entries.Length * 2, (int)BitOperations.RoundUpToPowerOf2((uint)index + 1)), MaxSlots);
+				var entries = new Entry?[capacity];
+				Array.Copy(_entries, entries, _slotLimit);
+				Volatile.Write(ref _entries, entries);
+			}
+
+			_slotLimit = Math.Max(_slotLimit, index + 1);
+			Volatile.Write(ref _entries[index], new Entry(handle, value));
+			Volatile.Write(ref _count, _count + 1);
+			return handle;
+		}
+
+		public bool TryGetValue(int handle, out T value)
+		{
+			Entry?[] entries = Volatile.Read(ref _entries);
+			int index = handle & IndexMask;
+			if (handle > 0 && index < entries.Length)
+			{
+				Entry? entry = Volatile.Read(ref entries[index]);
+				if (entry != null && entry.Handle == handle)
+				{
+					value = entry.Value;
+					return true;
+				}
+			}
+
+			value = default!;
+			return false;
+		}
+
+		public bool Contains(int handle) => TryGetValue(handle, out _);
+
+		public bool Remove(int handle, out T value)
+		{
+			if (!TryGetValue(handle, out value))
+			{
+				return false;
+			}
+
+			Volatile.Write(ref _entries[handle & IndexMask], null);
+			_space.Free(handle);
+			Volatile.Write(ref _count, _count - 1);
+			return true;
+		}
+
+		// Swaps the value behind a live handle; the handle stays valid.
+		public bool Replace(int handle, T value)
+		{
+			if (!Contains(handle))
+			{
+				return false;
+			}
+
+			Volatile.Write(ref _entries[handle & IndexMask], new Entry(handle, value));
+			return true;
+		}
+
+		// Frees every live handle; they are rejected from now on.
+		public void Clear()
+		{
+			// Unpublish first: once freed, a slot may go to another table sharing the space.
+			Entry?[] entries = _entries;
+			Volatile.Write(ref _entries, new Entry?[entries.Length]);
+			for (int i = 0; i < _slotLimit; i++)
+			{
+				Entry? entry = entries[i];
+				if (entry != null)
+				{
+					_space.Free(entry.Handle);
+				}
+			}
+
+			_slotLimit = 0;
+			Volatile.Write(ref _count, 0);
+		}
+
+		// Writer-side enumeration.
+		public IEnumerable<KeyValuePair<int, T>> Entries()
+		{
+			Entry?[] entries = _entries;
+			for (int i = 0; i < _slotLimit; i++)
+			{
+				Entry? entry = entries[i];
+				if (entry != null)
+				{
+					yield return new KeyValuePair<int, T>(entry.Handle, entry.Value);
+				}
+			}
+		}
+	}
+}
@@ -4,24 +4,28 @@ using System.Runtime.InteropServices;
 namespace MochiSharp.Managed.Core
 {
     // Wrapper for calling back into C++
-    public class HostHook
+    public unsafe class HostHook
     {
         private readonly Bootstrap.EngineInterface _api;
 
-        // Define the delegate signature matching the C++ function
-        private delegate void LogDelegate(IntPtr message);
-        private readonly LogDelegate _logNative;
+        // EngineInterface::LogFunc, called directly instead of through a marshaling delegate
+        private readonly delegate* unmanaged[Cdecl]<byte*, void> _logNative;
 
         public HostHook(Bootstrap.EngineInterface api)
         {
             _api = api;
-            _logNative = Marshal.GetDelegateForFunctionPointer<LogDelegate>(_api.LogMessage);
+            _logNative = (delegate* unmanaged[Cdecl]<byte*, void>)_api.LogMessage;
         }
 
         public void Log(string message)
         {
+            if (_logNative == null)
+            {
+                return;
+            }
+
             IntPtr ptr = Marshal.StringToCoTaskMemUTF8(message);
-            _logNative(ptr);
+            _logNative((byte*)ptr);
             Marshal.FreeCoTaskMem(ptr);
         }
     }
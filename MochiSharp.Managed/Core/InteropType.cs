@@ -0,0 +1,85 @@
+using System;
+using System.Reflection;
+
+namespace MochiSharp.Managed.Core
+{
+	// How a signature type crosses the native boundary.
+	internal enum InteropKind
+	{
+		Void,
+		Int32,
+		Single,
+		Boolean,  // int32 0/1 on the native side
+		Blittable // read/written in place, same layout on both sides
+	}
+
+	internal static class InteropType
+	{
+		// Classifies a signature type once, at RegisterSignature time.
+		// Throws NotSupportedException for types that would need the layout-aware marshaler.
+		public static InteropKind Classify(Type type)
+		{
+			if (type == typeof(void))
+			{
+				return InteropKind.Void;
+			}
+			if (type == typeof(int))
+			{
+				return InteropKind.Int32;
+			}
+			if (type == typeof(float))
+			{
+				return InteropKind.Single;
+			}
+			if (type == typeof(bool))
+			{
+				return InteropKind.Boolean;
+			}
+
+			if (!IsBlittable(type, out string reason))
+			{
+				throw new NotSupportedException($"Type {type.FullName} cannot cross the native boundary: {reason}. Only blittable types (primitives and sequential/explicit structs of them) are supported.");
+			}
+
+			return InteropKind.Blittable;
+		}
+
+		private static bool IsBlittable(Type type, out string reason)
+		{
+			reason = string.Empty;
+			if (type == typeof(bool) || type == typeof(char))
+			{
+				reason = $"{type.Name} has no fixed native size";
+				return false;
+			}
+
+			if (type.IsPrimitive || type.IsEnum)
+			{
+				return true;
+			}
+
+			if (!type.IsValueType)
+			{
+				reason = $"{type.Name} is a reference type";
+				return false;
+			}
+
+			if (type.IsAutoLayout)
+			{
+				reason = $"{type.Name} has auto layout";
+				return false;
+			}
+
+			foreach (var field in type.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic))
+			{
+				if (!IsBlittable(field.FieldType, out string fieldReason))
+				{
+					reason = $"field {type.Name}.{field.Name}: {fieldReason}";
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+}
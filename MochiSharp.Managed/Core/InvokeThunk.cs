@@ -0,0 +1,166 @@
+using System;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Specialized invoker for one bound method.
+	// argsPtr points to an array of IntPtr (one per parameter), returnPtr receives the result.
+	// See Bootstrap.Invoke for the pointer conventions.
+	internal delegate void InvokeThunk(object? target, IntPtr argsPtr, IntPtr returnPtr);
+
+	// How new method handle bindings call their method (values match MochiSharp::InvokeMode).
+	internal enum InvokeMode
+	{
+		Compiled = 0,   // a compiled thunk per method, no boxing or allocation
+		Reflection = 1, // MethodInfo.Invoke with boxed arguments; kept for comparison
+	}
+
+	internal static unsafe class InvokeThunkCompiler
+	{
+		private static int _mode;
+
+		// Read when a method handle is bound; existing bindings keep their thunk.
+		public static InvokeMode Mode
+		{
+			get => (InvokeMode)Volatile.Read(ref _mode);
+			set => Volatile.Write(ref _mode, (int)value);
+		}
+
+		private static readonly MethodInfo s_readInt32 = GetHelper(nameof(ReadInt32));
+		private static readonly MethodInfo s_readSingle = GetHelper(nameof(ReadSingle));
+		private static readonly MethodInfo s_readBoolean = GetHelper(nameof(ReadBoolean));
+		private static readonly MethodInfo s_readUnmanaged = GetHelper(nameof(ReadUnmanaged));
+
+		private static readonly MethodInfo s_writeInt32 = GetHelper(nameof(WriteInt32));
+		private static readonly MethodInfo s_writeSingle = GetHelper(nameof(WriteSingle));
+		private static readonly MethodInfo s_writeBoolean = GetHelper(nameof(WriteBoolean));
+		private static readonly MethodInfo s_writeUnmanaged = GetHelper(nameof(WriteUnmanaged));
+
+		// Builds: (target, args, ret) => Write<R>(ret, ((T)target).Method(Read<A0>(args, 0), ...))
+		// Arguments are read straight from the native pointer array and the result is written
+		// straight to returnPtr, so a call does not box or allocate.
+		// Kinds come from InteropType.Classify, so every type reaching here is known to be blittable.
+		public static InvokeThunk Compile(MethodInfo method, Type returnType, InteropKind returnKind, Type[] parameterTypes, InteropKind[] parameterKinds)
+		{
+			var target = Expression.Parameter(typeof(object), "target");
+			var argsPtr = Expression.Parameter(typeof(IntPtr), "argsPtr");
+			var returnPtr = Expression.Parameter(typeof(IntPtr), "returnPtr");
+
+			var args = new Expression[parameterTypes.Length];
+			for (int i = 0; i < parameterTypes.Length; i++)
+			{
+				args[i] = Expression.Call(GetReader(parameterTypes[i], parameterKinds[i]), argsPtr, Expression.Constant(i));
+			}
+
+			Expression? instance = null;
+			if (!method.IsStatic)
+			{
+				Type declaringType = method.DeclaringType
+					?? throw new InvalidOperationException($"Method has no declaring type: {method.Name}");
+				instance = Expression.Convert(target, declaringType);
+			}
+
+			Expression body = Expression.Call(instance, method, args);
+			if (returnKind != InteropKind.Void)
+			{
+				body = Expression.Call(GetWriter(returnType, returnKind), returnPtr, body);
+			}
+
+			var lambda = Expression.Lambda<InvokeThunk>(body, $"Invoke_{method.DeclaringType?.Name}_{method.Name}", new[] { target, argsPtr, returnPtr });
+			return lambda.Compile();
+		}
+
+		// The pre-thunk path: arguments are boxed into an object[] and the call goes through MethodInfo.Invoke,
+		// so every call allocates.
+		public static InvokeThunk CreateReflectionInvoker(MethodInfo method, Type returnType, InteropKind returnKind, Type[] parameterTypes, InteropKind[] parameterKinds)
+		{
+			return (target, argsPtr, returnPtr) =>
+			{
+				object?[] args = parameterTypes.Length == 0 ? Array.Empty<object?>() : new object?[parameterTypes.Length];
+				for (int i = 0; i < args.Length; i++)
+				{
+					IntPtr argument = (IntPtr)GetArgument(argsPtr, i);
+					args[i] = parameterKinds[i] switch
+					{
+						InteropKind.Int32 => Marshal.ReadInt32(argument),
+						InteropKind.Single => Marshal.PtrToStructure<float>(argument),
+						InteropKind.Boolean => Marshal.ReadInt32(argument) != 0,
+						_ => Marshal.PtrToStructure(argument, parameterTypes[i]),
+					};
+				}
+
+				object? result = method.Invoke(target, args);
+				switch (returnKind)
+				{
+					case InteropKind.Void:
+						break;
+					case InteropKind.Int32:
+						Marshal.WriteInt32(returnPtr, (int)result!);
+						break;
+					case InteropKind.Single:
+						*(float*)returnPtr = (float)result!;
+						break;
+					case InteropKind.Boolean:
+						Marshal.WriteInt32(returnPtr, (bool)result! ? 1 : 0);
+						break;
+					default:
+						Marshal.StructureToPtr(result!, returnPtr, fDeleteOld: false);
+						break;
+				}
+			};
+		}
+
+		private static MethodInfo GetReader(Type type, InteropKind kind)
+		{
+			return kind switch
+			{
+				InteropKind.Int32 => s_readInt32,
+				InteropKind.Single => s_readSingle,
+				InteropKind.Boolean => s_readBoolean,
+				InteropKind.Blittable => s_readUnmanaged.MakeGenericMethod(type),
+				_ => throw new NotSupportedException($"Unsupported parameter type: {type}")
+			};
+		}
+
+		private static MethodInfo GetWriter(Type type, InteropKind kind)
+		{
+			return kind switch
+			{
+				InteropKind.Int32 => s_writeInt32,
+				InteropKind.Single => s_writeSingle,
+				InteropKind.Boolean => s_writeBoolean,
+				InteropKind.Blittable => s_writeUnmanaged.MakeGenericMethod(type),
+				_ => throw new NotSupportedException($"Unsupported return type: {type}")
+			};
+		}
+
+		private static MethodInfo GetHelper(string name)
+		{
+			return typeof(InvokeThunkCompiler).GetMethod(name, BindingFlags.Static | BindingFlags.NonPublic)
+				?? throw new MissingMethodException(nameof(InvokeThunkCompiler), name);
+		}
+
+		private static void* GetArgument(IntPtr argsPtr, int index) => ((void**)argsPtr)[index];
+
+		private static int ReadInt32(IntPtr argsPtr, int index) => *(int*)GetArgument(argsPtr, index);
+
+		private static float ReadSingle(IntPtr argsPtr, int index) => *(float*)GetArgument(argsPtr, index);
+
+		// bool is passed as int32 (0/1).
+		private static bool ReadBoolean(IntPtr argsPtr, int index) => *(int*)GetArgument(argsPtr, index) != 0;
+
+		private static T ReadUnmanaged<T>(IntPtr argsPtr, int index) where T : unmanaged => Unsafe.ReadUnaligned<T>(GetArgument(argsPtr, index));
+
+		private static void WriteInt32(IntPtr returnPtr, int value) => *(int*)returnPtr = value;
+
+		private static void WriteSingle(IntPtr returnPtr, float value) => *(float*)returnPtr = value;
+
+		private static void WriteBoolean(IntPtr returnPtr, bool value) => *(int*)returnPtr = value ? 1 : 0;
+
+		private static void WriteUnmanaged<T>(IntPtr returnPtr, T value) where T : unmanaged => Unsafe.WriteUnaligned((void*)returnPtr, value);
+	}
+}
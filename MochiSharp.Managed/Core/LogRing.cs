@@ -0,0 +1,156 @@
+using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	public enum LogLevel
+	{
+		Trace = 0,
+		Debug = 1,
+		Info = 2,
+		Warning = 3,
+		Error = 4,
+		None = 5
+	}
+
+	// Matches MochiSharp::LogCategory.
+	[Flags]
+	public enum LogCategory : uint
+	{
+		Host = 1u << 0,
+		Core = 1u << 1,
+		Script = 1u << 2,
+		Console = 1u << 3,
+		All = 0xFFFFFFFFu
+	}
+
+	// Layout matches MochiSharp::LogRingHeader; Head and Tail sit on their own cache lines.
+	[StructLayout(LayoutKind.Explicit, Size = 192)]
+	internal struct LogRingHeader
+	{
+		[FieldOffset(0)] public uint Capacity;
+		[FieldOffset(4)] public int MinLevel;
+		[FieldOffset(8)] public uint CategoryMask;
+		[FieldOffset(12)] public uint MaxMessageBytes;
+		[FieldOffset(16)] public IntPtr Data;
+		[FieldOffset(24)] public long Dropped;
+		[FieldOffset(64)] public long Head;
+		[FieldOffset(128)] public long Tail;
+	}
+
+	// Producer side of the native log ring. Writers never block: a full ring drops the message.
+	// The reserve/publish protocol is the same as LogPipeline::Write in MochiSharp.Native.
+	internal sealed unsafe class LogRing
+	{
+		private const int RecordHeaderSize = 16;
+		private const int RecordAlignment = 16;
+		private const byte PaddingFlag = 1;
+
+		private readonly LogRingHeader* _header;
+		private readonly byte* _data;
+		private readonly uint _capacity;
+		private readonly int _maxMessageBytes;
+
+		public LogRing(IntPtr header)
+		{
+			_header = (LogRingHeader*)header;
+			_data = (byte*)_header->Data;
+			_capacity = _header->Capacity;
+			_maxMessageBytes = (int)_header->MaxMessageBytes;
+		}
+
+		[MethodImpl(MethodImplOptions.AggressiveInlining)]
+		public bool IsEnabled(LogLevel level, LogCategory category)
+		{
+			return (int)level >= Volatile.Read(ref _header->MinLevel)
+				&& (Volatile.Read(ref _header->CategoryMask) & (uint)category) != 0;
+		}
+
+		// Encodes text straight into the ring. The caller has already checked IsEnabled.
+		public bool Write(LogLevel level, LogCategory category, ReadOnlySpan<char> text)
+		{
+			int length = Encoding.UTF8.GetByteCount(text);
+			if (length > _maxMessageBytes)
+			{
+				// Keep whole characters; UTF-8 needs at most 3 bytes per UTF-16 char.
+				text = text.Slice(0, Math.Min(text.Length, _maxMessageBytes / 3));
+				length = Encoding.UTF8.GetByteCount(text);
+			}
+
+			byte* record = Reserve(RecordSize(length));
+			if (record == null)
+			{
+				Interlocked.Increment(ref _header->Dropped);
+				return false;
+			}
+
+			Encoding.UTF8.GetBytes(text, new Span<byte>(record + RecordHeaderSize, length));
+			Publish(record, level, category, length);
+			return true;
+		}
+
+		public bool WriteUtf8(LogLevel level, LogCategory category, ReadOnlySpan<byte> text)
+		{
+			if (text.Length > _maxMessageBytes)
+			{
+				text = text.Slice(0, _maxMessageBytes);
+			}
+
+			byte* record = Reserve(RecordSize(text.Length));
+			if (record == null)
+			{
+				Interlocked.Increment(ref _header->Dropped);
+				return false;
+			}
+
+			text.CopyTo(new Span<byte>(record + RecordHeaderSize, text.Length));
+			Publish(record, level, category, text.Length);
+			return true;
+		}
+
+		private static uint RecordSize(int length) => (uint)((RecordHeaderSize + length + RecordAlignment - 1) & ~(RecordAlignment - 1));
+
+		private static void Publish(byte* record, LogLevel level, LogCategory category, int length)
+		{
+			record[4] = (byte)level;
+			record[5] = 0;
+			*(ushort*)(record + 6) = (ushort)length;
+			*(uint*)(record + 8) = (uint)category;
+			Volatile.Write(ref *(uint*)record, RecordSize(length));
+		}
+
+		private byte* Reserve(uint size)
+		{
+			uint mask = _capacity - 1;
+			long current = Volatile.Read(ref _header->Head);
+			while (true)
+			{
+				uint offset = (uint)current & mask;
+				uint padding = offset + size > _capacity ? _capacity - offset : 0;
+				if (current + padding + size - Volatile.Read(ref _header->Tail) > _capacity)
+				{
+					return null;
+				}
+
+				long observed = Interlocked.CompareExchange(ref _header->Head, current + padding + size, current);
+				if (observed != current)
+				{
+					current = observed;
+					continue;
+				}
+
+				if (padding != 0)
+				{
+					byte* filler = _data + offset;
+					filler[5] = PaddingFlag;
+					Volatile.Write(ref *(uint*)filler, padding);
+				}
+
+				return _data + (((uint)current + padding) & mask);
+			}
+		}
+	}
+}
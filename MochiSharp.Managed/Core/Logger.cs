@@ -0,0 +1,287 @@
+using System;
+using System.Buffers;
+using System.IO;
+using System.Runtime.CompilerServices;
+using System.Text;
+
+namespace MochiSharp.Managed.Core
+{
+	// Logging for the core and scripts. When the host shares a log ring, messages are encoded straight
+	// into it and printed by the host's drain thread, so the caller never waits on stdout.
+	// Otherwise they go synchronously through EngineInterface.LogMessage.
+	public static class Logger
+	{
+		private static LogRing? _ring;
+		private static HostHook? _hostHook;
+
+		// Minimum level when there is no ring; with a ring the host owns the filters.
+		public static LogLevel FallbackMinLevel { get; set; } = LogLevel.Info;
+
+		internal static bool HasRing => _ring != null;
+
+		internal static void Attach(HostHook? hostHook, LogRing? ring)
+		{
+			_hostHook = hostHook;
+			_ring = ring;
+		}
+
+		public static bool IsEnabled(LogLevel level, LogCategory category)
+		{
+			if ((uint)level >= (uint)LogLevel.None)
+			{
+				return false;
+			}
+
+			LogRing? ring = _ring;
+			if (ring != null)
+			{
+				return ring.IsEnabled(level, category);
+			}
+
+			return _hostHook != null && level >= FallbackMinLevel;
+		}
+
+		public static void Write(LogLevel level, LogCategory category, string message)
+		{
+			if (IsEnabled(level, category))
+			{
+				WriteCore(level, category, message);
+			}
+		}
+
+		// Interpolated messages are only formatted when the level and category pass the filters.
+		public static void Write(LogLevel level, LogCategory category, [InterpolatedStringHandlerArgument("level", "category")] ref LogMessageHandler message)
+		{
+			if (message.Enabled)
+			{
+				WriteCore(level, category, message.Text);
+				message.Dispose();
+			}
+		}
+
+		internal static void WriteCore(LogLevel level, LogCategory category, ReadOnlySpan<char> message)
+		{
+			LogRing? ring = _ring;
+			if (ring != null)
+			{
+				ring.Write(level, category, message);
+				return;
+			}
+
+			string prefix = level switch
+			{
+				LogLevel.Warning => "Warning: ",
+				LogLevel.Error => "Error: ",
+				_ => string.Empty
+			};
+			_hostHook?.Log(string.Concat(prefix, message));
+		}
+	}
+
+	[InterpolatedStringHandler]
+	public ref struct LogMessageHandler
+	{
+		private char[]? _buffer;
+		private int _length;
+
+		public LogMessageHandler(int literalLength, int formattedCount, LogLevel level, LogCategory category, out bool enabled)
+		{
+			enabled = Logger.IsEnabled(level, category);
+			_buffer = enabled ? ArrayPool<char>.Shared.Rent(Math.Max(literalLength + formattedCount * 16, 64)) : null;
+			_length = 0;
+		}
+
+		internal readonly bool Enabled => _buffer != null;
+		internal readonly ReadOnlySpan<char> Text => _buffer.AsSpan(0, _length);
+
+		public void AppendLiteral(string value) => AppendSpan(value);
+
+		public void AppendFormatted(string? value) => AppendSpan(value);
+
+		public void AppendFormatted(ReadOnlySpan<char> value) => AppendSpan(value);
+
+		public void AppendFormatted<T>(T value) => AppendFormatted(value, null);
+
+		public void AppendFormatted<T>(T value, string? format)
+		{
+			if (value is ISpanFormattable)
+			{
+				int written;
+				while (!((ISpanFormattable)value).TryFormat(_buffer.AsSpan(_length), out written, format, null))
+				{
+					Grow(_buffer!.Length);
+				}
+
+				_length += written;
+				return;
+			}
+
+			AppendSpan(value is IFormattable formattable ? formattable.ToString(format, null) : value?.ToString());
+		}
+
+		public void AppendFormatted<T>(T value, int alignment, string? format = null)
+		{
+			int start = _length;
+			AppendFormatted(value, format);
+			int padding = Math.Abs(alignment) - (_length - start);
+			if (padding <= 0)
+			{
+				return;
+			}
+
+			EnsureCapacity(padding);
+			Span<char> buffer = _buffer.AsSpan();
+			if (alignment > 0)
+			{
+				// Right-aligned: shift the value and pad in front.
+				buffer.Slice(start, _length - start).CopyTo(buffer.Slice(start + padding));
+				buffer.Slice(start, padding).Fill(' ');
+			}
+			else
+			{
+				buffer.Slice(_length, padding).Fill(' ');
+			}
+
+			_length += padding;
+		}
+
+		public void Dispose()
+		{
+			char[]? buffer = _buffer;
+			this = default;
+			if (buffer != null)
+			{
+				ArrayPool<char>.Shared.Return(buffer);
+			}
+		}
+
+		private void AppendSpan(ReadOnlySpan<char> value)
+		{
+			EnsureCapacity(value.Length);
+			value.CopyTo(_buffer.AsSpan(_length));
+			_length += value.Length;
+		}
+
+		private void EnsureCapacity(int additional)
+		{
+			if (_buffer!.Length - _length < additional)
+			{
+				Grow(additional);
+			}
+		}
+
+		private void Grow(int additional)
+		{
+			char[] next = ArrayPool<char>.Shared.Rent(Math.Max(_buffer!.Length * 2, _length + additional));
+			_buffer.AsSpan(0, _length).CopyTo(next);
+			ArrayPool<char>.Shared.Return(_buffer);
+			_buffer = next;
+		}
+	}
+
+	// Console.Out/Console.Error replacement installed when the host shares a log ring.
+	// Buffers until a newline and writes each line as one Console-category record.
+	internal sealed class LogTextWriter : TextWriter
+	{
+		private readonly LogLevel _level;
+		private readonly StringBuilder _line = new StringBuilder(256);
+
+		public LogTextWriter(LogLevel level)
+		{
+			_level = level;
+		}
+
+		public override Encoding Encoding => Encoding.UTF8;
+
+		public override void Write(char value)
+		{
+			if (value == '\n')
+			{
+				EmitLine();
+			}
+			else
+			{
+				_line.Append(value);
+			}
+		}
+
+		public override void Write(ReadOnlySpan<char> buffer)
+		{
+			while (!buffer.IsEmpty)
+			{
+				int newline = buffer.IndexOf('\n');
+				if (newline < 0)
+				{
+					_line.Append(buffer);
+					return;
+				}
+
+				if (_line.Length == 0)
+				{
+					// Whole line in one write: skip the builder.
+					Emit(buffer.Slice(0, newline));
+				}
+				else
+				{
+					_line.Append(buffer.Slice(0, newline));
+					EmitLine();
+				}
+
+				buffer = buffer.Slice(newline + 1);
+			}
+		}
+
+		public override void Write(char[] buffer, int index, int count) => Write(buffer.AsSpan(index, count));
+
+		public override void Write(string? value) => Write(value.AsSpan());
+
+		public override void WriteLine(string? value)
+		{
+			Write(value.AsSpan());
+			EmitLine();
+		}
+
+		public override void WriteLine(ReadOnlySpan<char> buffer)
+		{
+			Write(buffer);
+			EmitLine();
+		}
+
+		public override void Flush()
+		{
+			if (_line.Length != 0)
+			{
+				EmitLine();
+			}
+		}
+
+		private void EmitLine()
+		{
+			foreach (ReadOnlyMemory<char> chunk in _line.GetChunks())
+			{
+				if (chunk.Length == _line.Length)
+				{
+					Emit(chunk.Span);
+					_line.Clear();
+					return;
+				}
+			}
+
+			Emit(_line.ToString());
+			_line.Clear();
+		}
+
+		private void Emit(ReadOnlySpan<char> line)
+		{
+			if (line.EndsWith("\r"))
+			{
+				line = line.Slice(0, line.Length - 1);
+			}
+
+			if (Logger.IsEnabled(_level, LogCategory.Console))
+			{
+				Logger.WriteCore(_level, LogCategory.Console, line);
+			}
+		}
+	}
+}
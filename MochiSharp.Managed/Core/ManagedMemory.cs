@@ -0,0 +1,170 @@
+using System;
+using System.Diagnostics;
+using System.Runtime;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Reported to native code by GetManagedMemoryStats (layout matches MochiSharp::ManagedMemoryStats).
+	[StructLayout(LayoutKind.Sequential)]
+	public struct ManagedMemoryStats
+	{
+		public long Gen0Collections;
+		public long Gen1Collections;
+		public long Gen2Collections;
+		public long HeapSizeBytes;
+		public long FragmentedBytes;
+		public long CommittedBytes;
+		public long TotalAllocatedBytes;
+		public long AllocatedBytes;      // since the previous Capture
+		public double TotalPauseMs;
+		public double LastPauseMs;
+		public double PauseTimePercentage;
+		public int InNoGCRegion;
+	}
+
+	// GC counters and no-GC regions for the native host. Independent of the loaded context.
+	internal static class ManagedMemory
+	{
+		// The full blocking collections TryStartNoGCRegion runs, which GC.GetGCMemoryInfo and
+		// GC.GetTotalPauseDuration do not record. Index is the collection count after the last one.
+		private sealed record InducedCollections(long Index, long TotalPauseTicks, long LastPauseTicks, long HeapSizeBytes);
+
+		private static long _lastAllocated;
+		private static int _noGCRegion;
+		private static InducedCollections? _induced;
+		private static DateTime _processStart;
+
+		// Called at startup, so the first AllocatedBytes does not count everything allocated before it.
+		public static void Initialize()
+		{
+			Volatile.Write(ref _lastAllocated, GC.GetTotalAllocatedBytes(precise: false));
+		}
+
+		public static ManagedMemoryStats Capture()
+		{
+			GCMemoryInfo info = GC.GetGCMemoryInfo(GCKind.Any);
+			long allocated = GC.GetTotalAllocatedBytes(precise: false);
+			long previous = Interlocked.Exchange(ref _lastAllocated, allocated);
+
+			TimeSpan lastPause = TimeSpan.Zero;
+			foreach (TimeSpan pause in info.PauseDurations)
+			{
+				lastPause += pause;
+			}
+
+			var stats = new ManagedMemoryStats
+			{
+				Gen0Collections = GC.CollectionCount(0),
+				Gen1Collections = GC.CollectionCount(1),
+				Gen2Collections = GC.CollectionCount(2),
+				HeapSizeBytes = info.HeapSizeBytes,
+				FragmentedBytes = info.FragmentedBytes,
+				CommittedBytes = info.TotalCommittedBytes,
+				TotalAllocatedBytes = allocated,
+				AllocatedBytes = Math.Max(0, allocated - previous),
+				TotalPauseMs = GC.GetTotalPauseDuration().TotalMilliseconds,
+				LastPauseMs = lastPause.TotalMilliseconds,
+				PauseTimePercentage = info.PauseTimePercentage,
+				InNoGCRegion = GCSettings.LatencyMode == GCLatencyMode.NoGCRegion ? 1 : 0,
+			};
+
+			InducedCollections? induced = Volatile.Read(ref _induced);
+			if (induced != null)
+			{
+				stats.TotalPauseMs += Stopwatch.GetElapsedTime(0, induced.TotalPauseTicks).TotalMilliseconds;
+				// The runtime's percentage is its own pause total over its uptime; redo it with both.
+				stats.PauseTimePercentage = 100.0 * stats.TotalPauseMs / (DateTime.Now - _processStart).TotalMilliseconds;
+				if (induced.Index > info.Index)
+				{
+					// Fragmentation and commit stay as of the last collection the runtime recorded.
+					stats.HeapSizeBytes = induced.HeapSizeBytes;
+					stats.LastPauseMs = Stopwatch.GetElapsedTime(0, induced.LastPauseTicks).TotalMilliseconds;
+				}
+			}
+
+			return stats;
+		}
+
+		public static bool BeginNoGCRegion(long totalBytes)
+		{
+			if (Interlocked.CompareExchange(ref _noGCRegion, 1, 0) != 0)
+			{
+				Logger.Write(LogLevel.Warning, LogCategory.Core, "BeginNoGCRegion: a region is already active");
+				return false;
+			}
+
+			try
+			{
+				long collections = GC.CollectionCount(0);
+				long start = Stopwatch.GetTimestamp();
+				bool started = GC.TryStartNoGCRegion(totalBytes);
+				long pauseTicks = Stopwatch.GetTimestamp() - start;
+				if (GC.CollectionCount(0) != collections)
+				{
+					RecordInducedCollection(pauseTicks);
+				}
+
+				if (started)
+				{
+					return true;
+				}
+
+				Logger.Write(LogLevel.Warning, LogCategory.Core, $"BeginNoGCRegion: the GC could not reserve {totalBytes} bytes");
+			}
+			catch (Exception ex) when (ex is ArgumentOutOfRangeException or InvalidOperationException)
+			{
+				Logger.Write(LogLevel.Warning, LogCategory.Core, $"BeginNoGCRegion({totalBytes}) failed: {ex.Message}");
+			}
+
+			Volatile.Write(ref _noGCRegion, 0);
+			return false;
+		}
+
+		// Timed around the TryStartNoGCRegion call, so it includes reserving the budget. Only called with
+		// _noGCRegion taken, so there is one writer.
+		private static void RecordInducedCollection(long pauseTicks)
+		{
+			if (_processStart == default)
+			{
+				_processStart = Process.GetCurrentProcess().StartTime;
+			}
+
+			InducedCollections? previous = _induced;
+			Volatile.Write(ref _induced, new InducedCollections(
+				GC.CollectionCount(0),
+				(previous?.TotalPauseTicks ?? 0) + pauseTicks,
+				pauseTicks,
+				GC.GetTotalMemory(forceFullCollection: false)));
+		}
+
+		// False if no region was active or a collection ended it before this call.
+		public static bool EndNoGCRegion()
+		{
+			if (Interlocked.Exchange(ref _noGCRegion, 0) == 0)
+			{
+				return false;
+			}
+
+			// Allocating past the budget (or GC.Collect) makes the GC collect and leave the region; ending
+			// it then throws, and there is nothing left to end.
+			if (GCSettings.LatencyMode != GCLatencyMode.NoGCRegion)
+			{
+				Logger.Write(LogLevel.Warning, LogCategory.Core, "No-GC region ended early by a collection; scripts allocated more than its budget");
+				return false;
+			}
+
+			try
+			{
+				GC.EndNoGCRegion();
+				return true;
+			}
+			catch (InvalidOperationException ex)
+			{
+				Logger.Write(LogLevel.Warning, LogCategory.Core, $"No-GC region ended early: {ex.Message}");
+				return false;
+			}
+		}
+	}
+}
@@ -0,0 +1,112 @@
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Managed.Core
+{
+	// Counters reported to native code (layout matches MochiSharp::MetadataCacheStats).
+	[StructLayout(LayoutKind.Sequential)]
+	public struct MetadataCacheStats
+	{
+		public long TypeHits;
+		public long TypeMisses;
+		public long MethodHits;
+		public long MethodMisses;
+		public int TypeCount;
+		public int MethodCount;
+	}
+
+	// Per-ScriptContext cache of reflection results. Only successful lookups are stored, so a
+	// failed create or bind is retried in full next time.
+	internal sealed class MetadataCache
+	{
+		private readonly record struct MethodKey(Type Type, string Name, int SignatureId, bool IsStatic);
+
+		private readonly Dictionary<string, Type> _pluginTypes = new(StringComparer.Ordinal);
+		private readonly Dictionary<string, Type> _signatureTypes = new(StringComparer.Ordinal);
+		private readonly Dictionary<MethodKey, MethodInfo> _methods = new();
+		private MetadataCacheStats _stats;
+
+		public MetadataCacheStats Stats
+		{
+			get
+			{
+				var stats = _stats;
+				stats.TypeCount = _pluginTypes.Count + _signatureTypes.Count;
+				stats.MethodCount = _methods.Count;
+				return stats;
+			}
+		}
+
+		public bool TryGetPluginType(string typeName, out Type type) => CountType(_pluginTypes.TryGetValue(typeName, out type!));
+
+		public void AddPluginType(string typeName, Type type) => _pluginTypes[typeName] = type;
+
+		public bool TryGetSignatureType(string typeName, out Type type) => CountType(_signatureTypes.TryGetValue(typeName, out type!));
+
+		public void AddSignatureType(string typeName, Type type) => _signatureTypes[typeName] = type;
+
+		public bool TryGetMethod(Type type, string methodName, int signatureId, bool isStatic, out MethodInfo method)
+		{
+			bool hit = _methods.TryGetValue(new MethodKey(type, methodName, signatureId, isStatic), out method!);
+			if (hit)
+			{
+				_stats.MethodHits++;
+			}
+			else
+			{
+				_stats.MethodMisses++;
+			}
+
+			return hit;
+		}
+
+		public void AddMethod(Type type, string methodName, int signatureId, bool isStatic, MethodInfo method)
+		{
+			_methods[new MethodKey(type, methodName, signatureId, isStatic)] = method;
+		}
+
+		// A re-registered signature id may describe different types, so its methods are looked up again.
+		public void InvalidateSignature(int signatureId)
+		{
+			List<MethodKey>? stale = null;
+			foreach (var key in _methods.Keys)
+			{
+				if (key.SignatureId == signatureId)
+				{
+					(stale ??= new List<MethodKey>()).Add(key);
+				}
+			}
+
+			if (stale != null)
+			{
+				foreach (var key in stale)
+				{
+					_methods.Remove(key);
+				}
+			}
+		}
+
+		public void Clear()
+		{
+			_pluginTypes.Clear();
+			_signatureTypes.Clear();
+			_methods.Clear();
+		}
+
+		private bool CountType(bool hit)
+		{
+			if (hit)
+			{
+				_stats.TypeHits++;
+			}
+			else
+			{
+				_stats.TypeMisses++;
+			}
+
+			return hit;
+		}
+	}
+}
@@ -0,0 +1,174 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Reflection.Emit;
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Managed.Core
+{
+	// Native view of a method bound for direct calls (layout matches MochiSharp::NativeMethod).
+	// Function has the shape R (*)(void *target, Args...) and Target is passed back as its first argument.
+	[StructLayout(LayoutKind.Sequential)]
+	public struct NativeMethodPointer
+	{
+		public IntPtr Function;
+		public IntPtr Target;
+	}
+
+	// Emits one [UnmanagedCallersOnly] trampoline per signature shape. A trampoline resolves the
+	// target GCHandle to a closed delegate and calls it, so a native call costs one transition and
+	// no table lookup. Arguments use the native conventions from Bootstrap.Invoke, except that
+	// structs are passed and returned by value.
+	internal sealed class NativeTrampolineCompiler
+	{
+		private static readonly MethodInfo s_fromIntPtr = typeof(GCHandle).GetMethod(nameof(GCHandle.FromIntPtr))!;
+		private static readonly MethodInfo s_getTarget = typeof(GCHandle).GetProperty(nameof(GCHandle.Target))!.GetGetMethod()!;
+		private static readonly MethodInfo s_reportException = typeof(NativeTrampolineCompiler).GetMethod(nameof(ReportException), BindingFlags.Static | BindingFlags.NonPublic)!;
+		private static readonly ConstructorInfo s_unmanagedCallersOnly = typeof(UnmanagedCallersOnlyAttribute).GetConstructor(Type.EmptyTypes)!;
+
+		private readonly string _name;
+		private readonly Dictionary<Type, IntPtr> _trampolines = new();
+		private readonly HashSet<string> _accessibleAssemblies = new();
+		private AssemblyBuilder? _assembly;
+		private ModuleBuilder? _module;
+		private ConstructorInfo? _ignoresAccessChecksTo;
+
+		public NativeTrampolineCompiler(string name)
+		{
+			_name = name;
+		}
+
+		// Returns a native callable pointer for delegates of the given type.
+		public IntPtr GetTrampoline(Type delegateType)
+		{
+			if (_trampolines.TryGetValue(delegateType, out var fn))
+			{
+				return fn;
+			}
+
+			fn = Emit(delegateType);
+			_trampolines.Add(delegateType, fn);
+			return fn;
+		}
+
+		// Signature types are validated by InteropType.Classify, so they are valid for native calls.
+		public static Type GetDelegateType(Type returnType, Type[] parameterTypes)
+		{
+			return Expression.GetDelegateType(parameterTypes.Append(returnType).ToArray());
+		}
+
+		private IntPtr Emit(Type delegateType)
+		{
+			MethodInfo invoke = delegateType.GetMethod("Invoke")!;
+			Type returnType = invoke.ReturnType;
+			Type[] parameterTypes = invoke.GetParameters().Select(p => p.ParameterType).ToArray();
+
+			EnsureModule();
+			AllowAccessTo(typeof(NativeTrampolineCompiler).Assembly);
+			foreach (var t in parameterTypes.Append(returnType))
+			{
+				AllowAccessTo(t.Assembly);
+			}
+
+			var nativeParameters = new Type[parameterTypes.Length + 1];
+			nativeParameters[0] = typeof(IntPtr);
+			for (int i = 0; i < parameterTypes.Length; i++)
+			{
+				nativeParameters[i + 1] = ToNative(parameterTypes[i]);
+			}
+			Type nativeReturn = ToNative(returnType);
+
+			var type = _module!.DefineType($"Trampoline{_trampolines.Count}", TypeAttributes.Public | TypeAttributes.Abstract | TypeAttributes.Sealed);
+			var method = type.DefineMethod("Call", MethodAttributes.Public | MethodAttributes.Static, nativeReturn, nativeParameters);
+			method.SetCustomAttribute(new CustomAttributeBuilder(s_unmanagedCallersOnly, Array.Empty<object>()));
+
+			// try { result = ((D)GCHandle.FromIntPtr(target).Target).Invoke(args...); }
+			// catch (Exception ex) { ReportException(ex); }
+			// return result;
+			var il = method.GetILGenerator();
+			var handle = il.DeclareLocal(typeof(GCHandle));
+			var result = nativeReturn != typeof(void) ? il.DeclareLocal(nativeReturn) : null;
+			var end = il.DefineLabel();
+
+			il.BeginExceptionBlock();
+			il.Emit(OpCodes.Ldarg_0);
+			il.Emit(OpCodes.Call, s_fromIntPtr);
+			il.Emit(OpCodes.Stloc, handle);
+			il.Emit(OpCodes.Ldloca, handle);
+			il.Emit(OpCodes.Call, s_getTarget);
+			il.Emit(OpCodes.Castclass, delegateType);
+			for (int i = 0; i < parameterTypes.Length; i++)
+			{
+				il.Emit(OpCodes.Ldarg, i + 1);
+				if (parameterTypes[i] == typeof(bool))
+				{
+					// bool is passed as int32, any non-zero value is true.
+					il.Emit(OpCodes.Ldc_I4_0);
+					il.Emit(OpCodes.Cgt_Un);
+				}
+			}
+			il.Emit(OpCodes.Callvirt, invoke);
+			if (result != null)
+			{
+				il.Emit(OpCodes.Stloc, result);
+			}
+			il.Emit(OpCodes.Leave, end);
+
+			il.BeginCatchBlock(typeof(Exception));
+			il.Emit(OpCodes.Call, s_reportException);
+			il.Emit(OpCodes.Leave, end);
+			il.EndExceptionBlock();
+
+			il.MarkLabel(end);
+			if (result != null)
+			{
+				il.Emit(OpCodes.Ldloc, result);
+			}
+			il.Emit(OpCodes.Ret);
+
+			Type created = type.CreateType()!;
+			return created.GetMethod("Call")!.MethodHandle.GetFunctionPointer();
+		}
+
+		private void EnsureModule()
+		{
+			if (_module != null)
+			{
+				return;
+			}
+
+			// Collectible, so trampolines referencing plugin types unload together with the plugin.
+			_assembly = AssemblyBuilder.DefineDynamicAssembly(new AssemblyName($"{_name}.Trampolines"), AssemblyBuilderAccess.RunAndCollect);
+			_module = _assembly.DefineDynamicModule($"{_name}.Trampolines");
+
+			// The runtime honors IgnoresAccessChecksToAttribute on dynamic assemblies, which lets
+			// trampolines name internal script types and call back into the core.
+			var attribute = _module.DefineType("System.Runtime.CompilerServices.IgnoresAccessChecksToAttribute", TypeAttributes.Public | TypeAttributes.Sealed, typeof(Attribute));
+			var ctorWithName = attribute.DefineConstructor(MethodAttributes.Public, CallingConventions.Standard, new[] { typeof(string) });
+			var ctorIl = ctorWithName.GetILGenerator();
+			ctorIl.Emit(OpCodes.Ldarg_0);
+			ctorIl.Emit(OpCodes.Call, typeof(Attribute).GetConstructor(BindingFlags.Instance | BindingFlags.NonPublic, Type.EmptyTypes)!);
+			ctorIl.Emit(OpCodes.Ret);
+			_ignoresAccessChecksTo = attribute.CreateType()!.GetConstructor(new[] { typeof(string) });
+		}
+
+		private void AllowAccessTo(Assembly assembly)
+		{
+			string? name = assembly.GetName().Name;
+			if (name != null && _accessibleAssemblies.Add(name))
+			{
+				_assembly!.SetCustomAttribute(new CustomAttributeBuilder(_ignoresAccessChecksTo!, new object[] { name }));
+			}
+		}
+
+		private static Type ToNative(Type type) => type == typeof(bool) ? typeof(int) : type;
+
+		// Exceptions must not unwind into native frames.
+		private static void ReportException(Exception ex)
+		{
+			Bootstrap.Log($"Native call failed: {ex}");
+		}
+	}
+}
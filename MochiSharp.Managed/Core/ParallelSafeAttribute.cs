@@ -0,0 +1,12 @@
+using System;
+
+namespace MochiSharp.Managed.Core
+{
+	// Marks a script class or method as safe to run concurrently with other parallel-safe calls, e.g. an
+	// OnUpdate that only touches its own instance state. The native ScriptScheduler spreads such calls
+	// across worker threads; everything else runs serially on the thread that drives the frame.
+	[AttributeUsage(AttributeTargets.Class | AttributeTargets.Method, Inherited = true)]
+	public sealed class ParallelSafeAttribute : Attribute
+	{
+	}
+}
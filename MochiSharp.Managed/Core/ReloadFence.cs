@@ -0,0 +1,118 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Counts Bootstrap calls in flight so a reload can wait until none are using the old ScriptContext.
+	// The count is striped per thread so concurrent callers on different cores do not contend on one
+	// cache line; Close sums the stripes. A closed fence makes new callers wait, except calls nested
+	// inside one already in flight through the same fence (script code calling back into the host),
+	// which would deadlock. Each script context has its own fence.
+	internal sealed class ReloadFence
+	{
+		private const int StripeCount = 64;
+
+		[StructLayout(LayoutKind.Explicit, Size = 64)]
+		private struct Stripe
+		{
+			[FieldOffset(0)] public int Count;
+		}
+
+		private readonly Stripe[] _stripes = new Stripe[StripeCount];
+		private int _closed;
+
+		// Fences this thread is inside, innermost last; calls nest, so they exit in reverse order.
+		[ThreadStatic]
+		private static ReloadFence?[]? t_entered;
+		[ThreadStatic]
+		private static int t_depth;
+
+		// True on a thread that is inside a fenced call of any context; such a thread must not reload.
+		public static bool IsInsideCall => t_depth != 0;
+
+		// Blocks while a reload is in progress. Returns the stripe to pass to Exit.
+		public int Enter()
+		{
+			int stripe = Environment.CurrentManagedThreadId & (StripeCount - 1);
+			var spinner = new SpinWait();
+			while (true)
+			{
+				// Full fence: pairs with the one in Close, so either this call sees the fence closed
+				// or Close sees this call's count.
+				Interlocked.Increment(ref _stripes[stripe].Count);
+				if (Volatile.Read(ref _closed) == 0 || IsEnteredOnThisThread())
+				{
+					Push();
+					return stripe;
+				}
+
+				Interlocked.Decrement(ref _stripes[stripe].Count);
+				while (Volatile.Read(ref _closed) != 0)
+				{
+					spinner.SpinOnce();
+				}
+			}
+		}
+
+		public void Exit(int stripe)
+		{
+			t_entered![--t_depth] = null;
+			Interlocked.Decrement(ref _stripes[stripe].Count);
+		}
+
+		private void Push()
+		{
+			ReloadFence?[]? entered = t_entered;
+			if (entered == null || t_depth == entered.Length)
+			{
+				Array.Resize(ref t_entered, Math.Max(t_depth * 2, 4));
+				entered = t_entered;
+			}
+
+			entered[t_depth++] = this;
+		}
+
+		private bool IsEnteredOnThisThread()
+		{
+			ReloadFence?[]? entered = t_entered;
+			for (int i = 0; i < t_depth; i++)
+			{
+				if (entered![i] == this)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Stops new calls and waits for the ones in flight to return.
+		public void Close()
+		{
+			Interlocked.Exchange(ref _closed, 1);
+
+			var spinner = new SpinWait();
+			while (InFlight() != 0)
+			{
+				spinner.SpinOnce();
+			}
+		}
+
+		public void Open()
+		{
+			Volatile.Write(ref _closed, 0);
+		}
+
+		private int InFlight()
+		{
+			int total = 0;
+			for (int i = 0; i < StripeCount; i++)
+			{
+				total += Volatile.Read(ref _stripes[i].Count);
+			}
+
+			return total;
+		}
+	}
+}
@@ -0,0 +1,67 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime;
+using System.Runtime.InteropServices;
+
+namespace MochiSharp.Managed.Core
+{
+	// Runtime configuration in effect (layout matches MochiSharp::RuntimeInfo). The GC values come from
+	// the GC itself, so they reflect runtimeconfig.json, the host's HostSettings and DOTNET_ variables.
+	[StructLayout(LayoutKind.Sequential)]
+	public struct RuntimeInfo
+	{
+		public int ServerGC;
+		public int ConcurrentGC;
+		public int GCHeapAffinitize;
+		public int GCHeapCount;
+		public int GCLatencyMode;
+		public int TieredCompilation;
+		public int TieredPGO;
+		public int ReadyToRun;
+		public ulong GCHeapHardLimit;
+		public ulong GCHeapAffinitizeMask;
+		public ulong TotalAvailableMemory;
+
+		public static RuntimeInfo Capture()
+		{
+			IReadOnlyDictionary<string, object> gc = GC.GetConfigurationVariables();
+			return new RuntimeInfo
+			{
+				ServerGC = GCSettings.IsServerGC ? 1 : 0,
+				ConcurrentGC = GetBool(gc, "ConcurrentGC") ? 1 : 0,
+				GCHeapAffinitize = GetBool(gc, "NoAffinitize") ? 0 : 1,
+				GCHeapCount = (int)GetInt64(gc, "HeapCount"),
+				GCLatencyMode = (int)GCSettings.LatencyMode,
+				TieredCompilation = IsEnabled("System.Runtime.TieredCompilation", "TieredCompilation") ? 1 : 0,
+				TieredPGO = IsEnabled("System.Runtime.TieredPGO", "TieredPGO") ? 1 : 0,
+				ReadyToRun = IsEnabled(null, "ReadyToRun") ? 1 : 0,
+				GCHeapHardLimit = (ulong)GetInt64(gc, "GCHeapHardLimit"),
+				GCHeapAffinitizeMask = (ulong)GetInt64(gc, "GCHeapAffinitizeMask"),
+				TotalAvailableMemory = (ulong)GC.GetGCMemoryInfo().TotalAvailableMemoryBytes,
+			};
+		}
+
+		private static bool GetBool(IReadOnlyDictionary<string, object> gc, string key)
+		{
+			return gc.TryGetValue(key, out object? value) && value is bool b && b;
+		}
+
+		private static long GetInt64(IReadOnlyDictionary<string, object> gc, string key)
+		{
+			return gc.TryGetValue(key, out object? value) && value is long l ? l : 0;
+		}
+
+		// JIT settings are not queryable; read them the way the runtime does: the runtime property,
+		// then DOTNET_/COMPlus_ variables, else on (the default for all three).
+		private static bool IsEnabled(string? property, string variable)
+		{
+			if (property != null && AppContext.GetData(property) is string text && bool.TryParse(text, out bool enabled))
+			{
+				return enabled;
+			}
+
+			string? value = Environment.GetEnvironmentVariable("DOTNET_" + variable) ?? Environment.GetEnvironmentVariable("COMPlus_" + variable);
+			return value == null || value.Trim() != "0";
+		}
+	}
+}
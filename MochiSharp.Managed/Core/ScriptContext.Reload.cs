@@ -0,0 +1,669 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Loader;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Counters of a committed reload (layout matches MochiSharp::ReloadStats).
+	[StructLayout(LayoutKind.Sequential)]
+	public struct ReloadStats
+	{
+		public int InstancesMigrated;
+		public int InstancesKept;      // their type is gone from the new build; they keep running the old code
+		public int BindingsRebound;
+		public int BindingsDropped;    // the method is gone from the new build
+		public int PointersRebound;
+		public int Prepared;           // instances whose field copier was compiled ahead of the commit
+		public double CommitMs;
+	}
+
+	// State-preserving reload. PrepareReload loads the new build into its own load context on a
+	// background thread and does everything that does not depend on live script state and runs no script
+	// code: type and method mapping, thunk and field-copier compilation. CommitReload then swaps it in
+	// while no other call is running (Bootstrap closes the ReloadFence):
+	// - every instance is replaced by an instance of the same type name from the new build, constructed
+	//   on the committing thread since constructors may use the engine API or shared buffers, under the
+	//   same handle and GUID, with fields copied by name (values of plugin structs are converted field by
+	//   field, references to other migrated instances are redirected);
+	// - every method handle is rebound to the method of the same name and signature;
+	// - direct-call pointers keep their address; their GCHandle is pointed at the new method, through an
+	//   adapter delegate when the signature uses plugin structs.
+	// Old instances are dropped without Dispose, since their state lives on in the new ones, and the old
+	// load context is unloaded without waiting for the GC (see UnloadTracker).
+	public sealed partial class ScriptContext
+	{
+		private ReloadPlan? _reload;
+
+		public bool HasPreparedReload => Volatile.Read(ref _reload) != null;
+
+		// Runs on a background thread while scripts keep running on the current build, so it only loads
+		// and compiles; no script constructor or other script code runs here.
+		public void PrepareReload(string pluginAssemblyPath)
+		{
+			string path = Path.GetFullPath(pluginAssemblyPath);
+			if (!File.Exists(path))
+			{
+				throw new FileNotFoundException("Plugin assembly not found", path);
+			}
+
+			var loadContext = new PluginLoadContext(path, typeof(Bootstrap).Assembly);
+			try
+			{
+				var plan = new ReloadPlan(_loadContext, loadContext, loadContext.LoadFromAssemblyPath(path), path);
+
+				List<object> instances;
+				List<MethodBinding> bindings;
+				List<Delegate> pointers;
+				lock (_writeLock)
+				{
+					instances = _instances.Entries().Select(e => e.Value.Instance).ToList();
+					bindings = _methods.Entries().Select(e => e.Value).ToList();
+					pointers = PointerTargets().Select(h => (Delegate)h.Target!).ToList();
+				}
+
+				plan.Prepare(instances, bindings, pointers);
+				Volatile.Write(ref _reload, plan);
+			}
+			catch
+			{
+				UnloadContext(loadContext);
+				throw;
+			}
+		}
+
+		public void CancelReload()
+		{
+			var plan = Interlocked.Exchange(ref _reload, null);
+			if (plan != null)
+			{
+				UnloadContext(plan.NewContext);
+			}
+		}
+
+		// Must not overlap any other call into this context.
+		public ReloadStats CommitReload()
+		{
+			var plan = Interlocked.Exchange(ref _reload, null)
+				?? throw new InvalidOperationException("No reload prepared");
+
+			var stopwatch = Stopwatch.StartNew();
+			var stats = new ReloadStats();
+
+			lock (_writeLock)
+			{
+				// Construct every new instance before changing anything, so a throwing constructor leaves the
+				// current build running.
+				var entries = _instances.Entries().ToList();
+				var created = new object?[entries.Count];
+				try
+				{
+					for (int i = 0; i < entries.Count; i++)
+					{
+						created[i] = plan.CreateInstance(entries[i].Value.Instance, ref stats.Prepared);
+					}
+				}
+				catch
+				{
+					UnloadContext(plan.NewContext);
+					throw;
+				}
+
+				// New instances first, so references between instances can be redirected while copying.
+				var instances = new Dictionary<object, object>(ReferenceEqualityComparer.Instance);
+				var records = new Dictionary<InstanceRecord, InstanceRecord>(ReferenceEqualityComparer.Instance);
+				for (int i = 0; i < entries.Count; i++)
+				{
+					var entry = entries[i];
+					InstanceRecord record = entry.Value;
+					object? migrated = created[i];
+					if (migrated == null)
+					{
+						stats.InstancesKept++;
+						Logger.Write(LogLevel.Warning, LogCategory.Core, $"Reload: {record.Instance.GetType().FullName} is not in the new build; instance {entry.Key} keeps the old code");
+						continue;
+					}
+
+					instances.Add(record.Instance, migrated);
+					var replacement = new InstanceRecord(migrated, record.Guid)
+					{
+						Methods = record.Methods,
+						PointerTargets = record.PointerTargets,
+					};
+					records.Add(record, replacement);
+					_instances.Replace(entry.Key, replacement);
+				}
+
+				Func<object, object?> redirect = old => instances.TryGetValue(old, out var migrated) ? migrated : null;
+				foreach (var pair in instances)
+				{
+					plan.GetCopier(pair.Key.GetType(), pair.Value.GetType())(pair.Key, pair.Value, redirect);
+				}
+				stats.InstancesMigrated = instances.Count;
+
+				foreach (var entry in _methods.Entries().ToList())
+				{
+					MethodBinding binding = entry.Value;
+					InstanceRecord? owner = binding.Owner;
+					if (owner != null && !records.TryGetValue(owner, out owner))
+					{
+						// The instance kept its old type, so the binding stays valid as it is.
+						continue;
+					}
+
+					if (plan.TryRebind(binding, owner, out var rebound))
+					{
+						_methods.Replace(entry.Key, rebound);
+						stats.BindingsRebound++;
+					}
+					else
+					{
+						_methods.Remove(entry.Key, out _);
+						owner?.Methods?.Remove(entry.Key);
+						stats.BindingsDropped++;
+						Logger.Write(LogLevel.Warning, LogCategory.Core, $"Reload: {binding.Method.DeclaringType?.FullName}.{binding.Method.Name} is not in the new build; method {entry.Key} was unbound");
+					}
+				}
+
+				foreach (GCHandle pointerTarget in PointerTargets())
+				{
+					// GCHandle is a struct, but copies share the underlying handle.
+					GCHandle handle = pointerTarget;
+					var callee = (Delegate)handle.Target!;
+					object? target = callee.Target;
+					if (target != null && !instances.TryGetValue(target, out target))
+					{
+						continue;
+					}
+
+					Delegate? adapted = plan.GetPointerTarget(callee, target);
+					if (adapted != null)
+					{
+						handle.Target = adapted;
+						stats.PointersRebound++;
+					}
+					else
+					{
+						Logger.Write(LogLevel.Warning, LogCategory.Core, $"Reload: could not rebind the direct pointer to {callee.Method.DeclaringType?.FullName}.{callee.Method.Name}; it keeps calling the old code");
+					}
+				}
+
+				var signatures = _signatures.ToList();
+				_signatures.Clear();
+				foreach (var pair in signatures)
+				{
+					if (plan.TryMapSignature(pair.Value, out var signature))
+					{
+						_signatures.Add(pair.Key, signature);
+					}
+					else
+					{
+						Logger.Write(LogLevel.Warning, LogCategory.Core, $"Reload: signature {pair.Key} uses a type that is not in the new build; register it again");
+					}
+				}
+
+				_thunks.Clear();
+				foreach (var pair in plan.Thunks)
+				{
+					_thunks.Add(pair.Key, pair.Value);
+				}
+				_metadata.Clear();
+
+				var oldContext = _loadContext;
+				_loadContext = plan.NewContext;
+				_pluginAssembly = plan.NewAssembly;
+				_pluginPath = plan.PluginPath;
+				UnloadContext(oldContext);
+			}
+
+			stats.CommitMs = stopwatch.Elapsed.TotalMilliseconds;
+			return stats;
+		}
+
+		private IEnumerable<GCHandle> PointerTargets()
+		{
+			foreach (var entry in _instances.Entries())
+			{
+				if (entry.Value.PointerTargets != null)
+				{
+					foreach (var handle in entry.Value.PointerTargets)
+					{
+						yield return handle;
+					}
+				}
+			}
+
+			foreach (var handle in _staticPointerTargets)
+			{
+				yield return handle;
+			}
+		}
+
+		// Copies the fields of an old instance into its replacement; the function maps references to other
+		// migrated instances (null if unknown).
+		private delegate void FieldCopier(object oldInstance, object newInstance, Func<object, object?> redirect);
+
+		private sealed class ReloadPlan
+		{
+			private static readonly MethodInfo s_redirectInvoke = typeof(Func<object, object?>).GetMethod("Invoke")!;
+
+			public readonly AssemblyLoadContext OldContext;
+			public readonly PluginLoadContext NewContext;
+			public readonly Assembly NewAssembly;
+			public readonly string PluginPath;
+			public readonly Dictionary<MethodInfo, InvokeThunk> Thunks = new();
+
+			private readonly Dictionary<Type, Type?> _types = new();
+			private readonly Dictionary<(MethodInfo, Type), MethodInfo?> _methods = new();
+			private readonly Dictionary<(Type, Type), FieldCopier> _copiers = new();
+			// Adapters compiled ahead of the commit. One for an instance method reads its target from Target,
+			// which the commit sets to the new instance.
+			private readonly Dictionary<Delegate, (StrongBox<object?>? Target, Delegate Adapted)> _preparedPointers = new(ReferenceEqualityComparer.Instance);
+
+			public ReloadPlan(AssemblyLoadContext oldContext, PluginLoadContext newContext, Assembly newAssembly, string pluginPath)
+			{
+				OldContext = oldContext;
+				NewContext = newContext;
+				NewAssembly = newAssembly;
+				PluginPath = pluginPath;
+			}
+
+			// Maps and compiles only: instances are constructed by the commit, on the thread that runs scripts.
+			public void Prepare(List<object> instances, List<MethodBinding> bindings, List<Delegate> pointers)
+			{
+				foreach (object instance in instances)
+				{
+					Type? type = MapType(instance.GetType());
+					if (type != null)
+					{
+						GetCopier(instance.GetType(), type);
+					}
+				}
+
+				foreach (var binding in bindings)
+				{
+					Type? targetType = binding.Target != null ? MapType(binding.Target.GetType()) : null;
+					if (binding.Target == null || targetType != null)
+					{
+						TryRebind(binding, null, out _, targetType);
+					}
+				}
+
+				foreach (var callee in pointers)
+				{
+					StrongBox<object?>? target = callee.Target != null ? new StrongBox<object?>() : null;
+					Delegate? adapted = CreatePointerTarget(callee, null, target);
+					if (adapted != null)
+					{
+						_preparedPointers[callee] = (target, adapted);
+					}
+				}
+			}
+
+			// The replacement for an old instance, or null if its type is gone. Counts it as prepared if
+			// PrepareReload compiled its field copier.
+			public object? CreateInstance(object oldInstance, ref int prepared)
+			{
+				Type? type = MapType(oldInstance.GetType());
+				if (type == null)
+				{
+					return null;
+				}
+
+				if (_copiers.ContainsKey((oldInstance.GetType(), type)))
+				{
+					prepared++;
+				}
+				return Activator.CreateInstance(type);
+			}
+
+			public bool TryRebind(in MethodBinding binding, InstanceRecord? owner, out MethodBinding rebound, Type? ownerType = null)
+			{
+				rebound = default;
+				Type? type = ownerType
+					?? owner?.Instance.GetType()
+					?? (binding.InstanceType != null ? MapType(binding.InstanceType) : MapType(binding.Method.DeclaringType!));
+				if (type == null || !TryMapSignature(binding.Signature, out var signature))
+				{
+					return false;
+				}
+
+				MethodInfo? method = MapMethod(binding.Method, type);
+				if (method == null)
+				{
+					return false;
+				}
+
+				if (!Thunks.TryGetValue(method, out var thunk))
+				{
+					thunk = InvokeThunkCompiler.Compile(method, signature.ReturnType, signature.ReturnKind, signature.ParameterTypes, signature.ParameterKinds);
+					Thunks.Add(method, thunk);
+				}
+
+				rebound = new MethodBinding(owner, binding.InstanceType != null ? type : null, method, signature, thunk);
+				return true;
+			}
+
+			public bool TryMapSignature(in Signature signature, out Signature mapped)
+			{
+				mapped = default;
+				Type? returnType = MapType(signature.ReturnType);
+				var parameterTypes = new Type[signature.ParameterTypes.Length];
+				for (int i = 0; i < parameterTypes.Length; i++)
+				{
+					Type? parameterType = MapType(signature.ParameterTypes[i]);
+					if (parameterType == null)
+					{
+						return false;
+					}
+					parameterTypes[i] = parameterType;
+				}
+
+				if (returnType == null)
+				{
+					return false;
+				}
+
+				mapped = returnType == signature.ReturnType && parameterTypes.SequenceEqual(signature.ParameterTypes)
+					? signature
+					: new Signature(returnType, parameterTypes);
+				return true;
+			}
+
+			public Delegate? GetPointerTarget(Delegate callee, object? newTarget)
+			{
+				if (_preparedPointers.TryGetValue(callee, out var prepared))
+				{
+					if (prepared.Target != null)
+					{
+						prepared.Target.Value = newTarget;
+					}
+					return prepared.Adapted;
+				}
+
+				return CreatePointerTarget(callee, newTarget);
+			}
+
+			// A delegate of the callee's own type, so the trampoline the host already holds can call it. An
+			// instance method's target is newTarget, or whatever targetBox holds when the call is made; with
+			// a box, a delegate that needs no adapter is left for the commit (it is cheap to create).
+			private Delegate? CreatePointerTarget(Delegate callee, object? newTarget, StrongBox<object?>? targetBox = null)
+			{
+				Type? owner = targetBox != null ? MapType(callee.Target!.GetType()) : newTarget?.GetType() ?? MapType(callee.Method.DeclaringType!);
+				MethodInfo? method = owner != null ? MapMethod(callee.Method, owner) : null;
+				if (method == null)
+				{
+					return null;
+				}
+
+				Type delegateType = callee.GetType();
+				if (!IsFromOldContext(delegateType))
+				{
+					return targetBox != null ? null : method.CreateDelegate(delegateType, newTarget);
+				}
+
+				// The signature uses plugin structs: convert them on the way in and out.
+				MethodInfo invoke = delegateType.GetMethod("Invoke")!;
+				var parameters = invoke.GetParameters().Select(p => Expression.Parameter(p.ParameterType, p.Name)).ToArray();
+				var newParameters = method.GetParameters();
+				var args = new Expression[parameters.Length];
+				for (int i = 0; i < parameters.Length; i++)
+				{
+					Expression? arg = ConvertValue(parameters[i], newParameters[i].ParameterType, null, null);
+					if (arg == null)
+					{
+						return null;
+					}
+					args[i] = arg;
+				}
+
+				Expression? instance = targetBox != null
+					? Expression.Convert(Expression.Field(Expression.Constant(targetBox), nameof(StrongBox<object?>.Value)), owner!)
+					: newTarget != null ? Expression.Constant(newTarget, newTarget.GetType()) : null;
+				Expression? body = Expression.Call(instance, method, args);
+				if (invoke.ReturnType != typeof(void))
+				{
+					body = ConvertValue(body, invoke.ReturnType, null, null);
+					if (body == null)
+					{
+						return null;
+					}
+				}
+
+				return Expression.Lambda(delegateType, body, parameters).Compile();
+			}
+
+			// Same name and namespace, looked up in the new load context. Types from shared assemblies map to
+			// themselves. Returns null if the type is gone.
+			public Type? MapType(Type type)
+			{
+				if (_types.TryGetValue(type, out var mapped))
+				{
+					return mapped;
+				}
+
+				if (!IsFromOldContext(type))
+				{
+					mapped = type;
+				}
+				else if (type.IsArray)
+				{
+					Type? element = MapType(type.GetElementType()!);
+					mapped = element == null ? null : type.IsSZArray ? element.MakeArrayType() : element.MakeArrayType(type.GetArrayRank());
+				}
+				else if (type.IsGenericType && !type.IsGenericTypeDefinition)
+				{
+					Type? definition = MapType(type.GetGenericTypeDefinition());
+					Type?[] arguments = type.GetGenericArguments().Select(MapType).ToArray();
+					mapped = definition == null || arguments.Any(a => a == null) ? null : definition.MakeGenericType(arguments!);
+				}
+				else
+				{
+					mapped = FindInNewContext(type);
+				}
+
+				_types[type] = mapped;
+				return mapped;
+			}
+
+			private Type? FindInNewContext(Type type)
+			{
+				AssemblyName assemblyName = type.Assembly.GetName();
+				foreach (var assembly in NewContext.Assemblies)
+				{
+					if (string.Equals(assembly.GetName().Name, assemblyName.Name, StringComparison.OrdinalIgnoreCase))
+					{
+						return assembly.GetType(type.FullName!, throwOnError: false);
+					}
+				}
+
+				try
+				{
+					return NewContext.LoadFromAssemblyName(assemblyName).GetType(type.FullName!, throwOnError: false);
+				}
+				catch (IOException)
+				{
+					return null;
+				}
+			}
+
+			private MethodInfo? MapMethod(MethodInfo method, Type owner)
+			{
+				if (_methods.TryGetValue((method, owner), out var mapped))
+				{
+					return mapped;
+				}
+
+				mapped = null;
+				Type? returnType = MapType(method.ReturnType);
+				Type?[] parameterTypes = method.GetParameters().Select(p => MapType(p.ParameterType)).ToArray();
+				if (returnType != null && parameterTypes.All(t => t != null))
+				{
+					try
+					{
+						var found = FindMethod(owner, method.Name, parameterTypes!, method.IsStatic);
+						mapped = found.ReturnType == returnType ? found : null;
+					}
+					catch (MissingMethodException)
+					{
+					}
+				}
+
+				_methods[(method, owner)] = mapped;
+				return mapped;
+			}
+
+			public FieldCopier GetCopier(Type oldType, Type newType)
+			{
+				if (!_copiers.TryGetValue((oldType, newType), out var copier))
+				{
+					copier = CompileCopier(oldType, newType);
+					_copiers.Add((oldType, newType), copier);
+				}
+
+				return copier;
+			}
+
+			private FieldCopier CompileCopier(Type oldType, Type newType)
+			{
+				var oldInstance = Expression.Parameter(typeof(object), "oldInstance");
+				var newInstance = Expression.Parameter(typeof(object), "newInstance");
+				var redirect = Expression.Parameter(typeof(Func<object, object?>), "redirect");
+				var source = Expression.Variable(oldType, "source");
+				var destination = Expression.Variable(newType, "destination");
+
+				var body = new List<Expression>
+				{
+					Expression.Assign(source, Expression.Convert(oldInstance, oldType)),
+					Expression.Assign(destination, Expression.Convert(newInstance, newType)),
+				};
+
+				var newFields = InstanceFields(newType);
+				foreach (var pair in InstanceFields(oldType))
+				{
+					if (!newFields.TryGetValue(pair.Key, out var field))
+					{
+						continue;
+					}
+
+					Expression current = Expression.Field(destination, field);
+					Expression? value = ConvertValue(Expression.Field(source, pair.Value), field.FieldType, current, redirect);
+					if (value == null)
+					{
+						continue;
+					}
+
+					if (field.IsInitOnly)
+					{
+						// Expression trees cannot assign readonly fields.
+						body.Add(Expression.Call(Expression.Constant(field), typeof(FieldInfo).GetMethod(nameof(FieldInfo.SetValue), new[] { typeof(object), typeof(object) })!,
+							destination, Expression.Convert(value, typeof(object))));
+					}
+					else
+					{
+						body.Add(Expression.Assign(current, value));
+					}
+				}
+
+				return Expression.Lambda<FieldCopier>(Expression.Block(new[] { source, destination }, body), oldInstance, newInstance, redirect).Compile();
+			}
+
+			// Converts a value of an old type to the matching new type, or returns null if they do not match.
+			// current is the destination's present value, kept when a reference cannot be redirected.
+			private Expression? ConvertValue(Expression value, Type targetType, Expression? current, ParameterExpression? redirect)
+			{
+				Type sourceType = value.Type;
+				if (sourceType == targetType)
+				{
+					return value;
+				}
+
+				// Either direction: adapters convert their results back to the old types.
+				if (MapType(sourceType) != targetType && MapType(targetType) != sourceType)
+				{
+					return null;
+				}
+
+				if (sourceType.IsEnum)
+				{
+					return Expression.Convert(Expression.Convert(value, Enum.GetUnderlyingType(sourceType)), targetType);
+				}
+
+				if (sourceType.IsValueType)
+				{
+					// Evaluate the source once; it may be a call.
+					var original = Expression.Variable(sourceType, "original");
+					var converted = Expression.Variable(targetType, "converted");
+					var body = new List<Expression>
+					{
+						Expression.Assign(original, value),
+						Expression.Assign(converted, Expression.Default(targetType)),
+					};
+					var targetFields = InstanceFields(targetType);
+					foreach (var pair in InstanceFields(sourceType))
+					{
+						if (targetFields.TryGetValue(pair.Key, out var field) && !field.IsInitOnly)
+						{
+							Expression? fieldValue = ConvertValue(Expression.Field(original, pair.Value), field.FieldType, null, redirect);
+							if (fieldValue != null)
+							{
+								body.Add(Expression.Assign(Expression.Field(converted, field), fieldValue));
+							}
+						}
+					}
+
+					body.Add(converted);
+					return Expression.Block(new[] { original, converted }, body);
+				}
+
+				if (redirect == null)
+				{
+					return null;
+				}
+
+				// A reference into the old build: use the migrated instance if there is one.
+				Expression fallback = current != null ? Expression.Convert(current, typeof(object)) : Expression.Constant(null, typeof(object));
+				return Expression.Convert(
+					Expression.Coalesce(Expression.Call(redirect, s_redirectInvoke, Expression.Convert(value, typeof(object))), fallback),
+					targetType);
+			}
+
+			// Fields of the type and its base types by name; the most derived field wins.
+			private static Dictionary<string, FieldInfo> InstanceFields(Type type)
+			{
+				var fields = new Dictionary<string, FieldInfo>(StringComparer.Ordinal);
+				for (Type? t = type; t != null && t != typeof(object); t = t.BaseType)
+				{
+					foreach (var field in t.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly))
+					{
+						fields.TryAdd(field.Name, field);
+					}
+				}
+
+				return fields;
+			}
+
+			private bool IsFromOldContext(Type type)
+			{
+				if (type.HasElementType)
+				{
+					return IsFromOldContext(type.GetElementType()!);
+				}
+
+				if (type.IsGenericType && !type.IsGenericTypeDefinition && type.GetGenericArguments().Any(IsFromOldContext))
+				{
+					return true;
+				}
+
+				return AssemblyLoadContext.GetLoadContext(type.Assembly) == OldContext;
+			}
+		}
+	}
+}
@@ -3,12 +3,24 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Runtime.Loader;
 
 namespace MochiSharp.Managed.Core
 {
-	public sealed class ScriptContext
+	// Threading:
+	// - Invoke, InvokeOn and InvokeBatch take no lock; they only read the handle tables and may run on
+	//   any number of threads at once.
+	// - Creating, destroying, binding, unbinding and registering signatures serialize on one write lock.
+	//   Script constructors and Dispose run outside it.
+	// - Destroying an instance or unbinding a method lets calls already running on other threads finish;
+	//   later calls with the stale handle fail.
+	// - Unload and CommitReload must not overlap any other call; Bootstrap fences reloads (see
+	//   ReloadFence). PrepareReload runs alongside everything else.
+	// - Direct-call pointers from Bind*Ptr bypass all of this: the host must stop calling them before it
+	//   destroys their instance or unloads, and while a reload commits.
+	public sealed partial class ScriptContext
 	{
 		private sealed class PluginLoadContext : AssemblyLoadContext
 		{
@@ -61,46 +73,96 @@ namespace MochiSharp.Managed.Core
 			}
 		}
 
-		private readonly string _pluginPath;
-		private readonly PluginLoadContext _loadContext;
-		private readonly Assembly _pluginAssembly;
+		// Swapped together by CommitReload.
+		private string _pluginPath;
+		private PluginLoadContext _loadContext;
+		private Assembly _pluginAssembly;
 
-		private int _nextInstanceId = 1;
-		private readonly Dictionary<int, object> _instances = new();
-		private readonly Dictionary<Guid, object> _instancesByGuid = new();
+		// Instances created by GUID live in the same table; the GUID map only resolves them to a handle.
+		// Both handle tables allocate from the process-wide spaces, tagged with ContextId.
+		private readonly HandleTable<InstanceRecord> _instances;
+		private readonly Dictionary<Guid, int> _instancesByGuid = new();
 
-		private int _nextMethodId = 1;
-		private readonly Dictionary<int, MethodBinding> _methods = new();
+		private readonly HandleTable<MethodBinding> _methods;
+		private readonly Dictionary<MethodInfo, InvokeThunk> _thunks = new();
+
+		// GCHandles passed to native code as NativeMethodPointer.Target for static methods;
+		// instance targets are owned by their InstanceRecord.
+		private readonly NativeTrampolineCompiler _trampolines;
+		private readonly List<GCHandle> _staticPointerTargets = new();
 
 		private readonly Dictionary<int, Signature> _signatures = new();
+		private readonly MetadataCache _metadata = new();
+		// Watches unloaded load contexts until they are collected; null to unload and forget.
+		private readonly UnloadTracker? _unloads;
+
+		// Guards every table and cache above; readers of the handle tables do not take it.
+		private readonly object _writeLock = new();
 
 		private readonly struct Signature
 		{
 			public readonly Type ReturnType;
 			public readonly Type[] ParameterTypes;
+			public readonly InteropKind ReturnKind;
+			public readonly InteropKind[] ParameterKinds;
 
 			public Signature(Type returnType, Type[] parameterTypes)
 			{
 				ReturnType = returnType;
 				ParameterTypes = parameterTypes;
+
+				// Classify once so the hot path never consults the marshaler; throws for non-blittable types.
+				ReturnKind = InteropType.Classify(returnType);
+				ParameterKinds = parameterTypes.Length == 0
+					? Array.Empty<InteropKind>()
+					: Array.ConvertAll(parameterTypes, InteropType.Classify);
+			}
+		}
+
+		// Everything owned by a live instance, released together when it is destroyed.
+		private sealed class InstanceRecord
+		{
+			public readonly object Instance;
+			public readonly Guid Guid;
+			public List<int>? Methods;
+			public List<GCHandle>? PointerTargets;
+
+			public InstanceRecord(object instance, Guid guid)
+			{
+				Instance = instance;
+				Guid = guid;
 			}
 		}
 
 		private readonly struct MethodBinding
 		{
 			public readonly object? Target;
+			public readonly InstanceRecord? Owner;
+			// Set for type-level bindings, whose target is supplied per call by InvokeOn.
+			public readonly Type? InstanceType;
 			public readonly MethodInfo Method;
 			public readonly Signature Signature;
+			public readonly InvokeThunk Thunk;
 
-			public MethodBinding(object? target, MethodInfo method, Signature signature)
+			public MethodBinding(InstanceRecord? owner, Type? instanceType, MethodInfo method, Signature signature, InvokeThunk thunk)
 			{
-				Target = target;
+				Target = owner?.Instance;
+				Owner = owner;
+				InstanceType = instanceType;
 				Method = method;
 				Signature = signature;
+				Thunk = thunk;
 			}
 		}
 
 		public ScriptContext(string pluginAssemblyPath)
+			: this(pluginAssemblyPath, null, 0)
+		{
+		}
+
+		// contextId is the Bootstrap context this one is loaded into; HandleSpace.OwnerOf reports it for
+		// every handle this context hands out.
+		internal ScriptContext(string pluginAssemblyPath, UnloadTracker? unloads, int contextId)
 		{
 			if (string.IsNullOrWhiteSpace(pluginAssemblyPath))
 			{
@@ -115,144 +177,605 @@ namespace MochiSharp.Managed.Core
 
 			_loadContext = new PluginLoadContext(_pluginPath, typeof(Bootstrap).Assembly);
 			_pluginAssembly = _loadContext.LoadFromAssemblyPath(_pluginPath);
+			_trampolines = new NativeTrampolineCompiler(Path.GetFileNameWithoutExtension(_pluginPath));
+			_unloads = unloads;
+			ContextId = contextId;
+			_instances = new HandleTable<InstanceRecord>(HandleSpace.Instances, contextId);
+			_methods = new HandleTable<MethodBinding>(HandleSpace.Methods, contextId);
 		}
 
+		public int ContextId { get; }
+		// The Bootstrap signature registry version this context has applied; see Bootstrap.ApplySignatures.
+		internal int SignatureVersion { get; set; }
+
 		public void Unload()
 		{
+			lock (_writeLock)
+			{
+				UnloadCore();
+			}
+		}
+
+		private void UnloadCore()
+		{
+			foreach (var entry in _instances.Entries())
+			{
+				if (entry.Value.PointerTargets != null)
+				{
+					FreeHandles(entry.Value.PointerTargets);
+				}
+			}
+			FreeHandles(_staticPointerTargets);
+
 			_instances.Clear();
 			_instancesByGuid.Clear();
 			_methods.Clear();
+			_thunks.Clear();
 			_signatures.Clear();
-			_loadContext.Unload();
+			_metadata.Clear();
+			UnloadContext(_loadContext);
+			CancelReload();
+		}
+
+		// Does not wait for the GC; the tracker, if any, reports when the context is actually gone.
+		private void UnloadContext(AssemblyLoadContext context)
+		{
+			context.Unload();
+			_unloads?.Track(context);
+		}
+
+		// The references this context holds into an unloaded load context, for leak reports; null if none.
+		internal string? DescribeRootsInto(AssemblyLoadContext context)
+		{
+			lock (_writeLock)
+			{
+				int pointers = PointerTargets().Count(h => h.Target is Delegate d && ReferencesContext(d, context));
+				return pointers == 0
+					? null
+					: $"{pointers} direct-call pointers bound to its code";
+			}
+		}
+
+		private static bool ReferencesContext(Delegate callee, AssemblyLoadContext context)
+		{
+			static bool InContext(Type type, AssemblyLoadContext context)
+			{
+				if (type.HasElementType)
+				{
+					return InContext(type.GetElementType()!, context);
+				}
+
+				return AssemblyLoadContext.GetLoadContext(type.Assembly) == context
+					|| (type.IsGenericType && type.GetGenericArguments().Any(a => InContext(a, context)));
+			}
+
+			return InContext(callee.GetType(), context)
+				|| (callee.Method.DeclaringType != null && InContext(callee.Method.DeclaringType, context))
+				|| (callee.Target != null && InContext(callee.Target.GetType(), context));
 		}
 
 		public void RegisterSignature(int signatureId, string returnTypeName, string[] parameterTypeNames)
 		{
             ArgumentOutOfRangeException.ThrowIfNegative(signatureId);
 
-            Type returnType = ResolveType(returnTypeName);
-			var paramTypes = parameterTypeNames.Length == 0
-				? Array.Empty<Type>()
-				: parameterTypeNames.Select(ResolveType).ToArray();
+			lock (_writeLock)
+			{
+				Type returnType = GetSignatureType(returnTypeName);
+				var paramTypes = parameterTypeNames.Length == 0
+					? Array.Empty<Type>()
+					: Array.ConvertAll(parameterTypeNames, GetSignatureType);
 
-			_signatures[signatureId] = new Signature(returnType, paramTypes);
+				if (_signatures.ContainsKey(signatureId))
+				{
+					_metadata.InvalidateSignature(signatureId);
+				}
+				_signatures[signatureId] = new Signature(returnType, paramTypes);
+			}
 		}
 
 		public int CreateInstance(string typeName)
 		{
-			Type type = ResolvePluginType(typeName);
-			object instance = Activator.CreateInstance(type)
-				?? throw new InvalidOperationException($"Failed to create instance of {type.FullName}");
+			object instance = Construct(typeName);
 
-			int id = _nextInstanceId++;
-			_instances.Add(id, instance);
-			return id;
+			lock (_writeLock)
+			{
+				return _instances.Add(new InstanceRecord(instance, Guid.Empty));
+			}
+		}
+
+		public int CreateInstance(Guid instanceId, string typeName)
+		{
+			lock (_writeLock)
+			{
+				EnsureGuidAvailable(instanceId);
+			}
+
+			object instance = Construct(typeName);
+
+			lock (_writeLock)
+			{
+				// Another thread may have taken the GUID while the constructor ran.
+				if (_instancesByGuid.ContainsKey(instanceId))
+				{
+					(instance as IDisposable)?.Dispose();
+					EnsureGuidAvailable(instanceId);
+				}
+
+				int handle = _instances.Add(new InstanceRecord(instance, instanceId));
+				_instancesByGuid.Add(instanceId, handle);
+				return handle;
+			}
 		}
 
-		public void CreateInstance(Guid instanceId, string typeName)
+		public bool HasInstance(Guid instanceId)
+		{
+			lock (_writeLock)
+			{
+				return _instancesByGuid.ContainsKey(instanceId);
+			}
+		}
+
+		private void EnsureGuidAvailable(Guid instanceId)
 		{
 			if (_instancesByGuid.ContainsKey(instanceId))
 			{
 				throw new InvalidOperationException($"Instance GUID already exists: {instanceId}");
 			}
+		}
 
-			Type type = ResolvePluginType(typeName);
-			object instance = Activator.CreateInstance(type)
-				?? throw new InvalidOperationException($"Failed to create instance of {type.FullName}");
+		// Runs the script constructor outside the write lock.
+		private object Construct(string typeName)
+		{
+			Type type;
+			lock (_writeLock)
+			{
+				type = GetPluginType(typeName);
+			}
 
-			_instancesByGuid.Add(instanceId, instance);
+			return Activator.CreateInstance(type)
+				?? throw new InvalidOperationException($"Failed to create instance of {type.FullName}");
 		}
 
 		public void DestroyInstance(int instanceId)
 		{
-			if (_instances.Remove(instanceId, out var obj))
+			InstanceRecord? record;
+			lock (_writeLock)
 			{
-				if (obj is IDisposable d)
+				if (!_instances.Remove(instanceId, out record))
 				{
-					d.Dispose();
+					return;
 				}
+
+				if (record.Guid != Guid.Empty)
+				{
+					_instancesByGuid.Remove(record.Guid);
+				}
+				ReleaseInstance(record);
 			}
+
+			(record.Instance as IDisposable)?.Dispose();
 		}
 
 		public void DestroyInstance(Guid instanceId)
 		{
-			if (_instancesByGuid.Remove(instanceId, out var obj))
+			InstanceRecord? record;
+			lock (_writeLock)
 			{
-				if (obj is IDisposable d)
+				if (!_instancesByGuid.Remove(instanceId, out int handle) || !_instances.Remove(handle, out record))
 				{
-					d.Dispose();
+					return;
 				}
+
+				ReleaseInstance(record);
 			}
+
+			(record.Instance as IDisposable)?.Dispose();
 		}
 
-		public int BindInstanceMethod(int instanceId, string methodName, int signatureId)
+		// Frees the instance's method handles and pointer targets, so their slots can be reused.
+		// The caller disposes the instance once the write lock is released.
+		private void ReleaseInstance(InstanceRecord record)
 		{
-			if (!_instances.TryGetValue(instanceId, out var instance))
+			if (record.Methods != null)
 			{
-				throw new KeyNotFoundException($"Instance id not found: {instanceId}");
+				foreach (int methodId in record.Methods)
+				{
+					_methods.Remove(methodId, out _);
+				}
 			}
 
-			Signature sig = GetSignature(signatureId);
-			var type = instance.GetType();
-			var method = FindMethod(type, methodName, sig.ParameterTypes, isStatic: false);
-			EnsureReturnType(method, sig.ReturnType);
+			if (record.PointerTargets != null)
+			{
+				FreeHandles(record.PointerTargets);
+			}
+		}
 
-			int id = _nextMethodId++;
-			_methods.Add(id, new MethodBinding(instance, method, sig));
-			return id;
+		// Releases a single binding. Stale or unknown ids are ignored.
+		public void UnbindMethod(int methodId)
+		{
+			lock (_writeLock)
+			{
+				if (_methods.Remove(methodId, out var binding) && binding.Owner != null)
+				{
+					binding.Owner.Methods?.Remove(methodId);
+				}
+			}
+		}
+
+		public int BindInstanceMethod(int instanceId, string methodName, int signatureId)
+		{
+			lock (_writeLock)
+			{
+				return BindInstanceMethod(GetInstance(instanceId), methodName, signatureId);
+			}
 		}
 
 		public int BindInstanceMethod(Guid instanceId, string methodName, int signatureId)
 		{
-			if (!_instancesByGuid.TryGetValue(instanceId, out var instance))
+			lock (_writeLock)
 			{
-				throw new KeyNotFoundException($"Instance guid not found: {instanceId}");
+				return BindInstanceMethod(GetInstance(instanceId), methodName, signatureId);
 			}
+		}
 
+		private int BindInstanceMethod(InstanceRecord record, string methodName, int signatureId)
+		{
 			Signature sig = GetSignature(signatureId);
-			var type = instance.GetType();
-			var method = FindMethod(type, methodName, sig.ParameterTypes, isStatic: false);
-			EnsureReturnType(method, sig.ReturnType);
+			var type = record.Instance.GetType();
+			var method = GetMethod(type, methodName, signatureId, sig, isStatic: false);
 
-			int id = _nextMethodId++;
-			_methods.Add(id, new MethodBinding(instance, method, sig));
+			int id = AddBinding(record, method, sig);
+			(record.Methods ??= new List<int>()).Add(id);
 			return id;
 		}
 
 		public int BindStaticMethod(string typeName, string methodName, int signatureId)
 		{
-			Type type = ResolvePluginType(typeName);
+			lock (_writeLock)
+			{
+				Type type = GetPluginType(typeName);
+				Signature sig = GetSignature(signatureId);
+				var method = GetMethod(type, methodName, signatureId, sig, isStatic: true);
+
+				return AddBinding(null, method, sig);
+			}
+		}
+
+		// Binds an instance method once for a whole type. The binding has no target; InvokeOn supplies
+		// the instance per call, so creating an instance needs no reflection.
+		public int BindTypeMethod(string typeName, string methodName, int signatureId)
+		{
+			lock (_writeLock)
+			{
+				Type type = GetPluginType(typeName);
+				Signature sig = GetSignature(signatureId);
+				var method = GetMethod(type, methodName, signatureId, sig, isStatic: false);
+
+				return AddBinding(null, method, sig, instanceType: type);
+			}
+		}
+
+		// Direct-call variants: the returned pointer stays valid until the instance is destroyed
+		// or the context is unloaded.
+		public NativeMethodPointer BindInstanceMethodPtr(int instanceId, string methodName, int signatureId)
+		{
+			lock (_writeLock)
+			{
+				return BindInstanceMethodPtr(GetInstance(instanceId), methodName, signatureId);
+			}
+		}
+
+		public NativeMethodPointer BindInstanceMethodPtr(Guid instanceId, string methodName, int signatureId)
+		{
+			lock (_writeLock)
+			{
+				return BindInstanceMethodPtr(GetInstance(instanceId), methodName, signatureId);
+			}
+		}
+
+		public NativeMethodPointer BindStaticMethodPtr(string typeName, string methodName, int signatureId)
+		{
+			lock (_writeLock)
+			{
+				Type type = GetPluginType(typeName);
+				Signature sig = GetSignature(signatureId);
+				var method = GetMethod(type, methodName, signatureId, sig, isStatic: true);
+
+				return CreatePointerBinding(null, method, sig, _staticPointerTargets);
+			}
+		}
+
+		private NativeMethodPointer BindInstanceMethodPtr(InstanceRecord record, string methodName, int signatureId)
+		{
 			Signature sig = GetSignature(signatureId);
-			var method = FindMethod(type, methodName, sig.ParameterTypes, isStatic: true);
-			EnsureReturnType(method, sig.ReturnType);
+			var method = GetMethod(record.Instance.GetType(), methodName, signatureId, sig, isStatic: false);
 
-			int id = _nextMethodId++;
-			_methods.Add(id, new MethodBinding(null, method, sig));
-			return id;
+			return CreatePointerBinding(record.Instance, method, sig, record.PointerTargets ??= new List<GCHandle>());
+		}
+
+		private InstanceRecord GetInstance(int instanceId)
+		{
+			if (!_instances.TryGetValue(instanceId, out var record))
+			{
+				throw new KeyNotFoundException($"Instance id not found or destroyed: {instanceId}");
+			}
+
+			return record;
+		}
+
+		// The GUID map is only read under the write lock.
+		private InstanceRecord GetInstance(Guid instanceId)
+		{
+			if (!_instancesByGuid.TryGetValue(instanceId, out int handle) || !_instances.TryGetValue(handle, out var record))
+			{
+				throw new KeyNotFoundException($"Instance guid not found: {instanceId}");
+			}
+
+			return record;
+		}
+
+		private NativeMethodPointer CreatePointerBinding(object? target, MethodInfo method, Signature sig, List<GCHandle> owner)
+		{
+			// The trampoline is shared per signature shape; the closed delegate carries the target.
+			Type delegateType = NativeTrampolineCompiler.GetDelegateType(sig.ReturnType, sig.ParameterTypes);
+			Delegate callee = method.CreateDelegate(delegateType, target);
+			IntPtr function = _trampolines.GetTrampoline(delegateType);
+
+			var handle = GCHandle.Alloc(callee);
+			owner.Add(handle);
+			return new NativeMethodPointer { Function = function, Target = GCHandle.ToIntPtr(handle) };
+		}
+
+		private static void FreeHandles(List<GCHandle> handles)
+		{
+			foreach (var handle in handles)
+			{
+				handle.Free();
+			}
+			handles.Clear();
 		}
 
 		public void Invoke(int methodId, IntPtr argsPtr, int argCount, IntPtr returnPtr)
 		{
-			if (!_methods.TryGetValue(methodId, out var binding))
+			var binding = GetBinding(methodId);
+			EnsureArgumentCount(binding, argCount);
+
+			InvokeBinding(binding, methodId, argsPtr, returnPtr);
+		}
+
+		// Invokes a type-level binding on the given instance, which must be of the bound type or derive from it.
+		public void InvokeOn(int methodId, int instanceId, IntPtr argsPtr, int argCount, IntPtr returnPtr)
+		{
+			var binding = GetBinding(methodId);
+			EnsureArgumentCount(binding, argCount);
+
+			InvokeOnBinding(binding, methodId, instanceId, argsPtr, returnPtr);
+		}
+
+		private void InvokeOnBinding(in MethodBinding binding, int methodId, int instanceId, IntPtr argsPtr, IntPtr returnPtr)
+		{
+			if (binding.InstanceType == null)
+			{
+				throw new InvalidOperationException($"Method {methodId} is not a type-level binding; use Invoke");
+			}
+
+			object instance = GetInstance(instanceId).Instance;
+			if (!binding.InstanceType.IsInstanceOfType(instance))
+			{
+				throw new ArgumentException($"Instance {instanceId} ({instance.GetType().FullName}) is not a {binding.InstanceType.FullName}");
+			}
+
+			if (returnPtr == IntPtr.Zero && binding.Signature.ReturnKind != InteropKind.Void)
 			{
-				throw new KeyNotFoundException($"Method id not found: {methodId}");
+				throw new ArgumentException("Return pointer must be non-null for non-void return");
 			}
 
+			RunThunk(binding, methodId, instance, argsPtr, returnPtr);
+		}
+
+		private static void EnsureArgumentCount(in MethodBinding binding, int argCount)
+		{
 			var sig = binding.Signature;
 			if (argCount != sig.ParameterTypes.Length)
 			{
 				throw new ArgumentException($"Argument count mismatch. Expected {sig.ParameterTypes.Length}, got {argCount}");
 			}
+		}
 
-			object?[] args = argCount == 0 ? Array.Empty<object?>() : new object?[argCount];
-			for (int i = 0; i < argCount; i++)
+		// Runs callCount invokes in one managed loop. argsPerCall[i] is the args array of call i,
+		// or argsPerCall[0] is used for every call when sharedArgs is set; each args array must hold
+		// one pointer per parameter of the bound signature. returns and statuses are optional arrays.
+		// Returns the number of calls that succeeded; the first failure is reported through firstError.
+		public unsafe int InvokeBatch(IntPtr methodIdsPtr, IntPtr argsPerCallPtr, int callCount, IntPtr returnsPtr, IntPtr statusesPtr, bool sharedArgs, out Exception? firstError)
+		{
+			var methodIds = (int*)methodIdsPtr;
+			var argsPerCall = (IntPtr*)argsPerCallPtr;
+			var returns = (IntPtr*)returnsPtr;
+			var statuses = (int*)statusesPtr;
+
+			IntPtr shared = sharedArgs && argsPerCall != null ? argsPerCall[0] : IntPtr.Zero;
+			int succeeded = 0;
+			firstError = null;
+
+			for (int i = 0; i < callCount; i++)
 			{
-				IntPtr argValuePtr = Marshal.ReadIntPtr(argsPtr, i * IntPtr.Size);
-				args[i] = ReadValueFromPointer(sig.ParameterTypes[i], argValuePtr);
+				IntPtr argsPtr = sharedArgs ? shared : (argsPerCall != null ? argsPerCall[i] : IntPtr.Zero);
+				IntPtr returnPtr = returns != null ? returns[i] : IntPtr.Zero;
+
+				int status = 0;
+				try
+				{
+					InvokeBinding(GetBinding(methodIds[i]), methodIds[i], argsPtr, returnPtr);
+					status = 1;
+					succeeded++;
+				}
+				catch (Exception ex)
+				{
+					firstError ??= ex;
+				}
+
+				if (statuses != null)
+				{
+					statuses[i] = status;
+				}
 			}
 
-			object? result = binding.Method.Invoke(binding.Target, args);
-			WriteReturnValueToPointer(sig.ReturnType, result, returnPtr);
+			return succeeded;
+		}
+
+		// Runs callCount (method, instance) pairs in one managed loop, all with the same arguments and no
+		// return value. instanceIds[i] is the target of a type-level binding, or 0 for a binding that has
+		// its own target; instanceIdsPtr may be null if no call needs one. Returns the number of calls
+		// that succeeded; the first failure is reported through firstError.
+		public unsafe int InvokeOnBatch(IntPtr methodIdsPtr, IntPtr instanceIdsPtr, int callCount, IntPtr argsPtr, IntPtr statusesPtr, out Exception? firstError)
+		{
+			var methodIds = (int*)methodIdsPtr;
+			var instanceIds = (int*)instanceIdsPtr;
+			var statuses = (int*)statusesPtr;
+			int succeeded = 0;
+			firstError = null;
+
+			for (int i = 0; i < callCount; i++)
+			{
+				int status = 0;
+				try
+				{
+					var binding = GetBinding(methodIds[i]);
+					int instanceId = instanceIds != null ? instanceIds[i] : 0;
+					if (instanceId == 0)
+					{
+						InvokeBinding(binding, methodIds[i], argsPtr, IntPtr.Zero);
+					}
+					else
+					{
+						InvokeOnBinding(binding, methodIds[i], instanceId, argsPtr, IntPtr.Zero);
+					}
+
+					status = 1;
+					succeeded++;
+				}
+				catch (Exception ex)
+				{
+					firstError ??= ex;
+				}
+
+				if (statuses != null)
+				{
+					statuses[i] = status;
+				}
+			}
+
+			return succeeded;
+		}
+
+		// A call may run concurrently with other parallel-safe calls if its method, or the class of the
+		// instance it runs on, is marked [ParallelSafe]. instanceId is only used for type-level bindings.
+		public bool IsParallelSafe(int methodId, int instanceId)
+		{
+			var binding = GetBinding(methodId);
+			if (binding.Method.IsDefined(typeof(ParallelSafeAttribute), inherit: true))
+			{
+				return true;
+			}
+
+			object? target = binding.InstanceType != null ? GetInstance(instanceId).Instance : binding.Target;
+			Type type = target?.GetType() ?? binding.Method.DeclaringType!;
+			return type.IsDefined(typeof(ParallelSafeAttribute), inherit: true);
+		}
+
+		private MethodBinding GetBinding(int methodId)
+		{
+			if (!_methods.TryGetValue(methodId, out var binding))
+			{
+				throw new KeyNotFoundException($"Method id not found or unbound: {methodId}");
+			}
+
+			return binding;
+		}
+
+		private static void InvokeBinding(in MethodBinding binding, int methodId, IntPtr argsPtr, IntPtr returnPtr)
+		{
+			if (binding.InstanceType != null)
+			{
+				throw new InvalidOperationException($"{binding.Method.Name} is bound to type {binding.InstanceType.FullName}; use InvokeOn");
+			}
+
+			if (returnPtr == IntPtr.Zero && binding.Signature.ReturnKind != InteropKind.Void)
+			{
+				throw new ArgumentException("Return pointer must be non-null for non-void return");
+			}
+
+			RunThunk(binding, methodId, binding.Target, argsPtr, returnPtr);
+		}
+
+		private static void RunThunk(in MethodBinding binding, int methodId, object? target, IntPtr argsPtr, IntPtr returnPtr)
+		{
+			CallProfiler? profiler = CallProfiler.Active;
+			if (profiler == null && !Tracer.IsEnabled)
+			{
+				binding.Thunk(target, argsPtr, returnPtr);
+				return;
+			}
+
+			RunInstrumented(profiler, binding.Thunk, binding.Method, methodId, target, argsPtr, returnPtr);
+		}
+
+		private static void RunInstrumented(CallProfiler? profiler, InvokeThunk thunk, MethodInfo method, int methodId, object? target, IntPtr argsPtr, IntPtr returnPtr)
+		{
+			long traceBegin = Tracer.IsEnabled ? Tracer.NowNs() : 0;
+			try
+			{
+				if (profiler != null)
+				{
+					profiler.Invoke(methodId, method, thunk, target, argsPtr, returnPtr);
+				}
+				else
+				{
+					thunk(target, argsPtr, returnPtr);
+				}
+			}
+			finally
+			{
+				if (traceBegin != 0)
+				{
+					Tracer.Record(TraceEventKind.Invoke, traceBegin, Tracer.NowNs(), methodId);
+				}
+			}
+		}
+
+		// "Namespace.Type.Method" of a bound method handle, for reports; null if it is not bound.
+		public string? DescribeMethod(int methodId)
+		{
+			if (!_methods.TryGetValue(methodId, out var binding))
+			{
+				return null;
+			}
+
+			return DescribeMethod(binding.Method);
+		}
+
+		public static string DescribeMethod(MethodInfo method)
+		{
+			return $"{method.DeclaringType?.FullName}.{method.Name}";
+		}
+
+		private int AddBinding(InstanceRecord? owner, MethodInfo method, Signature sig, Type? instanceType = null)
+		{
+			InvokeThunk? thunk;
+			if (InvokeThunkCompiler.Mode == InvokeMode.Reflection)
+			{
+				thunk = InvokeThunkCompiler.CreateReflectionInvoker(method, sig.ReturnType, sig.ReturnKind, sig.ParameterTypes, sig.ParameterKinds);
+			}
+			// Thunks are shared by every binding of the same method; compiling one costs far more than a bind.
+			else if (!_thunks.TryGetValue(method, out thunk))
+			{
+				thunk = InvokeThunkCompiler.Compile(method, sig.ReturnType, sig.ReturnKind, sig.ParameterTypes, sig.ParameterKinds);
+				_thunks.Add(method, thunk);
+			}
+
+			int methodId = _methods.Add(new MethodBinding(owner, instanceType, method, sig, thunk));
+			CallProfiler.Active?.Claim(methodId, method);
+			return methodId;
 		}
 
 		private Signature GetSignature(int signatureId)
@@ -265,6 +788,92 @@ namespace MochiSharp.Managed.Core
 			return sig;
 		}
 
+		public string PluginPath => _pluginPath;
+
+		public MetadataCacheStats MetadataStats
+		{
+			get
+			{
+				lock (_writeLock)
+				{
+					return _metadata.Stats;
+				}
+			}
+		}
+
+		// Resolves script types into the metadata cache and compiles their methods ahead of the first call,
+		// typically on a loading thread before the context is published. Types that cannot be resolved
+		// are logged and skipped. Returns the number of methods compiled.
+		public int Preload(IEnumerable<string> typeNames)
+		{
+			int prepared = 0;
+			foreach (string typeName in typeNames)
+			{
+				Type type;
+				try
+				{
+					lock (_writeLock)
+					{
+						type = GetPluginType(typeName);
+					}
+				}
+				catch (TypeLoadException ex)
+				{
+					Logger.Write(LogLevel.Warning, LogCategory.Core, $"Preload: {ex.Message}");
+					continue;
+				}
+
+				const BindingFlags flags = BindingFlags.Instance | BindingFlags.Static | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly;
+				foreach (var method in type.GetMethods(flags))
+				{
+					if (method.IsAbstract || method.ContainsGenericParameters)
+					{
+						continue;
+					}
+
+					RuntimeHelpers.PrepareMethod(method.MethodHandle);
+					prepared++;
+				}
+			}
+
+			return prepared;
+		}
+
+		private MethodInfo GetMethod(Type type, string methodName, int signatureId, in Signature sig, bool isStatic)
+		{
+			if (_metadata.TryGetMethod(type, methodName, signatureId, isStatic, out var method))
+			{
+				return method;
+			}
+
+			method = FindMethod(type, methodName, sig.ParameterTypes, isStatic);
+			EnsureReturnType(method, sig.ReturnType);
+			_metadata.AddMethod(type, methodName, signatureId, isStatic, method);
+			return method;
+		}
+
+		private Type GetPluginType(string typeName)
+		{
+			if (!_metadata.TryGetPluginType(typeName, out var type))
+			{
+				type = ResolvePluginType(typeName);
+				_metadata.AddPluginType(typeName, type);
+			}
+
+			return type;
+		}
+
+		private Type GetSignatureType(string typeName)
+		{
+			if (!_metadata.TryGetSignatureType(typeName, out var type))
+			{
+				type = ResolveType(typeName);
+				_metadata.AddSignatureType(typeName, type);
+			}
+
+			return type;
+		}
+
 		private static void EnsureReturnType(MethodInfo method, Type expectedReturnType)
 		{
 			if (method.ReturnType != expectedReturnType)
@@ -400,77 +1009,6 @@ namespace MochiSharp.Managed.Core
 
 			throw new TypeLoadException($"Unable to resolve type: {typeName}");
 		}
-
-		private static object ReadValueFromPointer(Type type, IntPtr ptr)
-		{
-			if (type == typeof(int))
-			{
-				return Marshal.ReadInt32(ptr);
-			}
-
-			if (type == typeof(float))
-			{
-				return Marshal.PtrToStructure<float>(ptr);
-			}
-
-			if (type == typeof(bool))
-			{
-				return Marshal.ReadInt32(ptr) != 0;
-			}
-
-			if (type.IsValueType)
-			{
-				return Marshal.PtrToStructure(ptr, type) ?? throw new InvalidOperationException($"Failed to marshal {type}");
-			}
-
-			throw new NotSupportedException($"Unsupported parameter type: {type}");
-		}
-
-		private static void WriteReturnValueToPointer(Type returnType, object? result, IntPtr returnPtr)
-		{
-			if (returnType == typeof(void))
-			{
-				return;
-			}
-
-			if (returnPtr == IntPtr.Zero)
-			{
-				throw new ArgumentException("Return pointer must be non-null for non-void return");
-			}
-
-			if (returnType == typeof(int))
-			{
-				Marshal.WriteInt32(returnPtr, result is int i ? i : 0);
-				return;
-			}
-
-			if (returnType == typeof(float))
-			{
-				float f = result is float ff ? ff : 0.0f;
-				Marshal.StructureToPtr(f, returnPtr, fDeleteOld: false);
-				return;
-			}
-
-			if (returnType == typeof(bool))
-			{
-				bool b = result is bool bb && bb;
-				Marshal.WriteInt32(returnPtr, b ? 1 : 0);
-				return;
-			}
-
-			if (returnType.IsValueType)
-			{
-				if (result == null)
-				{
-					throw new InvalidOperationException($"Method returned null for value type {returnType}");
-				}
-
-				Marshal.StructureToPtr(result, returnPtr, fDeleteOld: false);
-				return;
-			}
-
-			throw new NotSupportedException($"Unsupported return type: {returnType}");
-		}
 	}
 }
 
@@ -0,0 +1,163 @@
+using System;
+using System.Collections.Concurrent;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Native arrays registered by the host under a name (DotNetHost::RegisterBuffer), shared with scripts
+	// without copying. Registrations live in the core, so they survive script reloads.
+	//
+	// Each registration is published as one immutable view. Registering the same name again (after the
+	// host resized or moved the array) or unregistering it publishes a new view with the next
+	// generation; handles pick it up on their next access. Spans and refs taken from the old view point
+	// at the old memory, so scripts must not keep them across frames, and the host must only resize
+	// between frames.
+	internal static class SharedBuffers
+	{
+		private static readonly ConcurrentDictionary<string, SharedBufferSlot> _slots = new(StringComparer.Ordinal);
+
+		public static SharedBufferSlot GetSlot(string name) => _slots.GetOrAdd(name, static n => new SharedBufferSlot(n));
+
+		// Returns the new generation.
+		public static uint Register(string name, IntPtr data, string? elementTypeName, int stride, int count)
+		{
+			ArgumentOutOfRangeException.ThrowIfNegativeOrZero(stride);
+			ArgumentOutOfRangeException.ThrowIfNegative(count);
+			if (data == IntPtr.Zero && count != 0)
+			{
+				throw new ArgumentException("A non-empty buffer needs data", nameof(data));
+			}
+
+			return GetSlot(name).Publish(data, elementTypeName, stride, count);
+		}
+
+		public static uint Unregister(string name) => GetSlot(name).Publish(IntPtr.Zero, null, 1, 0);
+	}
+
+	internal sealed class SharedBufferView
+	{
+		public static readonly SharedBufferView Empty = new(IntPtr.Zero, null, 1, 0, 0);
+
+		public readonly IntPtr Data;
+		public readonly string? ElementTypeName;
+		public readonly int Stride;
+		public readonly int Count;
+		public readonly uint Generation;
+		// Type handle of the last element type checked against ElementTypeName; a race only repeats the
+		// check. Not the Type itself: views outlive script contexts, and a script struct's Type would keep
+		// its collectible context from unloading.
+		public nint Validated;
+
+		public SharedBufferView(IntPtr data, string? elementTypeName, int stride, int count, uint generation)
+		{
+			Data = data;
+			ElementTypeName = elementTypeName;
+			Stride = stride;
+			Count = count;
+			Generation = generation;
+		}
+	}
+
+	internal sealed class SharedBufferSlot
+	{
+		public readonly string Name;
+		private SharedBufferView _view = SharedBufferView.Empty;
+		private readonly object _publishLock = new();
+
+		public SharedBufferSlot(string name)
+		{
+			Name = name;
+		}
+
+		public SharedBufferView View => Volatile.Read(ref _view);
+
+		public uint Publish(IntPtr data, string? elementTypeName, int stride, int count)
+		{
+			lock (_publishLock)
+			{
+				uint generation = _view.Generation + 1;
+				Volatile.Write(ref _view, new SharedBufferView(data, elementTypeName, stride, count, generation));
+				return generation;
+			}
+		}
+	}
+
+	// A script's handle to a shared buffer, e.g. SharedBuffer<Transform>.Get("Transforms")[entity].
+	// Cheap to copy and safe to keep in a static field; it may be taken before the host registers the
+	// buffer, which then reads as empty. Elements are read and written in place in native memory.
+	public readonly unsafe struct SharedBuffer<T> where T : unmanaged
+	{
+		private readonly SharedBufferSlot _slot;
+
+		private SharedBuffer(SharedBufferSlot slot)
+		{
+			_slot = slot;
+		}
+
+		public static SharedBuffer<T> Get(string name) => new(SharedBuffers.GetSlot(name));
+
+		public string Name => _slot.Name;
+		public int Count => _slot.View.Count;
+		// Changes whenever the host registers the buffer again or unregisters it.
+		public uint Generation => _slot.View.Generation;
+		public bool IsRegistered => _slot.View.Data != IntPtr.Zero;
+
+		public bool Contains(int index) => (uint)index < (uint)_slot.View.Count;
+
+		public ref T this[int index]
+		{
+			get
+			{
+				SharedBufferView view = Validate(_slot.View);
+				if ((uint)index >= (uint)view.Count)
+				{
+					throw new IndexOutOfRangeException($"Index {index} is out of range for shared buffer '{_slot.Name}' ({view.Count} elements)");
+				}
+
+				return ref Unsafe.AsRef<T>((byte*)view.Data + (nint)index * view.Stride);
+			}
+		}
+
+		// Only for tightly packed buffers (stride == sizeof(T)). Do not keep the span across frames.
+		public Span<T> AsSpan()
+		{
+			SharedBufferView view = Validate(_slot.View);
+			if (view.Stride != sizeof(T))
+			{
+				throw new InvalidOperationException($"Shared buffer '{_slot.Name}' has a stride of {view.Stride} bytes; {typeof(T).Name} is {sizeof(T)}. Use the indexer.");
+			}
+
+			return new Span<T>((void*)view.Data, view.Count);
+		}
+
+		private SharedBufferView Validate(SharedBufferView view)
+		{
+			if (view.Count == 0)
+			{
+				return view;
+			}
+
+			// Checked on every access, since a handle left by an unloaded type can be reused by a new one.
+			if (sizeof(T) > view.Stride)
+			{
+				throw new InvalidOperationException($"{typeof(T).Name} ({sizeof(T)} bytes) does not fit the {view.Stride}-byte elements of shared buffer '{_slot.Name}'");
+			}
+
+			nint type = typeof(T).TypeHandle.Value;
+			if (view.Validated != type)
+			{
+				// The host names the element type like a signature type; compare without the assembly.
+				string? registered = view.ElementTypeName?.Split(',', 2)[0].Trim();
+				if (registered != null && registered != typeof(T).FullName)
+				{
+					throw new InvalidOperationException($"Shared buffer '{_slot.Name}' holds {registered}, not {typeof(T).FullName}");
+				}
+
+				view.Validated = type;
+			}
+
+			return view;
+		}
+	}
+}
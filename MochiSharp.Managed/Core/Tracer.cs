@@ -0,0 +1,369 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Diagnostics.Tracing;
+using System.Runtime.InteropServices;
+using System.Text.Unicode;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Values match MochiSharp::TraceEventKind.
+	public enum TraceEventKind
+	{
+		Native = 0,
+		Invoke = 1,
+		InvokeBatch = 2,
+		CreateInstance = 3,
+		DestroyInstance = 4,
+		Bind = 5,
+		LoadAssembly = 6,
+		Reload = 7,
+		Unload = 8,
+		GCPause = 9,
+	}
+
+	// One complete span (layout matches MochiSharp::TraceEvent). Name is a Tracer name id, 0 for none.
+	[StructLayout(LayoutKind.Sequential)]
+	public struct TraceEvent
+	{
+		public long BeginNs;
+		public long EndNs;
+		public ulong Name;
+		public uint ThreadId;
+		public TraceEventKind Kind;
+		public int Arg;
+		public int Count;
+	}
+
+	// Records the time until Dispose as one event: using var trace = Tracer.Begin(kind).
+	internal readonly ref struct TraceSpan
+	{
+		private readonly TraceEventKind _kind;
+		private readonly long _beginNs;
+		private readonly int _count;
+
+		public TraceSpan(TraceEventKind kind, long beginNs, int count)
+		{
+			_kind = kind;
+			_beginNs = beginNs;
+			_count = count;
+		}
+
+		public void Dispose()
+		{
+			if (_beginNs != 0)
+			{
+				Tracer.Record(_kind, _beginNs, Tracer.NowNs(), count: _count);
+			}
+		}
+	}
+
+	// Managed half of the host's timeline trace (see Trace.h). Each thread records into its own ring
+	// buffer without locks; DotNetHost::WriteTrace drains them through DrainTrace. Timestamps use the
+	// native clock, and threads are identified by OS thread id through the host's CurrentThreadId, so
+	// managed and native events share tracks. GC pauses come from the runtime's GC events, which an
+	// in-process EventListener receives a little after the fact; they are placed on track 0. A buffer is
+	// reused once its thread has exited and Drain has read it.
+	internal static unsafe class Tracer
+	{
+		// Single producer (its thread), single consumer (Drain, under _lock).
+		private sealed class ThreadBuffer
+		{
+			public readonly uint ThreadId;
+			public readonly TraceEvent[] Events;
+			public readonly int Mask;
+			public long Write;
+			public long Read;
+			public long Dropped;
+			// Set once the thread has exited; it records nothing after that.
+			public bool Exited;
+
+			public ThreadBuffer(uint threadId, TraceEvent[] events)
+			{
+				ThreadId = threadId;
+				Events = events;
+				Mask = events.Length - 1;
+			}
+		}
+
+		// Only referenced by its thread's [ThreadStatic], so it is finalized after the thread exits.
+		private sealed class ThreadBufferOwner
+		{
+			private readonly ThreadBuffer _buffer;
+
+			public ThreadBufferOwner(ThreadBuffer buffer)
+			{
+				_buffer = buffer;
+			}
+
+			~ThreadBufferOwner()
+			{
+				Volatile.Write(ref _buffer.Exited, true);
+			}
+		}
+
+		private static volatile bool _enabled;
+		private static int _eventsPerThread = 1 << 16;
+		private static readonly object _lock = new();
+		private static readonly List<ThreadBuffer> _buffers = new();
+		// Event arrays of exited threads' buffers, _eventsPerThread long, for the next threads to register.
+		private static readonly Stack<TraceEvent[]> _freeEvents = new();
+		[ThreadStatic]
+		private static ThreadBuffer? t_buffer;
+		[ThreadStatic]
+		private static ThreadBufferOwner? t_owner;
+
+		private static delegate* unmanaged<uint> _currentThreadId;
+		private static delegate* unmanaged<uint, IntPtr, void> _nameThread;
+		private static GCPauseListener? _gcListener;
+
+		// Event names handed to native code by id (index + 1); only touched under _lock.
+		private static readonly List<string> _names = new();
+		private static readonly Dictionary<string, int> _nameIds = new(StringComparer.Ordinal);
+
+		public static bool IsEnabled => _enabled;
+
+		// Same arithmetic as steady_clock on the native side, so both produce the same nanoseconds.
+		public static long NowNs()
+		{
+			long ticks = Stopwatch.GetTimestamp();
+			long frequency = Stopwatch.Frequency;
+			return ticks / frequency * 1_000_000_000 + ticks % frequency * 1_000_000_000 / frequency;
+		}
+
+		public static TraceSpan Begin(TraceEventKind kind, int count = 0)
+		{
+			return _enabled ? new TraceSpan(kind, NowNs(), count) : default;
+		}
+
+		// eventsPerThread is rounded up to a power of two and fixed for a thread when it first records.
+		public static void Start(int eventsPerThread, IntPtr currentThreadId, IntPtr nameThread)
+		{
+			lock (_lock)
+			{
+				_currentThreadId = (delegate* unmanaged<uint>)currentThreadId;
+				_nameThread = (delegate* unmanaged<uint, IntPtr, void>)nameThread;
+				int capacity = (int)Math.Min(System.Numerics.BitOperations.RoundUpToPowerOf2((uint)Math.Max(eventsPerThread, 16)), 1u << 24);
+				if (capacity != _eventsPerThread)
+				{
+					_freeEvents.Clear();
+				}
+				_eventsPerThread = capacity;
+				foreach (var buffer in _buffers)
+				{
+					Volatile.Write(ref buffer.Read, Volatile.Read(ref buffer.Write));
+					buffer.Dropped = 0;
+				}
+
+				_gcListener ??= new GCPauseListener();
+				_enabled = true;
+			}
+		}
+
+		public static void Stop()
+		{
+			lock (_lock)
+			{
+				_enabled = false;
+				_gcListener?.Dispose();
+				_gcListener = null;
+			}
+		}
+
+		public static void Record(TraceEventKind kind, long beginNs, long endNs, int arg = 0, int count = 0)
+		{
+			if (!_enabled)
+			{
+				return;
+			}
+
+			ThreadBuffer buffer = t_buffer ?? RegisterThread();
+			Append(buffer, new TraceEvent { BeginNs = beginNs, EndNs = endNs, ThreadId = buffer.ThreadId, Kind = kind, Arg = arg, Count = count });
+		}
+
+		private static void Append(ThreadBuffer buffer, in TraceEvent traceEvent)
+		{
+			long write = buffer.Write;
+			if (write - Volatile.Read(ref buffer.Read) > buffer.Mask)
+			{
+				Interlocked.Increment(ref buffer.Dropped);
+				return;
+			}
+
+			buffer.Events[write & buffer.Mask] = traceEvent;
+			Volatile.Write(ref buffer.Write, write + 1);
+		}
+
+		private static ThreadBuffer RegisterThread()
+		{
+			uint threadId = _currentThreadId != null ? _currentThreadId() : (uint)Environment.CurrentManagedThreadId;
+			ThreadBuffer buffer;
+			lock (_lock)
+			{
+				buffer = new ThreadBuffer(threadId, _freeEvents.TryPop(out var events) ? events : new TraceEvent[_eventsPerThread]);
+				_buffers.Add(buffer);
+			}
+
+			if (_nameThread != null)
+			{
+				string name = Thread.CurrentThread.Name ?? $".NET thread {Environment.CurrentManagedThreadId}";
+				IntPtr utf8 = Marshal.StringToCoTaskMemUTF8(name);
+				_nameThread(threadId, utf8);
+				Marshal.FreeCoTaskMem(utf8);
+			}
+
+			t_buffer = buffer;
+			t_owner = new ThreadBufferOwner(buffer);
+			return buffer;
+		}
+
+		// Moves up to capacity events to output and returns how many it wrote; call until it returns
+		// less than capacity. Invoke events are named through describe(method handle).
+		public static int Drain(TraceEvent* output, int capacity, Func<int, string?> describe)
+		{
+			lock (_lock)
+			{
+				int written = 0;
+				long dropped = 0;
+				for (int i = 0; i < _buffers.Count;)
+				{
+					ThreadBuffer buffer = _buffers[i];
+					// Read before Write: once the thread has exited, this pass can reach its last event.
+					bool exited = Volatile.Read(ref buffer.Exited);
+					long read = buffer.Read;
+					long write = Volatile.Read(ref buffer.Write);
+					for (; read != write && written < capacity; read++)
+					{
+						TraceEvent traceEvent = buffer.Events[read & buffer.Mask];
+						if (traceEvent.Kind == TraceEventKind.Invoke)
+						{
+							traceEvent.Name = (ulong)Intern(describe(traceEvent.Arg) ?? $"(unbound method {traceEvent.Arg})");
+						}
+						output[written++] = traceEvent;
+					}
+					Volatile.Write(ref buffer.Read, read);
+					dropped += Interlocked.Exchange(ref buffer.Dropped, 0);
+
+					if (!exited || read != write)
+					{
+						i++;
+						continue;
+					}
+
+					if (buffer.Events.Length == _eventsPerThread)
+					{
+						_freeEvents.Push(buffer.Events);
+					}
+					_buffers[i] = _buffers[^1];
+					_buffers.RemoveAt(_buffers.Count - 1);
+				}
+
+				if (dropped > 0)
+				{
+					Logger.Write(LogLevel.Warning, LogCategory.Core, $"Trace: {dropped} managed events dropped; drain more often or start with a larger buffer");
+				}
+				return written;
+			}
+		}
+
+		// Writes the UTF-8 name for id to buffer (null-terminated, truncated to size) and returns its full
+		// length in bytes, or -1 for an unknown id.
+		public static int GetName(int id, byte* buffer, int size)
+		{
+			string name;
+			lock (_lock)
+			{
+				if (id <= 0 || id > _names.Count)
+				{
+					return -1;
+				}
+				name = _names[id - 1];
+			}
+
+			if (buffer != null && size > 0)
+			{
+				var destination = new Span<byte>(buffer, size);
+				Utf8.FromUtf16(name, destination[..^1], out _, out int written);
+				destination[written] = 0;
+			}
+			return System.Text.Encoding.UTF8.GetByteCount(name);
+		}
+
+		private static int Intern(string name)
+		{
+			if (!_nameIds.TryGetValue(name, out int id))
+			{
+				_names.Add(name);
+				id = _names.Count;
+				_nameIds.Add(name, id);
+			}
+			return id;
+		}
+
+		private static void RecordGCPause(long beginNs, long endNs, int generation)
+		{
+			if (!_enabled)
+			{
+				return;
+			}
+
+			ThreadBuffer buffer = t_buffer ?? RegisterThread();
+			Append(buffer, new TraceEvent { BeginNs = beginNs, EndNs = endNs, ThreadId = 0, Kind = TraceEventKind.GCPause, Arg = generation });
+		}
+
+		// Turns the runtime's suspend/restart events into pauses. Arg is the generation collected, or -1
+		// for a suspension without a collection.
+		private sealed class GCPauseListener : EventListener
+		{
+			private const int GCStartEvent = 1;
+			private const int GCRestartEEEndEvent = 3;
+			private const int GCSuspendEEBeginEvent = 9;
+			private const long GCKeyword = 0x1;
+
+			// Event timestamps are DateTime; this maps them onto the trace clock. Initializers run before the
+			// base constructor, which may already deliver events.
+			private readonly long _baseUtcTicks = DateTime.UtcNow.Ticks;
+			private readonly long _baseNs = NowNs();
+
+			private long _suspendNs;
+			private int _generation = -1;
+
+			protected override void OnEventSourceCreated(EventSource eventSource)
+			{
+				if (eventSource.Name == "Microsoft-Windows-DotNETRuntime")
+				{
+					EnableEvents(eventSource, EventLevel.Informational, (EventKeywords)GCKeyword);
+				}
+			}
+
+			protected override void OnEventWritten(EventWrittenEventArgs eventData)
+			{
+				long ns = _baseNs + (eventData.TimeStamp.ToUniversalTime().Ticks - _baseUtcTicks) * 100;
+				switch (eventData.EventId)
+				{
+				case GCSuspendEEBeginEvent:
+					_suspendNs = ns;
+					_generation = -1;
+					break;
+				case GCStartEvent:
+				{
+					int index = eventData.PayloadNames?.IndexOf("Depth") ?? -1;
+					if (index >= 0 && eventData.Payload?[index] is uint depth)
+					{
+						_generation = (int)depth;
+					}
+					break;
+				}
+				case GCRestartEEEndEvent:
+					if (_suspendNs != 0)
+					{
+						RecordGCPause(_suspendNs, ns, _generation);
+						_suspendNs = 0;
+					}
+					break;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,152 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Runtime.Loader;
+using System.Threading;
+
+namespace MochiSharp.Managed.Core
+{
+	// Reported to native code by PollUnload (layout matches MochiSharp::UnloadStatus).
+	[StructLayout(LayoutKind.Sequential)]
+	public struct UnloadStatus
+	{
+		public int Pending;    // unloaded contexts still in memory
+		public int Reclaimed;  // contexts collected since startup
+		public int Leaked;     // pending contexts that outlived LeakCollections full collections
+		public int Retries;    // full collections the oldest pending context has survived
+		public double OldestMs; // time since the oldest pending context was unloaded
+	}
+
+	// Tracks unloaded plugin contexts until the GC reclaims them, without blocking the caller.
+	// A collectible context is only freed after every reference into it is gone, which takes at least
+	// two full collections with the finalizer thread running in between. Poll asks for one background
+	// collection at a time and returns within its budget; a context still alive after LeakCollections
+	// of them is reported as leaked, once, with whatever roots MochiSharp itself can see; leaked contexts
+	// are still checked on every poll but no longer trigger collections.
+	internal sealed class UnloadTracker
+	{
+		public const int LeakCollections = 8;
+
+		private sealed class Entry
+		{
+			public readonly WeakReference Context;
+			public readonly string Name;
+			public readonly string[] Assemblies;
+			public readonly int CollectionsAtUnload;
+			public readonly long UnloadedAt;
+			public bool Leaked;
+
+			public Entry(AssemblyLoadContext context)
+			{
+				Context = new WeakReference(context);
+				Name = context.Name ?? "(unnamed)";
+				Assemblies = context.Assemblies.Select(a => a.GetName().Name ?? "?").ToArray();
+				CollectionsAtUnload = GC.CollectionCount(GC.MaxGeneration);
+				UnloadedAt = Stopwatch.GetTimestamp();
+			}
+		}
+
+		private readonly List<Entry> _pending = new();
+		private readonly object _lock = new();
+		private int _reclaimed;
+		private int _requestedAt = -1;
+
+		// Call right after context.Unload().
+		public void Track(AssemblyLoadContext context)
+		{
+			var entry = new Entry(context);
+			lock (_lock)
+			{
+				_pending.Add(entry);
+			}
+		}
+
+		// describeRoots is asked about a context once, when it is first reported as leaked.
+		public UnloadStatus Poll(double budgetMs, Func<AssemblyLoadContext, string?>? describeRoots = null)
+		{
+			long start = Stopwatch.GetTimestamp();
+			lock (_lock)
+			{
+				while (Sweep(describeRoots) && Stopwatch.GetElapsedTime(start).TotalMilliseconds < budgetMs)
+				{
+					// The background collection and the finalizer thread do the work; give them the core.
+					Thread.Sleep(0);
+				}
+
+				return Status();
+			}
+		}
+
+		// Drops collected contexts and asks for another collection if some are left that have not leaked;
+		// true if any are.
+		private bool Sweep(Func<AssemblyLoadContext, string?>? describeRoots)
+		{
+			int collections = GC.CollectionCount(GC.MaxGeneration);
+			bool collecting = false;
+			for (int i = _pending.Count - 1; i >= 0; i--)
+			{
+				Entry entry = _pending[i];
+				if (!entry.Context.IsAlive)
+				{
+					_pending.RemoveAt(i);
+					_reclaimed++;
+					if (entry.Leaked)
+					{
+						Logger.Write(LogLevel.Info, LogCategory.Core, $"Script context {entry.Name} was reclaimed after {collections - entry.CollectionsAtUnload} collections");
+					}
+				}
+				else if (!entry.Leaked && collections - entry.CollectionsAtUnload >= LeakCollections)
+				{
+					entry.Leaked = true;
+					ReportLeak(entry, collections, describeRoots);
+				}
+
+				collecting |= !entry.Leaked && entry.Context.IsAlive;
+			}
+
+			if (!collecting)
+			{
+				return false;
+			}
+
+			// One request in flight at a time; a full collection has finished once the count moves.
+			if (_requestedAt != collections)
+			{
+				_requestedAt = collections;
+				GC.Collect(GC.MaxGeneration, GCCollectionMode.Forced, blocking: false);
+			}
+
+			return true;
+		}
+
+		private static void ReportLeak(Entry entry, int collections, Func<AssemblyLoadContext, string?>? describeRoots)
+		{
+			string? roots = null;
+			if (describeRoots != null && entry.Context.Target is AssemblyLoadContext context)
+			{
+				roots = describeRoots(context);
+			}
+
+			Logger.Write(LogLevel.Warning, LogCategory.Core,
+				$"Script context {entry.Name} is still alive after {collections - entry.CollectionsAtUnload} full collections " +
+				$"({Stopwatch.GetElapsedTime(entry.UnloadedAt).TotalSeconds:F1} s). Assemblies: {string.Join(", ", entry.Assemblies)}. " +
+				$"Held by: {roots ?? "nothing MochiSharp tracks; look for static fields, events, threads or GCHandles referencing script types"}");
+		}
+
+		private UnloadStatus Status()
+		{
+			var status = new UnloadStatus { Pending = _pending.Count, Reclaimed = _reclaimed };
+			int collections = GC.CollectionCount(GC.MaxGeneration);
+			foreach (Entry entry in _pending)
+			{
+				status.Leaked += entry.Leaked ? 1 : 0;
+				status.Retries = Math.Max(status.Retries, collections - entry.CollectionsAtUnload);
+				status.OldestMs = Math.Max(status.OldestMs, Stopwatch.GetElapsedTime(entry.UnloadedAt).TotalMilliseconds);
+			}
+
+			return status;
+		}
+	}
+}
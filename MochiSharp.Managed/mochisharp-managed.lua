@@ -3,6 +3,7 @@ project "MochiSharp.Managed"
     kind "SharedLib"
     language "C#"
     dotnetframework "net9.0"
+    clr "Unsafe"
 
     -- Don't specify architecture here. (see https://github.com/premake/premake-core/issues/1758)
 
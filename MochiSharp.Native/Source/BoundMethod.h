@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef BOUND_METHOD_H
+#define BOUND_METHOD_H
+
+#include "Host.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+namespace MochiSharp
+{
+    // Compile-time registry of managed type names.
+    // Specialize with MOCHI_MANAGED_TYPE for every struct passed to a typed binding.
+    template<typename T>
+    struct ManagedType
+    {
+        static_assert(sizeof(T) == 0, "No managed type registered for T. Use MOCHI_MANAGED_TYPE(T, \"Namespace.Type, Assembly\").");
+    };
+
+    template<> struct ManagedType<void> { static constexpr const char *Name = "System.Void"; };
+    template<> struct ManagedType<int32_t> { static constexpr const char *Name = "System.Int32"; };
+    template<> struct ManagedType<float> { static constexpr const char *Name = "System.Single"; };
+    template<> struct ManagedType<bool> { static constexpr const char *Name = "System.Boolean"; };
+
+    namespace Detail
+    {
+        // bool crosses the boundary as int32, everything else as-is.
+        template<typename T> struct NativeType { using Type = T; };
+        template<> struct NativeType<bool> { using Type = int32_t; };
+
+        template<typename T>
+        using NativeTypeT = typename NativeType<T>::Type;
+
+        template<typename T>
+        constexpr NativeTypeT<T> ToNative(T value) { return static_cast<NativeTypeT<T>>(value); }
+
+        constexpr uint32_t Fnv1a(const char *text, uint32_t hash = 2166136261u)
+        {
+            while (*text)
+            {
+                hash = (hash ^ static_cast<uint8_t>(*text++)) * 16777619u;
+            }
+            return hash;
+        }
+
+        template<typename T>
+        constexpr bool IsBlittable = !std::is_reference_v<T> && !std::is_pointer_v<T>
+            && std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>;
+    }
+
+    // Signature metadata derived from a function type. Ids live above 0x40000000 so they never collide
+    // with hand-registered signature ids. They are 30-bit hashes, so two function types can share one;
+    // binding the second then fails (see DotNetHost::EnsureSignature).
+    template<typename Sig>
+    struct TypedSignature;
+
+    template<typename R, typename... Args>
+    struct TypedSignature<R(Args...)>
+    {
+        static constexpr const char *ReturnTypeName = ManagedType<R>::Name;
+        static constexpr const char *ParameterTypeNames[] = { ManagedType<Args>::Name..., nullptr };
+        static constexpr int ParameterCount = sizeof...(Args);
+
+        static constexpr int Id = []
+        {
+            uint32_t hash = Detail::Fnv1a(ReturnTypeName);
+            ((hash = Detail::Fnv1a(ManagedType<Args>::Name, Detail::Fnv1a("|", hash))), ...);
+            return static_cast<int>(0x40000000u | (hash & 0x3FFFFFFFu));
+        }();
+
+        static_assert(std::is_void_v<R> || Detail::IsBlittable<R>, "Typed binding return values must be blittable");
+        static_assert((Detail::IsBlittable<Args> && ...), "Typed binding arguments must be blittable and passed by value");
+    };
+
+    // A typed handle to a bound method, calling straight through its NativeMethod trampoline.
+    template<typename Sig>
+    class BoundMethod;
+
+    template<typename R, typename... Args>
+    class BoundMethod<R(Args...)>
+    {
+    public:
+        BoundMethod() = default;
+        explicit BoundMethod(NativeMethod method) : m_Method(method) {}
+
+        R operator()(Args... args) const
+        {
+            if constexpr (std::is_same_v<R, bool>)
+            {
+                return m_Method.Call<int32_t>(Detail::ToNative(args)...) != 0;
+            }
+            else
+            {
+                return m_Method.Call<R>(Detail::ToNative(args)...);
+            }
+        }
+
+        explicit operator bool() const { return static_cast<bool>(m_Method); }
+        const NativeMethod &Native() const { return m_Method; }
+
+    private:
+        NativeMethod m_Method;
+    };
+
+    template<typename Sig>
+    int DotNetHost::EnsureSignature()
+    {
+        using Signature = TypedSignature<Sig>;
+        std::string types = std::string(Signature::ReturnTypeName) + "(";
+        for (int i = 0; i < Signature::ParameterCount; i++)
+        {
+            types += i == 0 ? "" : ", ";
+            types += Signature::ParameterTypeNames[i];
+        }
+        types += ")";
+
+        std::lock_guard lock(m_SignatureMutex);
+        if (auto it = m_TypedSignatures.find(Signature::Id); it != m_TypedSignatures.end())
+        {
+            if (it->second == types)
+            {
+                return Signature::Id;
+            }
+
+            // Ids are hashes; reusing the other signature's registration would call through the wrong types.
+            std::cout << "[C++ Engine] Signature id " << Signature::Id << " of " << types << " collides with " << it->second << "; bind refused\n";
+            return -1;
+        }
+
+        if (!RegisterSignature(Signature::Id, Signature::ReturnTypeName, const_cast<const char **>(Signature::ParameterTypeNames), Signature::ParameterCount))
+        {
+            return -1;
+        }
+
+        m_TypedSignatures.emplace(Signature::Id, std::move(types));
+        return Signature::Id;
+    }
+
+    template<typename Sig>
+    BoundMethod<Sig> DotNetHost::Bind(InstanceHandle instance, const char *methodName)
+    {
+        int signature = EnsureSignature<Sig>();
+        return signature < 0 ? BoundMethod<Sig>() : BoundMethod<Sig>(BindInstanceMethodPtr(instance, methodName, signature));
+    }
+
+    template<typename Sig>
+    BoundMethod<Sig> DotNetHost::Bind(const char *instanceGuid, const char *methodName)
+    {
+        int signature = EnsureSignature<Sig>();
+        return signature < 0 ? BoundMethod<Sig>() : BoundMethod<Sig>(BindInstanceMethodPtrGuid(instanceGuid, methodName, signature));
+    }
+
+    template<typename Sig>
+    BoundMethod<Sig> DotNetHost::Bind(const ScriptGuid &instanceGuid, const char *methodName)
+    {
+        int signature = EnsureSignature<Sig>();
+        return signature < 0 ? BoundMethod<Sig>() : BoundMethod<Sig>(BindInstanceMethodPtrGuid(instanceGuid, methodName, signature));
+    }
+
+    template<typename Sig>
+    BoundMethod<Sig> DotNetHost::BindStatic(const char *typeName, const char *methodName)
+    {
+        int signature = EnsureSignature<Sig>();
+        return signature < 0 ? BoundMethod<Sig>() : BoundMethod<Sig>(BindStaticMethodPtr(typeName, methodName, signature));
+    }
+
+    template<typename Sig>
+    BoundMethod<Sig> DotNetHost::BindStatic(ContextHandle context, const char *typeName, const char *methodName)
+    {
+        int signature = EnsureSignature<Sig>();
+        return signature < 0 ? BoundMethod<Sig>() : BoundMethod<Sig>(BindStaticMethodPtr(context, typeName, methodName, signature));
+    }
+
+    template<typename T>
+    uint32_t DotNetHost::RegisterBuffer(const char *name, T *data, uint32_t count)
+    {
+        static_assert(Detail::IsBlittable<T>, "Shared buffer elements must be blittable");
+        return RegisterBuffer(name, data, ManagedType<T>::Name, sizeof(T), count);
+    }
+}
+
+// Registers the managed name of a native struct, e.g.
+// MOCHI_MANAGED_TYPE(Vector3, "Example.Managed.Interop.Vector3, Example.Managed")
+#define MOCHI_MANAGED_TYPE(NativeType, ManagedName) \
+    template<> struct MochiSharp::ManagedType<NativeType> { static constexpr const char *Name = ManagedName; }
+
+#endif // !BOUND_METHOD_H
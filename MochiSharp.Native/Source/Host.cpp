@@ -3,15 +3,27 @@
 #include "Host.h"
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+#include <cstdlib>
+#include <type_traits>
+#include <algorithm>
+#include <unordered_map>
 #include <assert.h>
 
-#define STR(s) L ## s
-#define CH(c) L ## c
-#define DIR_SEPARATOR L'\\'
+// hostfxr strings are char_t: wchar_t on Windows, UTF-8 char elsewhere.
+#ifdef _WIN32
+    #define STR(s) L ## s
+#else
+    #define STR(s) s
+#endif
 
 hostfxr_initialize_for_runtime_config_fn init_fptr = nullptr;
 hostfxr_get_runtime_delegate_fn get_delegate_fptr = nullptr;
 hostfxr_close_fn close_fptr = nullptr;
+hostfxr_set_runtime_property_value_fn set_property_fptr = nullptr;
+hostfxr_get_runtime_property_value_fn get_property_fptr = nullptr;
 
 #include <filesystem>
 
@@ -26,7 +38,9 @@ static std::filesystem::path GetExecutablePath()
     }
     return std::filesystem::path(std::wstring(buffer, len));
 #else
-    return std::filesystem::current_path();
+    std::error_code error;
+    auto path = std::filesystem::read_symlink("/proc/self/exe", error);
+    return error ? std::filesystem::current_path() : path;
 #endif
 }
 
@@ -53,6 +67,117 @@ static std::filesystem::path ResolvePathRelativeToExecutable(const std::filesyst
     return std::filesystem::current_path() / path;
 }
 
+// Paths in log output are UTF-8 on every platform.
+static std::string PathToUtf8(const std::filesystem::path &path)
+{
+    auto text = path.u8string();
+    return std::string(text.begin(), text.end());
+}
+
+static std::filesystem::path PathFromUtf8(const std::string &text)
+{
+    return std::filesystem::path(std::u8string(text.begin(), text.end()));
+}
+
+// Runtime property names and values are UTF-8 on our side.
+static std::basic_string<char_t> ToCharT(const std::string &text)
+{
+    return PathFromUtf8(text).native();
+}
+
+static std::string FromCharT(const char_t *text)
+{
+    return PathToUtf8(std::filesystem::path(text));
+}
+
+static double MsSince(std::chrono::steady_clock::time_point from)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count();
+}
+
+static void *LoadSharedLibrary(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+    return LoadLibraryW(path.c_str());
+#else
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+static void *GetExport(void *library, const char *name)
+{
+#ifdef _WIN32
+    return reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(library), name));
+#else
+    return dlsym(library, name);
+#endif
+}
+
+static void SetProcessEnvironment(const char *name, const char *value)
+{
+#ifdef _WIN32
+    SetEnvironmentVariableA(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+// HostSettings as runtime properties, applied before the runtime starts.
+static std::vector<std::pair<std::string, std::string>> ToRuntimeProperties(const MochiSharp::HostSettings &settings)
+{
+    std::vector<std::pair<std::string, std::string>> properties;
+    auto add = [&](const char *name, const auto &value)
+    {
+        if (!value)
+        {
+            return;
+        }
+
+        if constexpr (std::is_same_v<std::decay_t<decltype(*value)>, bool>)
+        {
+            properties.emplace_back(name, *value ? "true" : "false");
+        }
+        else
+        {
+            properties.emplace_back(name, std::to_string(*value));
+        }
+    };
+
+    add("System.GC.Server", settings.ServerGC);
+    add("System.GC.Concurrent", settings.ConcurrentGC);
+    add("System.GC.HeapHardLimit", settings.GCHeapHardLimit);
+    add("System.GC.HeapCount", settings.GCHeapCount);
+    if (settings.GCHeapAffinitize)
+    {
+        add("System.GC.NoAffinitize", std::optional<bool>(!*settings.GCHeapAffinitize));
+    }
+    add("System.GC.HeapAffinitizeMask", settings.GCHeapAffinitizeMask);
+    add("System.Runtime.TieredCompilation", settings.TieredCompilation);
+    add("System.Runtime.TieredPGO", settings.TieredPGO);
+    for (const auto &[name, enabled] : settings.AppContextSwitches)
+    {
+        properties.emplace_back(name, enabled ? "true" : "false");
+    }
+    for (const auto &property : settings.RuntimeProperties)
+    {
+        properties.push_back(property);
+    }
+    return properties;
+}
+
+// A .NET install keeps hostfxr at <root>/host/fxr/<version>/; anything else (e.g. a copy next to
+// the executable) leaves the root to hostfxr.
+static std::filesystem::path DotNetRootOf(const std::filesystem::path &hostFxrPath)
+{
+    auto versionDir = hostFxrPath.parent_path();
+    auto fxrDir = versionDir.parent_path();
+    if (fxrDir.filename() == "fxr" && fxrDir.parent_path().filename() == "host")
+    {
+        return fxrDir.parent_path().parent_path();
+    }
+    return {};
+}
+
 namespace MochiSharp
 {
     void DotNetHost::EngineLog(const char *msg)
@@ -60,33 +185,63 @@ namespace MochiSharp
         std::cout << "[C++ Engine] " << msg << "\n";
     }
 
-    bool DotNetHost::Init(const std::wstring &configPath)
+    bool DotNetHost::Init(const std::filesystem::path &configPath, const HostSettings &settings)
     {
+        m_Startup = {};
+        auto initBegin = std::chrono::steady_clock::now();
+
         if (!LoadHostFxr())
         {
             return false;
         }
 
-        auto configFullPath = ResolvePathRelativeToExecutable(std::filesystem::path(configPath));
+        auto configFullPath = ResolvePathRelativeToExecutable(configPath);
         if (!std::filesystem::exists(configFullPath))
         {
-            std::wcout << L"[C++ Engine] runtimeconfig not found: " << configFullPath.wstring() << L"\n";
+            std::cout << "[C++ Engine] runtimeconfig not found: " << PathToUtf8(configFullPath) << "\n";
             return false;
         }
 
         m_BaseDir = configFullPath.parent_path();
 
-        int rc = init_fptr(configFullPath.c_str(), nullptr, &m_Ctx);
+        auto phaseBegin = std::chrono::steady_clock::now();
+        auto hostPath = GetExecutablePath();
+        hostfxr_initialize_parameters parameters = { sizeof(hostfxr_initialize_parameters), hostPath.c_str(), nullptr };
+        if (!m_DotNetRoot.empty())
+        {
+            parameters.dotnet_root = m_DotNetRoot.c_str();
+        }
+
+        int rc = init_fptr(configFullPath.c_str(), &parameters, &m_Ctx);
+        m_Startup.InitRuntimeMs = MsSince(phaseBegin);
         if (rc != 0 || m_Ctx == nullptr)
         {
+            std::cout << "[C++ Engine] hostfxr_initialize_for_runtime_config failed (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
+        // Properties and environment are read when the runtime starts, in get_delegate_fptr below.
+        for (const auto &[name, value] : ToRuntimeProperties(settings))
+        {
+            rc = set_property_fptr(m_Ctx, ToCharT(name).c_str(), ToCharT(value).c_str());
+            if (rc != 0)
+            {
+                std::cout << "[C++ Engine] Failed to set runtime property " << name << "=" << value << " (rc: 0x" << std::hex << rc << std::dec << ")\n";
+                return false;
+            }
+        }
+        if (settings.ReadyToRun)
+        {
+            SetProcessEnvironment("DOTNET_ReadyToRun", *settings.ReadyToRun ? "1" : "0");
+        }
+
+        phaseBegin = std::chrono::steady_clock::now();
         load_assembly_and_get_function_pointer_fn load_assembly_and_get_function_pointer = nullptr;
         rc = get_delegate_fptr(
             m_Ctx,
             hdt_load_assembly_and_get_function_pointer,
             (void **)&load_assembly_and_get_function_pointer);
+        m_Startup.GetDelegateMs = MsSince(phaseBegin);
 
         if (rc != 0 || load_assembly_and_get_function_pointer == nullptr)
         {
@@ -94,305 +249,825 @@ namespace MochiSharp
         }
 
         // Load ManagedCore and get the function pointers
-        auto managedCorePath = (m_BaseDir / L"MochiSharp.Managed.dll");
+        auto managedCorePath = (m_BaseDir / "MochiSharp.Managed.dll");
         if (!std::filesystem::exists(managedCorePath))
         {
-            std::wcout << L"[C++ Engine] MochiSharp.Managed.dll not found: " << managedCorePath.wstring() << L"\n";
+            std::cout << "[C++ Engine] MochiSharp.Managed.dll not found: " << PathToUtf8(managedCorePath) << "\n";
             return false;
         }
 
-        // Get Initialize
+        // Get GetApiTable, which returns every other entry point in one call
+        phaseBegin = std::chrono::steady_clock::now();
+        GetApiTableFn getApiTable = nullptr;
         rc = load_assembly_and_get_function_pointer(
             managedCorePath.c_str(),
             STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("Initialize"),
+            STR("GetApiTable"),
             UNMANAGEDCALLERSONLY_METHOD,
             nullptr,
-            (void **)&ManagedInit);
+            (void **)&getApiTable);
+        m_Startup.LoadCoreMs = MsSince(phaseBegin);
 
-        if (rc != 0 || ManagedInit == nullptr)
+        if (rc != 0 || getApiTable == nullptr)
         {
-            std::cout << "[C++ Engine] Failed to load Initialize function (rc: 0x" << std::hex << rc << std::dec << ")\n";
+            std::cout << "[C++ Engine] Failed to load GetApiTable function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get LoadAssembly
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("LoadAssembly"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedLoadAssembly);
+        phaseBegin = std::chrono::steady_clock::now();
+        ManagedApi api;
+        if (!getApiTable(&api))
+        {
+            std::cout << "[C++ Engine] Managed API version mismatch (host " << ManagedApi::CurrentVersion << ", managed " << api.Version << ")\n";
+            return false;
+        }
 
-        if (rc != 0 || ManagedLoadAssembly == nullptr)
+        if (api.Size < sizeof(ManagedApi))
         {
-            std::cout << "[C++ Engine] Failed to load LoadAssembly function (rc: 0x" << std::hex << rc << std::dec << ")\n";
+            std::cout << "[C++ Engine] Managed API is older than the host (" << api.Size << " of " << sizeof(ManagedApi) << " bytes)\n";
             return false;
         }
 
-        // Get RegisterSignature
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("RegisterSignature"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedRegisterSignature);
+        m_Api = api;
+
+        m_Log.Start();
+
+        // Call Initialize
+        EngineInterface engineApi;
+        engineApi.LogMessage = &EngineLog;
+        engineApi.LogRing = m_Log.Ring();
+        engineApi.EngineApi = m_EngineApi;
+        m_Api.Initialize(&engineApi);
+        m_Startup.ManagedInitMs = MsSince(phaseBegin);
+        m_Startup.TotalMs = MsSince(initBegin);
+
+        return true;
+    }
+
+    std::string DotNetHost::ResolveScriptPath(const char *path) const
+    {
+        std::filesystem::path scriptPath(path);
+        if (!scriptPath.is_absolute())
+        {
+            scriptPath = m_BaseDir / scriptPath;
+        }
+
+        return scriptPath.string();
+    }
 
-        if (rc != 0 || ManagedRegisterSignature == nullptr)
+    // Signatures are kept by the managed core across loads and shared by every context, so
+    // m_TypedSignatures stays valid for the life of the host.
+    bool DotNetHost::LoadAssembly(const char *path)
+    {
+        if (!m_Api.LoadAssembly)
         {
-            std::cout << "[C++ Engine] Failed to load RegisterSignature function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get CreateInstance
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("CreateInstance"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedCreateInstance);
+        auto resolved = ResolveScriptPath(path);
+        return m_Api.LoadAssembly(resolved.c_str()) != 0;
+    }
+
+    LoadTicket DotNetHost::LoadAssemblyAsync(const char *path, const char *const *preloadTypeNames, int preloadTypeCount)
+    {
+        if (!m_Api.LoadAssemblyAsync)
+        {
+            return 0;
+        }
+
+        auto resolved = ResolveScriptPath(path);
+        return m_Api.LoadAssemblyAsync(resolved.c_str(), preloadTypeNames, preloadTypeCount);
+    }
+
+    LoadStatus DotNetHost::PollLoad(LoadTicket ticket)
+    {
+        if (!m_Api.PollLoad)
+        {
+            return LoadStatus::Unknown;
+        }
+
+        return static_cast<LoadStatus>(m_Api.PollLoad(ticket));
+    }
 
-        if (rc != 0 || ManagedCreateInstance == nullptr)
+    LoadStatus DotNetHost::WaitLoad(LoadTicket ticket)
+    {
+        if (!m_Api.WaitLoad)
+        {
+            return LoadStatus::Unknown;
+        }
+
+        return static_cast<LoadStatus>(m_Api.WaitLoad(ticket));
+    }
+
+    uint32_t DotNetHost::RegisterBuffer(const char *name, void *data, const char *elementTypeName, uint32_t stride, uint32_t count)
+    {
+        if (!m_Api.RegisterBuffer)
+        {
+            return 0;
+        }
+
+        return m_Api.RegisterBuffer(name, data, elementTypeName, static_cast<int>(stride), static_cast<int>(count));
+    }
+
+    uint32_t DotNetHost::UnregisterBuffer(const char *name)
+    {
+        return m_Api.UnregisterBuffer ? m_Api.UnregisterBuffer(name) : 0;
+    }
+
+    bool DotNetHost::BeginReload(const char *path)
+    {
+        if (!m_Api.BeginReload)
         {
-            std::cout << "[C++ Engine] Failed to load CreateInstance function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get CreateInstanceGuid
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("CreateInstanceGuid"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedCreateInstanceGuid);
+        auto resolved = ResolveScriptPath(path);
+        return m_Api.BeginReload(resolved.c_str()) != 0;
+    }
+
+    ReloadStatus DotNetHost::PollReload()
+    {
+        return m_Api.PollReload ? static_cast<ReloadStatus>(m_Api.PollReload()) : ReloadStatus::None;
+    }
+
+    bool DotNetHost::CommitReload(ReloadStats *outStats)
+    {
+        return m_Api.CommitReload && m_Api.CommitReload(outStats) != 0;
+    }
+
+    ContextHandle DotNetHost::CreateContext(const char *path)
+    {
+        if (!m_Api.CreateContext)
+        {
+            return {};
+        }
+
+        auto resolved = ResolveScriptPath(path);
+        return { m_Api.CreateContext(resolved.c_str()) };
+    }
+
+    bool DotNetHost::DestroyContext(ContextHandle context)
+    {
+        return m_Api.DestroyContext && context && m_Api.DestroyContext(context.Value) != 0;
+    }
+
+    InstanceHandle DotNetHost::CreateInstance(ContextHandle context, const char *typeName)
+    {
+        if (!m_Api.CreateInstanceIn)
+        {
+            return {};
+        }
 
-        if (rc != 0 || ManagedCreateInstanceGuid == nullptr)
+        return { m_Api.CreateInstanceIn(context.Value, typeName) };
+    }
+
+    InstanceHandle DotNetHost::CreateInstanceGuid(ContextHandle context, const char *typeName, const ScriptGuid &instanceGuid)
+    {
+        if (!m_Api.CreateInstanceGuidBinaryIn)
+        {
+            return {};
+        }
+
+        return { m_Api.CreateInstanceGuidBinaryIn(context.Value, typeName, &instanceGuid) };
+    }
+
+    MethodHandle DotNetHost::BindStaticMethod(ContextHandle context, const char *typeName, const char *methodName, int signature)
+    {
+        if (!m_Api.BindStaticMethodIn)
+        {
+            return {};
+        }
+
+        return { m_Api.BindStaticMethodIn(context.Value, typeName, methodName, signature) };
+    }
+
+    MethodHandle DotNetHost::BindTypeMethod(ContextHandle context, const char *typeName, const char *methodName, int signature)
+    {
+        if (!m_Api.BindTypeMethodIn)
+        {
+            return {};
+        }
+
+        return { m_Api.BindTypeMethodIn(context.Value, typeName, methodName, signature) };
+    }
+
+    NativeMethod DotNetHost::BindStaticMethodPtr(ContextHandle context, const char *typeName, const char *methodName, int signature)
+    {
+        NativeMethod method;
+        if (m_Api.BindStaticMethodPtrIn && !m_Api.BindStaticMethodPtrIn(context.Value, typeName, methodName, signature, &method))
+        {
+            method = {};
+        }
+
+        return method;
+    }
+
+    bool DotNetHost::BeginReload(ContextHandle context, const char *path)
+    {
+        if (!m_Api.BeginReloadIn)
         {
-            std::cout << "[C++ Engine] Failed to load CreateInstanceGuid function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get DestroyInstance
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("DestroyInstance"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedDestroyInstance);
+        auto resolved = ResolveScriptPath(path);
+        return m_Api.BeginReloadIn(context.Value, resolved.c_str()) != 0;
+    }
+
+    ReloadStatus DotNetHost::PollReload(ContextHandle context)
+    {
+        return m_Api.PollReloadIn ? static_cast<ReloadStatus>(m_Api.PollReloadIn(context.Value)) : ReloadStatus::None;
+    }
+
+    bool DotNetHost::CommitReload(ContextHandle context, ReloadStats *outStats)
+    {
+        return m_Api.CommitReloadIn && m_Api.CommitReloadIn(context.Value, outStats) != 0;
+    }
+
+    UnloadStatus DotNetHost::PollUnload(double budgetMs)
+    {
+        UnloadStatus status;
+        if (m_Api.PollUnload)
+        {
+            m_Api.PollUnload(budgetMs, &status);
+        }
 
-        if (rc != 0 || ManagedDestroyInstance == nullptr)
+        return status;
+    }
+
+    bool DotNetHost::RegisterSignature(int signatureId, const char *returnTypeName, const char **parameterTypeNames, int parameterCount)
+    {
+        if (!m_Api.RegisterSignature)
         {
-            std::cout << "[C++ Engine] Failed to load DestroyInstance function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get DestroyInstanceGuid
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("DestroyInstanceGuid"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedDestroyInstanceGuid);
+        return m_Api.RegisterSignature(signatureId, returnTypeName, parameterTypeNames, parameterCount) != 0;
+    }
 
-        if (rc != 0 || ManagedDestroyInstanceGuid == nullptr)
+    InstanceHandle DotNetHost::CreateInstance(const char *typeName)
+    {
+        if (!m_Api.CreateInstance)
+        {
+            return {};
+        }
+
+        return { m_Api.CreateInstance(typeName) };
+    }
+
+    bool DotNetHost::CreateInstanceGuid(const char *typeName, const char *instanceGuid)
+    {
+        if (!m_Api.CreateInstanceGuid)
         {
-            std::cout << "[C++ Engine] Failed to load DestroyInstanceGuid function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get BindInstanceMethod
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("BindInstanceMethod"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedBindInstanceMethod);
+        return m_Api.CreateInstanceGuid(typeName, instanceGuid) != 0;
+    }
+
+    void DotNetHost::DestroyInstance(InstanceHandle instance)
+    {
+        if (m_Api.DestroyInstance && instance)
+        {
+            m_Api.DestroyInstance(instance.Value);
+        }
+    }
+
+    void DotNetHost::DestroyInstanceGuid(const char *instanceGuid)
+    {
+        if (m_Api.DestroyInstanceGuid)
+        {
+            m_Api.DestroyInstanceGuid(instanceGuid);
+        }
+    }
+
+    MethodHandle DotNetHost::BindInstanceMethod(InstanceHandle instance, const char *methodName, int signature)
+    {
+        if (!m_Api.BindInstanceMethod)
+        {
+            return {};
+        }
+
+        return { m_Api.BindInstanceMethod(instance.Value, methodName, signature) };
+    }
+
+    MethodHandle DotNetHost::BindInstanceMethodGuid(const char *instanceGuid, const char *methodName, int signature)
+    {
+        if (!m_Api.BindInstanceMethodGuid)
+        {
+            return {};
+        }
+
+        return { m_Api.BindInstanceMethodGuid(instanceGuid, methodName, signature) };
+    }
+
+    MethodHandle DotNetHost::BindStaticMethod(const char *typeName, const char *methodName, int signature)
+    {
+        if (!m_Api.BindStaticMethod)
+        {
+            return {};
+        }
+
+        return { m_Api.BindStaticMethod(typeName, methodName, signature) };
+    }
+
+    MethodHandle DotNetHost::BindTypeMethod(const char *typeName, const char *methodName, int signature)
+    {
+        if (!m_Api.BindTypeMethod)
+        {
+            return {};
+        }
+
+        return { m_Api.BindTypeMethod(typeName, methodName, signature) };
+    }
+
+    void DotNetHost::UnbindMethod(MethodHandle method)
+    {
+        if (m_Api.UnbindMethod && method)
+        {
+            m_Api.UnbindMethod(method.Value);
+        }
+    }
 
-        if (rc != 0 || ManagedBindInstanceMethod == nullptr)
+    bool DotNetHost::Invoke(MethodHandle method, const void *argsPtr, int argCount, void *returnPtr)
+    {
+        if (!m_Api.Invoke)
         {
-            std::cout << "[C++ Engine] Failed to load BindInstanceMethod function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get BindInstanceMethodGuid
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("BindInstanceMethodGuid"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedBindInstanceMethodGuid);
+        return m_Api.Invoke(method.Value, argsPtr, argCount, returnPtr) != 0;
+    }
 
-        if (rc != 0 || ManagedBindInstanceMethodGuid == nullptr)
+    bool DotNetHost::InvokeOn(MethodHandle method, InstanceHandle instance, const void *argsPtr, int argCount, void *returnPtr)
+    {
+        if (!m_Api.InvokeOn)
         {
-            std::cout << "[C++ Engine] Failed to load BindInstanceMethodGuid function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get BindStaticMethod
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("BindStaticMethod"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedBindStaticMethod);
+        return m_Api.InvokeOn(method.Value, instance.Value, argsPtr, argCount, returnPtr) != 0;
+    }
+
+    int DotNetHost::InvokeBatch(const MethodHandle *methods, const void *const *argsPerCall, int callCount, void **returns, int *statuses, InvokeBatchMode mode)
+    {
+        // Handles are passed to managed code as a plain int array.
+        static_assert(sizeof(MethodHandle) == sizeof(int) && alignof(MethodHandle) == alignof(int));
 
-        if (rc != 0 || ManagedBindStaticMethod == nullptr)
+        if (!m_Api.InvokeBatch || callCount <= 0)
+        {
+            return 0;
+        }
+
+        return m_Api.InvokeBatch(reinterpret_cast<const int *>(methods), argsPerCall, callCount, returns, statuses, static_cast<int>(mode));
+    }
+
+    bool DotNetHost::SetInvokeMode(InvokeMode mode)
+    {
+        if (!m_Api.SetInvokeMode)
         {
-            std::cout << "[C++ Engine] Failed to load BindStaticMethod function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Get Invoke
-        rc = load_assembly_and_get_function_pointer(
-            managedCorePath.c_str(),
-            STR("MochiSharp.Managed.Core.Bootstrap, MochiSharp.Managed"),
-            STR("Invoke"),
-            UNMANAGEDCALLERSONLY_METHOD,
-            nullptr,
-            (void **)&ManagedInvoke);
+        return m_Api.SetInvokeMode(static_cast<int>(mode)) != 0;
+    }
+
+    NativeMethod DotNetHost::BindInstanceMethodPtr(InstanceHandle instance, const char *methodName, int signature)
+    {
+        NativeMethod method;
+        if (m_Api.BindInstanceMethodPtr && !m_Api.BindInstanceMethodPtr(instance.Value, methodName, signature, &method))
+        {
+            method = {};
+        }
+
+        return method;
+    }
+
+    NativeMethod DotNetHost::BindInstanceMethodPtrGuid(const char *instanceGuid, const char *methodName, int signature)
+    {
+        NativeMethod method;
+        if (m_Api.BindInstanceMethodPtrGuid && !m_Api.BindInstanceMethodPtrGuid(instanceGuid, methodName, signature, &method))
+        {
+            method = {};
+        }
 
-        if (rc != 0 || ManagedInvoke == nullptr)
+        return method;
+    }
+
+    NativeMethod DotNetHost::BindStaticMethodPtr(const char *typeName, const char *methodName, int signature)
+    {
+        NativeMethod method;
+        if (m_Api.BindStaticMethodPtr && !m_Api.BindStaticMethodPtr(typeName, methodName, signature, &method))
+        {
+            method = {};
+        }
+
+        return method;
+    }
+
+    InstanceHandle DotNetHost::CreateInstanceGuid(const char *typeName, const ScriptGuid &instanceGuid)
+    {
+        if (!m_Api.CreateInstanceGuidBinary)
+        {
+            return {};
+        }
+
+        return { m_Api.CreateInstanceGuidBinary(typeName, &instanceGuid) };
+    }
+
+    void DotNetHost::DestroyInstanceGuid(const ScriptGuid &instanceGuid)
+    {
+        if (m_Api.DestroyInstanceGuidBinary)
+        {
+            m_Api.DestroyInstanceGuidBinary(&instanceGuid);
+        }
+    }
+
+    MethodHandle DotNetHost::BindInstanceMethodGuid(const ScriptGuid &instanceGuid, const char *methodName, int signature)
+    {
+        if (!m_Api.BindInstanceMethodGuidBinary)
+        {
+            return {};
+        }
+
+        return { m_Api.BindInstanceMethodGuidBinary(&instanceGuid, methodName, signature) };
+    }
+
+    NativeMethod DotNetHost::BindInstanceMethodPtrGuid(const ScriptGuid &instanceGuid, const char *methodName, int signature)
+    {
+        NativeMethod method;
+        if (m_Api.BindInstanceMethodPtrGuidBinary && !m_Api.BindInstanceMethodPtrGuidBinary(&instanceGuid, methodName, signature, &method))
+        {
+            method = {};
+        }
+
+        return method;
+    }
+
+    bool DotNetHost::GetMetadataCacheStats(MetadataCacheStats &outStats)
+    {
+        if (!m_Api.GetMetadataCacheStats)
         {
-            std::cout << "[C++ Engine] Failed to load Invoke function (rc: 0x" << std::hex << rc << std::dec << ")\n";
             return false;
         }
 
-        // Call Initialize
-        EngineInterface api;
-        api.LogMessage = &EngineLog;
-        ManagedInit(&api);
+        return m_Api.GetMetadataCacheStats(&outStats) != 0;
+    }
 
-        return true;
+    bool DotNetHost::GetManagedMemoryStats(ManagedMemoryStats &outStats)
+    {
+        if (!m_Api.GetManagedMemoryStats)
+        {
+            return false;
+        }
+
+        return m_Api.GetManagedMemoryStats(&outStats) != 0;
     }
 
-    bool DotNetHost::LoadAssembly(const char *path)
+    bool DotNetHost::BeginNoGCRegion(int64_t totalBytes)
     {
-        if (!ManagedLoadAssembly)
+        if (!m_Api.BeginNoGCRegion)
         {
             return false;
         }
 
-        std::filesystem::path scriptPath(path);
-        if (!scriptPath.is_absolute())
+        return m_Api.BeginNoGCRegion(totalBytes) != 0;
+    }
+
+    bool DotNetHost::EndNoGCRegion()
+    {
+        if (!m_Api.EndNoGCRegion)
         {
-            scriptPath = m_BaseDir / scriptPath;
+            return false;
         }
 
-        auto resolved = scriptPath.string();
-        return ManagedLoadAssembly(resolved.c_str()) != 0;
+        return m_Api.EndNoGCRegion() != 0;
     }
 
-    bool DotNetHost::RegisterSignature(int signatureId, const char *returnTypeName, const char **parameterTypeNames, int parameterCount)
+    bool DotNetHost::StartProfiler(int methodCapacity)
     {
-        if (!ManagedRegisterSignature)
+        if (!m_Api.StartProfiler)
         {
             return false;
         }
 
-        return ManagedRegisterSignature(signatureId, returnTypeName, parameterTypeNames, parameterCount) != 0;
+        return m_Api.StartProfiler(methodCapacity) != 0;
     }
 
-    int DotNetHost::CreateInstance(const char *typeName)
+    void DotNetHost::StopProfiler()
     {
-        if (!ManagedCreateInstance)
+        if (m_Api.StopProfiler)
         {
-            return 0;
+            m_Api.StopProfiler();
+        }
+    }
+
+    bool DotNetHost::GetProfile(std::vector<MethodProfile> &outProfile)
+    {
+        outProfile.clear();
+        if (!m_Api.GetProfile)
+        {
+            return false;
         }
 
-        return ManagedCreateInstance(typeName);
+        // Methods may get their first call between the two calls; retry until the snapshot fits.
+        int count = m_Api.GetProfile(nullptr, 0);
+        while (count > static_cast<int>(outProfile.size()))
+        {
+            outProfile.resize(count + 16);
+            count = m_Api.GetProfile(outProfile.data(), static_cast<int>(outProfile.size()));
+        }
+
+        if (count < 0)
+        {
+            outProfile.clear();
+            return false;
+        }
+
+        outProfile.resize(count);
+        return true;
     }
 
-    bool DotNetHost::CreateInstanceGuid(const char *typeName, const char *instanceGuid)
+    static uint32_t CORECLR_DELEGATE_CALLTYPE TraceThreadId()
     {
-        if (!ManagedCreateInstanceGuid)
+        return Trace::CurrentThreadId();
+    }
+
+    static void CORECLR_DELEGATE_CALLTYPE TraceNameThread(uint32_t threadId, const char *name)
+    {
+        Trace::SetThreadName(threadId, name);
+    }
+
+    bool DotNetHost::StartTrace(uint32_t eventsPerThread)
+    {
+        Trace::Start(eventsPerThread);
+        if (!m_Api.StartTrace)
         {
             return false;
         }
 
-        return ManagedCreateInstanceGuid(typeName, instanceGuid) != 0;
+        return m_Api.StartTrace(static_cast<int>(eventsPerThread), &TraceThreadId, &TraceNameThread) != 0;
     }
 
-    void DotNetHost::DestroyInstance(int instanceId)
+    void DotNetHost::StopTrace()
     {
-        if (ManagedDestroyInstance)
+        if (m_Api.StopTrace)
         {
-            ManagedDestroyInstance(instanceId);
+            m_Api.StopTrace();
         }
+        Trace::Stop();
     }
 
-    void DotNetHost::DestroyInstanceGuid(const char *instanceGuid)
+    bool DotNetHost::WriteTrace(const std::filesystem::path &path)
     {
-        if (ManagedDestroyInstanceGuid)
+        std::vector<TraceEvent> events;
+        int64_t dropped = Trace::Drain(events);
+        if (dropped > 0)
         {
-            ManagedDestroyInstanceGuid(instanceGuid);
+            std::cout << "[C++ Engine] Trace: " << dropped << " native events dropped; drain more often or start with a larger buffer\n";
         }
+
+        if (m_Api.DrainTrace)
+        {
+            constexpr int Chunk = 4096;
+            for (;;)
+            {
+                size_t offset = events.size();
+                events.resize(offset + Chunk);
+                int count = m_Api.DrainTrace(events.data() + offset, Chunk);
+                events.resize(offset + std::max(count, 0));
+                if (count < Chunk)
+                {
+                    break;
+                }
+            }
+        }
+
+        std::sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b) { return a.BeginNs < b.BeginNs; });
+
+        std::unordered_map<uint64_t, std::string> names;
+        auto name = [&](const TraceEvent &event) -> std::string
+        {
+            if (event.Name != 0 && m_Api.GetTraceName)
+            {
+                auto [it, inserted] = names.try_emplace(event.Name);
+                if (inserted)
+                {
+                    int id = static_cast<int>(event.Name);
+                    int length = m_Api.GetTraceName(id, nullptr, 0);
+                    if (length >= 0)
+                    {
+                        it->second.resize(length + 1);
+                        m_Api.GetTraceName(id, it->second.data(), length + 1);
+                        it->second.resize(length);
+                    }
+                }
+                if (!it->second.empty())
+                {
+                    return it->second;
+                }
+            }
+
+            switch (event.Kind)
+            {
+            case TraceEventKind::Invoke: return "Invoke";
+            case TraceEventKind::InvokeBatch: return "InvokeBatch";
+            case TraceEventKind::CreateInstance: return "CreateInstance";
+            case TraceEventKind::DestroyInstance: return "DestroyInstance";
+            case TraceEventKind::Bind: return "Bind";
+            case TraceEventKind::LoadAssembly: return "LoadAssembly";
+            case TraceEventKind::Reload: return "Reload";
+            case TraceEventKind::Unload: return "PollUnload";
+            case TraceEventKind::GCPause: return event.Arg >= 0 ? "GC pause (gen " + std::to_string(event.Arg) + ")" : "Runtime suspended";
+            default: return "(unknown)";
+            }
+        };
+
+        return Trace::WriteChromeJson(path, events, name);
     }
 
-    int DotNetHost::BindInstanceMethod(int instanceId, const char *methodName, int signature)
+    bool DotNetHost::GetRuntimeInfo(RuntimeInfo &outInfo)
     {
-        if (!ManagedBindInstanceMethod)
+        if (!m_Api.GetRuntimeInfo)
         {
-            return 0;
+            return false;
         }
 
-        return ManagedBindInstanceMethod(instanceId, methodName, signature);
+        return m_Api.GetRuntimeInfo(&outInfo) != 0;
     }
 
-    int DotNetHost::BindInstanceMethodGuid(const char *instanceGuid, const char *methodName, int signature)
+    std::optional<std::string> DotNetHost::GetRuntimeProperty(const char *name) const
     {
-        if (!ManagedBindInstanceMethodGuid)
+        const char_t *value = nullptr;
+        if (m_Ctx == nullptr || get_property_fptr(m_Ctx, ToCharT(name).c_str(), &value) != 0 || value == nullptr)
         {
-            return 0;
+            return std::nullopt;
         }
 
-        return ManagedBindInstanceMethodGuid(instanceGuid, methodName, signature);
+        return FromCharT(value);
     }
 
-    int DotNetHost::BindStaticMethod(const char *typeName, const char *methodName, int signature)
+    int DotNetHost::InvokeOnBatch(const MethodHandle *methods, const InstanceHandle *instances, int callCount, const void *const *args, int *statuses)
     {
-        if (!ManagedBindStaticMethod)
+        static_assert(sizeof(InstanceHandle) == sizeof(int) && alignof(InstanceHandle) == alignof(int));
+
+        if (!m_Api.InvokeOnBatch || callCount <= 0)
         {
             return 0;
         }
 
-        return ManagedBindStaticMethod(typeName, methodName, signature);
+        return m_Api.InvokeOnBatch(reinterpret_cast<const int *>(methods), reinterpret_cast<const int *>(instances), callCount, args, statuses);
     }
 
-    bool DotNetHost::Invoke(int methodId, const void *argsPtr, int argCount, void *returnPtr)
+    bool DotNetHost::IsParallelSafe(MethodHandle method, InstanceHandle instance)
     {
-        if (!ManagedInvoke)
+        return m_Api.IsParallelSafe && m_Api.IsParallelSafe(method.Value, instance.Value) == 1;
+    }
+
+    bool ScriptGuid::Parse(const char *text, ScriptGuid &outGuid)
+    {
+        if (!text)
+        {
+            return false;
+        }
+
+        const bool braced = text[0] == '{';
+        const char *p = braced ? text + 1 : text;
+
+        auto hexValue = [](char c) -> int
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+
+        // Reads `digits` hex digits into value, advancing p.
+        auto readHex = [&](int digits, uint64_t &value) -> bool
+        {
+            value = 0;
+            for (int i = 0; i < digits; i++)
+            {
+                int v = hexValue(*p++);
+                if (v < 0)
+                {
+                    return false;
+                }
+                value = (value << 4) | static_cast<uint64_t>(v);
+            }
+            return true;
+        };
+
+        uint64_t d1, d2, d3, d4, d5;
+        ScriptGuid guid;
+        if (!readHex(8, d1) || *p++ != '-' || !readHex(4, d2) || *p++ != '-' || !readHex(4, d3) || *p++ != '-'
+            || !readHex(4, d4) || *p++ != '-' || !readHex(12, d5))
         {
             return false;
         }
 
-        return ManagedInvoke(methodId, argsPtr, argCount, returnPtr) != 0;
+        if ((braced && *p++ != '}') || *p != '\0')
+        {
+            return false;
+        }
+
+        guid.Data1 = static_cast<uint32_t>(d1);
+        guid.Data2 = static_cast<uint16_t>(d2);
+        guid.Data3 = static_cast<uint16_t>(d3);
+        guid.Data4[0] = static_cast<uint8_t>(d4 >> 8);
+        guid.Data4[1] = static_cast<uint8_t>(d4);
+        for (int i = 0; i < 6; i++)
+        {
+            guid.Data4[2 + i] = static_cast<uint8_t>(d5 >> (40 - 8 * i));
+        }
+
+        outGuid = guid;
+        return true;
+    }
+
+    std::string ScriptGuid::ToString() const
+    {
+        char buffer[37];
+        std::snprintf(buffer, sizeof(buffer), "%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+            Data1, Data2, Data3, Data4[0], Data4[1], Data4[2], Data4[3], Data4[4], Data4[5], Data4[6], Data4[7]);
+        return buffer;
     }
 
     bool DotNetHost::LoadHostFxr()
     {
-        char_t buffer[MAX_PATH];
-        size_t bufferSize = sizeof(buffer) / sizeof(buffer[0]);
-        int rc = get_hostfxr_path(buffer, &bufferSize, nullptr);
-        if (rc != 0)
+        // Cache format: a header line, then the hostfxr path and the .NET root (may be empty), UTF-8.
+        constexpr const char *CacheHeader = "MochiSharp hostfxr cache v1";
+
+        auto phaseBegin = std::chrono::steady_clock::now();
+        std::filesystem::path hostFxrPath;
+        if (!m_HostFxrCache.empty())
+        {
+            std::ifstream cache(m_HostFxrCache, std::ios::binary);
+            std::string header, cachedPath, cachedRoot;
+            if (std::getline(cache, header) && header == CacheHeader && std::getline(cache, cachedPath) && std::getline(cache, cachedRoot))
+            {
+                hostFxrPath = PathFromUtf8(cachedPath);
+                m_DotNetRoot = PathFromUtf8(cachedRoot);
+                m_Startup.HostFxrCacheHit = std::filesystem::exists(hostFxrPath);
+            }
+        }
+
+        if (!m_Startup.HostFxrCacheHit)
         {
+            std::vector<char_t> buffer(1024);
+            size_t bufferSize = buffer.size();
+            int rc = get_hostfxr_path(buffer.data(), &bufferSize, nullptr);
+            if (rc == static_cast<int>(0x80008098)) // HostApiBufferTooSmall: bufferSize is the required size
+            {
+                buffer.resize(bufferSize);
+                rc = get_hostfxr_path(buffer.data(), &bufferSize, nullptr);
+            }
+            if (rc != 0)
+            {
+                std::cout << "[C++ Engine] hostfxr not found (rc: 0x" << std::hex << rc << std::dec << "); is the .NET runtime installed?\n";
+                return false;
+            }
+
+            hostFxrPath = buffer.data();
+            m_DotNetRoot = DotNetRootOf(hostFxrPath);
+        }
+        m_Startup.ResolveHostFxrMs = MsSince(phaseBegin);
+
+        phaseBegin = std::chrono::steady_clock::now();
+        void *lib = LoadSharedLibrary(hostFxrPath);
+        if (lib == nullptr)
+        {
+            std::cout << "[C++ Engine] Failed to load " << PathToUtf8(hostFxrPath) << "\n";
+            if (m_Startup.HostFxrCacheHit)
+            {
+                // The cached runtime went away or broke; probe again and rewrite the cache.
+                std::error_code error;
+                std::filesystem::remove(m_HostFxrCache, error);
+                m_Startup = {};
+                m_DotNetRoot.clear();
+                return LoadHostFxr();
+            }
             return false;
         }
 
-        HMODULE lib = LoadLibraryW(buffer);
-        init_fptr = (hostfxr_initialize_for_runtime_config_fn)GetProcAddress(lib, "hostfxr_initialize_for_runtime_config");
-        get_delegate_fptr = (hostfxr_get_runtime_delegate_fn)GetProcAddress(lib, "hostfxr_get_runtime_delegate");
-        close_fptr = (hostfxr_close_fn)GetProcAddress(lib, "hostfxr_close");
+        init_fptr = (hostfxr_initialize_for_runtime_config_fn)GetExport(lib, "hostfxr_initialize_for_runtime_config");
+        get_delegate_fptr = (hostfxr_get_runtime_delegate_fn)GetExport(lib, "hostfxr_get_runtime_delegate");
+        close_fptr = (hostfxr_close_fn)GetExport(lib, "hostfxr_close");
+        set_property_fptr = (hostfxr_set_runtime_property_value_fn)GetExport(lib, "hostfxr_set_runtime_property_value");
+        get_property_fptr = (hostfxr_get_runtime_property_value_fn)GetExport(lib, "hostfxr_get_runtime_property_value");
+        m_Startup.LoadHostFxrMs = MsSince(phaseBegin);
 
-        return (init_fptr && get_delegate_fptr && close_fptr);
+        if (!init_fptr || !get_delegate_fptr || !close_fptr || !set_property_fptr || !get_property_fptr)
+        {
+            return false;
+        }
+
+        if (!m_HostFxrCache.empty() && !m_Startup.HostFxrCacheHit)
+        {
+            std::ofstream cache(m_HostFxrCache, std::ios::binary | std::ios::trunc);
+            cache << CacheHeader << "\n" << PathToUtf8(hostFxrPath) << "\n" << PathToUtf8(m_DotNetRoot) << "\n";
+        }
+
+        return true;
     }
 
 }
\ No newline at end of file
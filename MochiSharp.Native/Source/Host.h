@@ -9,26 +9,242 @@
     #include <dlfcn.h>
 #endif
 
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <string>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 
 #include <nethost.h>
 
 #include <coreclr_delegates.h>
 #include <hostfxr.h>
 
+#include "Log.h"
+#include "Trace.h"
+
 extern hostfxr_initialize_for_runtime_config_fn init_fptr;
 extern hostfxr_get_runtime_delegate_fn get_delegate_fptr;
 extern hostfxr_close_fn close_fptr;
+extern hostfxr_set_runtime_property_value_fn set_property_fptr;
+extern hostfxr_get_runtime_property_value_fn get_property_fptr;
 
 namespace MochiSharp
 {
+    // Start of an engine API table: a struct of plain C function pointers the engine fills and passes
+    // to DotNetHost::SetEngineApi; scripts call it through a facade generated by Tools/engine-api.lua.
+    // Like ManagedApi, entries are append-only: Version changes only when an existing entry changes
+    // meaning and Size is the size of the whole table.
+    struct EngineApiHeader
+    {
+        uint32_t Version = 0;
+        uint32_t Size = 0;
+    };
+
     struct EngineInterface
     {
         typedef void (*LogFunc)(const char *message);
-        LogFunc LogMessage;
+        LogFunc LogMessage = nullptr;  // synchronous fallback, used when LogRing is null
+        LogRingHeader *LogRing = nullptr;
+        const EngineApiHeader *EngineApi = nullptr;
+    };
+
+    // A bound method callable directly from native code.
+    // Function has the shape R (*)(void *target, Args...): int/float are passed as-is, bool as int32
+    // and blittable structs by value. Valid until the instance is destroyed or the assembly reloaded.
+    struct NativeMethod
+    {
+        void *Function = nullptr;
+        void *Target = nullptr;
+
+        template<typename R, typename... Args>
+        R Call(Args... args) const
+        {
+            using Fn = R (CORECLR_DELEGATE_CALLTYPE *)(void *, Args...);
+            return reinterpret_cast<Fn>(Function)(Target, args...);
+        }
+
+        explicit operator bool() const { return Function != nullptr; }
+    };
+
+    // Generational handle to a managed instance or method binding (layout matches HandleTable<T>):
+    // bits 0..19 are the slot index, bits 20..30 the slot generation. 0 is never valid.
+    // A handle to a destroyed instance or unbound method is rejected even after its slot is reused.
+    template<typename Tag>
+    struct Handle
+    {
+        int32_t Value = 0;
+
+        static constexpr int IndexBits = 20;
+
+        uint32_t Index() const { return static_cast<uint32_t>(Value) & ((1u << IndexBits) - 1); }
+        uint32_t Generation() const { return static_cast<uint32_t>(Value) >> IndexBits; }
+        bool IsValid() const { return Value > 0; }
+        explicit operator bool() const { return IsValid(); }
+
+        bool operator==(const Handle &other) const { return Value == other.Value; }
+        bool operator!=(const Handle &other) const { return Value != other.Value; }
+    };
+
+    using InstanceHandle = Handle<struct InstanceTag>;
+    using MethodHandle = Handle<struct MethodTag>;
+    // A script context made by DotNetHost::CreateContext. An empty handle is the default context, the
+    // one LoadAssembly loads into.
+    using ContextHandle = Handle<struct ContextTag>;
+
+    // 128-bit instance key with the in-memory layout of System.Guid, passed to managed code by pointer.
+    struct ScriptGuid
+    {
+        uint32_t Data1 = 0;
+        uint16_t Data2 = 0;
+        uint16_t Data3 = 0;
+        uint8_t Data4[8] = {};
+
+        // Parses "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx", optionally wrapped in braces.
+        static bool Parse(const char *text, ScriptGuid &outGuid);
+        std::string ToString() const;
+
+        bool operator==(const ScriptGuid &other) const = default;
+    };
+
+    static_assert(sizeof(ScriptGuid) == 16, "ScriptGuid must match System.Guid");
+
+    // Runtime configuration in effect, as the runtime itself reports it (DotNetHost::GetRuntimeInfo).
+    struct RuntimeInfo
+    {
+        int32_t ServerGC = 0;
+        int32_t ConcurrentGC = 0;
+        int32_t GCHeapAffinitize = 0;
+        int32_t GCHeapCount = 0;
+        int32_t GCLatencyMode = 0;          // System.Runtime.GCLatencyMode
+        int32_t TieredCompilation = 0;
+        int32_t TieredPGO = 0;
+        int32_t ReadyToRun = 0;
+        uint64_t GCHeapHardLimit = 0;       // 0: no limit
+        uint64_t GCHeapAffinitizeMask = 0;
+        uint64_t TotalAvailableMemory = 0;  // what the GC may use: hard limit, container limit or physical memory
+    };
+
+    // Managed GC counters, gathered in one transition by DotNetHost::GetManagedMemoryStats. Collections
+    // run by BeginNoGCRegion are included, though the runtime's own counters skip them.
+    struct ManagedMemoryStats
+    {
+        int64_t Gen0Collections = 0;
+        int64_t Gen1Collections = 0;
+        int64_t Gen2Collections = 0;
+        int64_t HeapSizeBytes = 0;          // after the last collection
+        int64_t FragmentedBytes = 0;        // free space inside the heap after the last collection
+        int64_t CommittedBytes = 0;
+        int64_t TotalAllocatedBytes = 0;    // since startup
+        int64_t AllocatedBytes = 0;         // since the previous GetManagedMemoryStats call, or Init
+        double TotalPauseMs = 0.0;          // time the runtime was suspended for GC since startup
+        double LastPauseMs = 0.0;           // pause of the last collection, both pauses of a background GC
+        double PauseTimePercentage = 0.0;   // of the time since the runtime started
+        int32_t InNoGCRegion = 0;
+    };
+
+    // Call counters of one method handle, from DotNetHost::GetProfile (layout matches MethodProfile in
+    // MochiSharp.Managed).
+    struct MethodProfile
+    {
+        static constexpr int HistogramBuckets = 32;
+
+        MethodHandle Method;
+        int32_t Failed = 0;                 // calls that threw
+        int64_t Calls = 0;
+        int64_t TotalNs = 0;
+        int64_t MaxNs = 0;
+        int64_t AllocatedBytes = 0;         // managed allocations on the calling thread during the calls
+        int64_t Histogram[HistogramBuckets] = {}; // bucket b: calls that took [2^b, 2^(b+1)) ns
+        char Name[128] = {};                // Namespace.Type.Method, UTF-8, truncated
+
+        double MeanNs() const { return Calls > 0 ? static_cast<double>(TotalNs) / Calls : 0.0; }
+        double AllocatedPerCall() const { return Calls > 0 ? static_cast<double>(AllocatedBytes) / Calls : 0.0; }
+        // Upper bound of the bucket holding the given fraction (0..1) of calls, e.g. 0.99 for p99.
+        int64_t PercentileNs(double fraction) const
+        {
+            int64_t target = static_cast<int64_t>(fraction * Calls + 0.5);
+            int64_t seen = 0;
+            for (int b = 0; b < HistogramBuckets; b++)
+            {
+                seen += Histogram[b];
+                if (seen >= target && seen > 0)
+                {
+                    return int64_t(1) << (b + 1);
+                }
+            }
+            return MaxNs;
+        }
+    };
+
+    static_assert(sizeof(MethodProfile) == 424, "MethodProfile must match MochiSharp.Managed");
+
+    // Reflection cache counters of the loaded script context, reset on every LoadAssembly.
+    struct MetadataCacheStats
+    {
+        int64_t TypeHits = 0;
+        int64_t TypeMisses = 0;
+        int64_t MethodHits = 0;
+        int64_t MethodMisses = 0;
+        int32_t TypeCount = 0;
+        int32_t MethodCount = 0;
+    };
+
+    // Counters of a committed reload (layout matches ReloadStats in MochiSharp.Managed).
+    struct ReloadStats
+    {
+        int32_t InstancesMigrated = 0;
+        int32_t InstancesKept = 0;   // their type is gone from the new build; they keep running the old code
+        int32_t BindingsRebound = 0;
+        int32_t BindingsDropped = 0; // the method is gone from the new build
+        int32_t PointersRebound = 0;
+        int32_t Prepared = 0;        // instances whose field copier was compiled during the background load
+        double CommitMs = 0.0;
+    };
+
+    // Unloaded script contexts waiting to be collected (layout matches UnloadStatus in MochiSharp.Managed).
+    struct UnloadStatus
+    {
+        int32_t Pending = 0;   // still in memory
+        int32_t Reclaimed = 0; // collected since startup
+        int32_t Leaked = 0;    // pending after several full collections; logged with what holds them
+        int32_t Retries = 0;   // full collections the oldest pending context has survived
+        double OldestMs = 0.0;
+    };
+
+    // Identifies a LoadAssemblyAsync request; 0 is never a valid ticket.
+    using LoadTicket = int;
+
+    enum class LoadStatus : int
+    {
+        Failed = -1,  // the load failed (logged); the current context is unchanged
+        Unknown = 0,  // not a pending ticket, or its outcome was already reported
+        Loading = 1,  // still running, or polled from inside a script call, which cannot publish
+        Published = 2,
+    };
+
+    enum class ReloadStatus : int
+    {
+        Failed = -1, // the background load failed (logged); the reload was dropped
+        None = 0,
+        Loading = 1,
+        Ready = 2,
+    };
+
+    enum class InvokeBatchMode : int
+    {
+        PerCallArgs = 0, // argsPerCall[i] is the args array of call i
+        SharedArgs = 1,  // argsPerCall[0] is passed to every call
+    };
+
+    enum class InvokeMode : int
+    {
+        Compiled = 0,   // a compiled thunk per method; no boxing or managed allocation per call
+        Reflection = 1, // MethodInfo.Invoke with boxed arguments, for comparing against Compiled
     };
 
     typedef int (CORECLR_DELEGATE_CALLTYPE *InitializeFn)(EngineInterface *engineApi);
@@ -41,46 +257,370 @@ namespace MochiSharp
     typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodFn)(int instanceId, const char *methodName, int signature);
     typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodGuidFn)(const char *instanceGuid, const char *methodName, int signature);
     typedef int (CORECLR_DELEGATE_CALLTYPE *BindStaticMethodFn)(const char *typeName, const char *methodName, int signature);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindTypeMethodFn)(const char *typeName, const char *methodName, int signature);
+    typedef void (CORECLR_DELEGATE_CALLTYPE *UnbindMethodFn)(int methodId);
     typedef int (CORECLR_DELEGATE_CALLTYPE *InvokeFn)(int methodId, const void *argsPtr, int argCount, void *returnPtr);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *InvokeOnFn)(int methodId, int instanceId, const void *argsPtr, int argCount, void *returnPtr);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *InvokeBatchFn)(const int *methodIds, const void *const *argsPerCall, int callCount, void **returns, int *statuses, int mode);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodPtrFn)(int instanceId, const char *methodName, int signature, NativeMethod *outMethod);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodPtrGuidFn)(const char *instanceGuid, const char *methodName, int signature, NativeMethod *outMethod);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindStaticMethodPtrFn)(const char *typeName, const char *methodName, int signature, NativeMethod *outMethod);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CreateInstanceGuidBinaryFn)(const char *typeName, const ScriptGuid *instanceGuid);
+    typedef void (CORECLR_DELEGATE_CALLTYPE *DestroyInstanceGuidBinaryFn)(const ScriptGuid *instanceGuid);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodGuidBinaryFn)(const ScriptGuid *instanceGuid, const char *methodName, int signature);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindInstanceMethodPtrGuidBinaryFn)(const ScriptGuid *instanceGuid, const char *methodName, int signature, NativeMethod *outMethod);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetMetadataCacheStatsFn)(MetadataCacheStats *outStats);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetRuntimeInfoFn)(RuntimeInfo *outInfo);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetManagedMemoryStatsFn)(ManagedMemoryStats *outStats);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BeginNoGCRegionFn)(int64_t totalBytes);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *EndNoGCRegionFn)();
+    typedef int (CORECLR_DELEGATE_CALLTYPE *StartProfilerFn)(int methodCapacity);
+    typedef void (CORECLR_DELEGATE_CALLTYPE *StopProfilerFn)();
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetProfileFn)(MethodProfile *outProfiles, int capacity);
+    typedef uint32_t (CORECLR_DELEGATE_CALLTYPE *TraceThreadIdFn)();
+    typedef void (CORECLR_DELEGATE_CALLTYPE *TraceNameThreadFn)(uint32_t threadId, const char *name);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *StartTraceFn)(int eventsPerThread, TraceThreadIdFn currentThreadId, TraceNameThreadFn nameThread);
+    typedef void (CORECLR_DELEGATE_CALLTYPE *StopTraceFn)();
+    typedef int (CORECLR_DELEGATE_CALLTYPE *DrainTraceFn)(TraceEvent *outEvents, int capacity);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetTraceNameFn)(int id, char *buffer, int size);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *InvokeOnBatchFn)(const int *methodIds, const int *instanceIds, int callCount, const void *const *args, int *statuses);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *IsParallelSafeFn)(int methodId, int instanceId);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BeginReloadFn)(const char *path);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *PollReloadFn)();
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CommitReloadFn)(ReloadStats *outStats);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *PollUnloadFn)(double budgetMs, UnloadStatus *outStatus);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *LoadAssemblyAsyncFn)(const char *path, const char *const *preloadTypeNames, int preloadTypeCount);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *PollLoadFn)(int ticket);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *WaitLoadFn)(int ticket);
+    typedef uint32_t (CORECLR_DELEGATE_CALLTYPE *RegisterBufferFn)(const char *name, void *data, const char *elementTypeName, int stride, int count);
+    typedef uint32_t (CORECLR_DELEGATE_CALLTYPE *UnregisterBufferFn)(const char *name);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CreateContextFn)(const char *path);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *DestroyContextFn)(int contextId);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CreateInstanceInFn)(int contextId, const char *typeName);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CreateInstanceGuidBinaryInFn)(int contextId, const char *typeName, const ScriptGuid *instanceGuid);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindStaticMethodInFn)(int contextId, const char *typeName, const char *methodName, int signature);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindTypeMethodInFn)(int contextId, const char *typeName, const char *methodName, int signature);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BindStaticMethodPtrInFn)(int contextId, const char *typeName, const char *methodName, int signature, NativeMethod *outMethod);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *BeginReloadInFn)(int contextId, const char *path);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *PollReloadInFn)(int contextId);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *CommitReloadInFn)(int contextId, ReloadStats *outStats);
+    typedef int (CORECLR_DELEGATE_CALLTYPE *SetInvokeModeFn)(int mode);
+
+    // Every managed entry point, filled by the GetApiTable export in one call (layout matches ApiTable
+    // in MochiSharp.Managed). Entries are append-only: Size reports how many bytes the managed side
+    // filled, Version changes only when an existing entry changes meaning.
+    struct ManagedApi
+    {
+        static constexpr uint32_t CurrentVersion = 1;
 
+        uint32_t Version = CurrentVersion;
+        uint32_t Size = sizeof(ManagedApi);
+        InitializeFn Initialize = nullptr;
+        LoadAssemblyFn LoadAssembly = nullptr;
+        RegisterSignatureFn RegisterSignature = nullptr;
+        CreateInstanceFn CreateInstance = nullptr;
+        CreateInstanceGuidFn CreateInstanceGuid = nullptr;
+        DestroyInstanceFn DestroyInstance = nullptr;
+        DestroyInstanceGuidFn DestroyInstanceGuid = nullptr;
+        BindInstanceMethodFn BindInstanceMethod = nullptr;
+        BindInstanceMethodGuidFn BindInstanceMethodGuid = nullptr;
+        BindStaticMethodFn BindStaticMethod = nullptr;
+        BindTypeMethodFn BindTypeMethod = nullptr;
+        UnbindMethodFn UnbindMethod = nullptr;
+        InvokeFn Invoke = nullptr;
+        InvokeOnFn InvokeOn = nullptr;
+        InvokeBatchFn InvokeBatch = nullptr;
+        BindInstanceMethodPtrFn BindInstanceMethodPtr = nullptr;
+        BindInstanceMethodPtrGuidFn BindInstanceMethodPtrGuid = nullptr;
+        BindStaticMethodPtrFn BindStaticMethodPtr = nullptr;
+        CreateInstanceGuidBinaryFn CreateInstanceGuidBinary = nullptr;
+        DestroyInstanceGuidBinaryFn DestroyInstanceGuidBinary = nullptr;
+        BindInstanceMethodGuidBinaryFn BindInstanceMethodGuidBinary = nullptr;
+        BindInstanceMethodPtrGuidBinaryFn BindInstanceMethodPtrGuidBinary = nullptr;
+        GetMetadataCacheStatsFn GetMetadataCacheStats = nullptr;
+        InvokeOnBatchFn InvokeOnBatch = nullptr;
+        IsParallelSafeFn IsParallelSafe = nullptr;
+        BeginReloadFn BeginReload = nullptr;
+        PollReloadFn PollReload = nullptr;
+        CommitReloadFn CommitReload = nullptr;
+        PollUnloadFn PollUnload = nullptr;
+        LoadAssemblyAsyncFn LoadAssemblyAsync = nullptr;
+        PollLoadFn PollLoad = nullptr;
+        WaitLoadFn WaitLoad = nullptr;
+        RegisterBufferFn RegisterBuffer = nullptr;
+        UnregisterBufferFn UnregisterBuffer = nullptr;
+        GetRuntimeInfoFn GetRuntimeInfo = nullptr;
+        GetManagedMemoryStatsFn GetManagedMemoryStats = nullptr;
+        BeginNoGCRegionFn BeginNoGCRegion = nullptr;
+        EndNoGCRegionFn EndNoGCRegion = nullptr;
+        StartProfilerFn StartProfiler = nullptr;
+        StopProfilerFn StopProfiler = nullptr;
+        GetProfileFn GetProfile = nullptr;
+        StartTraceFn StartTrace = nullptr;
+        StopTraceFn StopTrace = nullptr;
+        DrainTraceFn DrainTrace = nullptr;
+        GetTraceNameFn GetTraceName = nullptr;
+        CreateContextFn CreateContext = nullptr;
+        DestroyContextFn DestroyContext = nullptr;
+        CreateInstanceInFn CreateInstanceIn = nullptr;
+        CreateInstanceGuidBinaryInFn CreateInstanceGuidBinaryIn = nullptr;
+        BindStaticMethodInFn BindStaticMethodIn = nullptr;
+        BindTypeMethodInFn BindTypeMethodIn = nullptr;
+        BindStaticMethodPtrInFn BindStaticMethodPtrIn = nullptr;
+        BeginReloadInFn BeginReloadIn = nullptr;
+        PollReloadInFn PollReloadIn = nullptr;
+        CommitReloadInFn CommitReloadIn = nullptr;
+        SetInvokeModeFn SetInvokeMode = nullptr;
+    };
+
+    typedef int (CORECLR_DELEGATE_CALLTYPE *GetApiTableFn)(ManagedApi *table);
+
+    template<typename Sig>
+    class BoundMethod;
+
+    // Runtime knobs DotNetHost::Init applies before the runtime starts, overriding
+    // MochiSharp.Managed.runtimeconfig.json. Unset values keep what the runtimeconfig (or the runtime's
+    // default) says. Read the result back with GetRuntimeInfo.
     struct HostSettings
     {
+        std::optional<bool> ServerGC;                   // System.GC.Server
+        std::optional<bool> ConcurrentGC;               // System.GC.Concurrent (background GC)
+        std::optional<uint64_t> GCHeapHardLimit;        // System.GC.HeapHardLimit, bytes
+        std::optional<uint32_t> GCHeapCount;            // System.GC.HeapCount, server GC only
+        std::optional<bool> GCHeapAffinitize;           // inverse of System.GC.NoAffinitize, server GC only
+        std::optional<uint64_t> GCHeapAffinitizeMask;   // System.GC.HeapAffinitizeMask
+        std::optional<bool> TieredCompilation;          // System.Runtime.TieredCompilation
+        std::optional<bool> TieredPGO;                  // System.Runtime.TieredPGO
+        // Has no runtime property; set through the DOTNET_ReadyToRun environment variable of this process.
+        std::optional<bool> ReadyToRun;
+        // AppContext switches, e.g. { "System.Globalization.Invariant", true }.
+        std::vector<std::pair<std::string, bool>> AppContextSwitches;
+        // Any other runtime properties, passed through as-is.
+        std::vector<std::pair<std::string, std::string>> RuntimeProperties;
+    };
+
+    // Wall-clock time of each DotNetHost::Init phase, in milliseconds.
+    struct StartupTimings
+    {
+        double ResolveHostFxrMs = 0.0; // get_hostfxr_path probing, or reading the cache
+        double LoadHostFxrMs = 0.0;    // loading hostfxr and its exports
+        double InitRuntimeMs = 0.0;    // hostfxr_initialize_for_runtime_config
+        double GetDelegateMs = 0.0;    // hostfxr_get_runtime_delegate, which starts the runtime
+        double LoadCoreMs = 0.0;       // loading MochiSharp.Managed and resolving GetApiTable
+        double ManagedInitMs = 0.0;    // GetApiTable and Bootstrap.Initialize
+        double TotalMs = 0.0;
+        bool HostFxrCacheHit = false;
     };
 
+    // Threading: Invoke, InvokeOn, InvokeBatch and calls through NativeMethod/BoundMethod may run on any
+    // thread concurrently. Create, destroy, bind and RegisterSignature are safe from any thread but
+    // serialize on one lock per script context in the managed core. LoadAssembly waits for calls in
+    // flight to return and blocks new ones until the reload is done; it must not be called from inside
+    // a script call. Direct pointers (Bind*Ptr, Bind<Sig>) are not covered by that wait: stop using them
+    // before LoadAssembly or before destroying their instance, and do not call them during CommitReload
+    // (which keeps them valid).
+    //
+    // Contexts: scripts run in the default context unless CreateContext adds more, e.g. one per mod.
+    // Each has its own assembly, instances and bindings, and reloads and unloads on its own; a reload
+    // or DestroyContext only waits for calls into that context. Calls taking a ContextHandle address
+    // one context; calls taking an instance or method handle find its context from the handle, and
+    // GUID calls search every context, so keep GUIDs unique across contexts. Signatures are shared.
     class DotNetHost
     {
     private:
         hostfxr_handle m_Ctx = nullptr;
         std::filesystem::path m_BaseDir;
-        InitializeFn ManagedInit = nullptr;
-        LoadAssemblyFn ManagedLoadAssembly = nullptr;
-        RegisterSignatureFn ManagedRegisterSignature = nullptr;
-        CreateInstanceFn ManagedCreateInstance = nullptr;
-        CreateInstanceGuidFn ManagedCreateInstanceGuid = nullptr;
-        DestroyInstanceFn ManagedDestroyInstance = nullptr;
-        DestroyInstanceGuidFn ManagedDestroyInstanceGuid = nullptr;
-        BindInstanceMethodFn ManagedBindInstanceMethod = nullptr;
-        BindInstanceMethodGuidFn ManagedBindInstanceMethodGuid = nullptr;
-        BindStaticMethodFn ManagedBindStaticMethod = nullptr;
-        InvokeFn ManagedInvoke = nullptr;
+        ManagedApi m_Api;
+        // Typed signature id -> the "Return(Param, ...)" managed type names registered under it.
+        std::unordered_map<int, std::string> m_TypedSignatures;
+        std::mutex m_SignatureMutex;
+        LogPipeline m_Log;
+        const EngineApiHeader *m_EngineApi = nullptr;
+        std::filesystem::path m_HostFxrCache;
+        std::filesystem::path m_DotNetRoot;
+        StartupTimings m_Startup;
 
     public:
         static void EngineLog(const char *msg);
-        bool Init(const std::wstring &configPath);
+        // Managed and native log messages are drained and printed on a background thread.
+        // Add sinks and set filters here; sinks must be added before Init.
+        LogPipeline &Log() { return m_Log; }
+        // Engine callbacks for scripts (see EngineApiHeader). Set before Init; the table must outlive the host.
+        void SetEngineApi(const EngineApiHeader *table) { m_EngineApi = table; }
+        // Remembers the hostfxr library and .NET root found by the first Init in this file, so later
+        // process starts skip get_hostfxr_path probing. Set before Init. An entry whose runtime is
+        // gone is probed again and rewritten; delete the file to pick up a newly installed runtime.
+        void SetHostFxrCache(const std::filesystem::path &cacheFile) { m_HostFxrCache = cacheFile; }
+        // configPath is relative to the executable's directory unless absolute.
+        bool Init(const std::filesystem::path &configPath, const HostSettings &settings = {});
+        const StartupTimings &GetStartupTimings() const { return m_Startup; }
+        // The runtime configuration in effect after Init.
+        bool GetRuntimeInfo(RuntimeInfo &outInfo);
+        // A runtime property as the runtime sees it (runtimeconfig plus HostSettings); nullopt if unset.
+        std::optional<std::string> GetRuntimeProperty(const char *name) const;
         bool LoadAssembly(const char *path);
+        // Loads the assembly into a new context on a managed background thread, resolving the given
+        // script types and compiling their methods ahead of time, while the default context keeps
+        // running. PollLoad (once per frame) or WaitLoad publishes the new context once it is ready,
+        // with the same effect as LoadAssembly. Returns 0 on error.
+        LoadTicket LoadAssemblyAsync(const char *path, const char *const *preloadTypeNames = nullptr, int preloadTypeCount = 0);
+        LoadStatus PollLoad(LoadTicket ticket);
+        LoadStatus WaitLoad(LoadTicket ticket);
+        // Applies to every context, including those loaded later.
         bool RegisterSignature(int signatureId, const char *returnTypeName, const char **parameterTypeNames, int parameterCount);
-        int CreateInstance(const char *typeName);
+        InstanceHandle CreateInstance(const char *typeName);
         bool CreateInstanceGuid(const char *typeName, const char *instanceGuid);
-        void DestroyInstance(int instanceId);
+        // Destroying an instance also releases every method handle bound to it.
+        void DestroyInstance(InstanceHandle instance);
         void DestroyInstanceGuid(const char *instanceGuid);
-        int BindInstanceMethod(int instanceId, const char *methodName, int signature);
-        int BindInstanceMethodGuid(const char *instanceGuid, const char *methodName, int signature);
-        int BindStaticMethod(const char *typeName, const char *methodName, int signature);
-        bool Invoke(int methodId, const void *argsPtr, int argCount, void *returnPtr);
+        MethodHandle BindInstanceMethod(InstanceHandle instance, const char *methodName, int signature);
+        MethodHandle BindInstanceMethodGuid(const char *instanceGuid, const char *methodName, int signature);
+        MethodHandle BindStaticMethod(const char *typeName, const char *methodName, int signature);
+        // Binds an instance method once per type; call it on any instance of that type with InvokeOn.
+        MethodHandle BindTypeMethod(const char *typeName, const char *methodName, int signature);
+        void UnbindMethod(MethodHandle method);
+        bool Invoke(MethodHandle method, const void *argsPtr, int argCount, void *returnPtr);
+        bool InvokeOn(MethodHandle method, InstanceHandle instance, const void *argsPtr, int argCount, void *returnPtr);
+        // Runs callCount invokes in one managed transition. returns and statuses are optional arrays of
+        // callCount entries; statuses receives 1/0 per call. Returns the number of calls that succeeded.
+        int InvokeBatch(const MethodHandle *methods, const void *const *argsPerCall, int callCount, void **returns,
+            int *statuses = nullptr, InvokeBatchMode mode = InvokeBatchMode::PerCallArgs);
+        // How method handles bound after this call are invoked; existing handles and NativeMethod
+        // pointers are unaffected. Compiled is the default.
+        bool SetInvokeMode(InvokeMode mode);
+        NativeMethod BindInstanceMethodPtr(InstanceHandle instance, const char *methodName, int signature);
+        NativeMethod BindInstanceMethodPtrGuid(const char *instanceGuid, const char *methodName, int signature);
+        NativeMethod BindStaticMethodPtr(const char *typeName, const char *methodName, int signature);
+
+        // Binary GUID overloads: the key is passed as 16 bytes, skipping string formatting and parsing.
+        InstanceHandle CreateInstanceGuid(const char *typeName, const ScriptGuid &instanceGuid);
+        void DestroyInstanceGuid(const ScriptGuid &instanceGuid);
+        MethodHandle BindInstanceMethodGuid(const ScriptGuid &instanceGuid, const char *methodName, int signature);
+        NativeMethod BindInstanceMethodPtrGuid(const ScriptGuid &instanceGuid, const char *methodName, int signature);
+
+        // Loads the assembly into a new context next to the default one (path as for LoadAssembly).
+        // Returns an empty handle on error.
+        ContextHandle CreateContext(const char *path);
+        // Unloads the context once calls in flight into it return; its instance and method handles are
+        // rejected from then on. PollUnload reports when it is collected. The default context cannot be
+        // destroyed.
+        bool DestroyContext(ContextHandle context);
+        // Per-context forms of the calls that name a type or assembly.
+        InstanceHandle CreateInstance(ContextHandle context, const char *typeName);
+        InstanceHandle CreateInstanceGuid(ContextHandle context, const char *typeName, const ScriptGuid &instanceGuid);
+        MethodHandle BindStaticMethod(ContextHandle context, const char *typeName, const char *methodName, int signature);
+        MethodHandle BindTypeMethod(ContextHandle context, const char *typeName, const char *methodName, int signature);
+        NativeMethod BindStaticMethodPtr(ContextHandle context, const char *typeName, const char *methodName, int signature);
+        bool BeginReload(ContextHandle context, const char *path);
+        ReloadStatus PollReload(ContextHandle context);
+        bool CommitReload(ContextHandle context, ReloadStats *outStats = nullptr);
+
+        bool GetMetadataCacheStats(MetadataCacheStats &outStats);
+        // GC counters; AllocatedBytes counts from the previous call, so call it once per frame for a
+        // per-frame allocation figure.
+        bool GetManagedMemoryStats(ManagedMemoryStats &outStats);
+        // Keeps the GC from running until EndNoGCRegion, as long as managed code allocates at most
+        // totalBytes (small and large objects together) in between. Every Begin first runs a full
+        // blocking collection (gen0, gen1 and gen2) to make room for the budget, so begin a region where
+        // that pause is acceptable, e.g. at a level load, not every frame. Returns false if a region is
+        // already active or totalBytes is more than it can reserve.
+        bool BeginNoGCRegion(int64_t totalBytes);
+        // Returns false if the region was not active or was ended early by a collection, e.g. because
+        // scripts allocated more than the budget.
+        bool EndNoGCRegion();
+
+        // Opt-in per-method profiling of calls through method handles (Invoke, InvokeOn, InvokeBatch,
+        // InvokeOnBatch; direct pointers are not counted): calls, time, a latency histogram and managed
+        // allocations, recorded without locks. Handles whose slot index is at or past methodCapacity are
+        // not recorded. Starting again discards the previous profile.
+        bool StartProfiler(int methodCapacity = 4096);
+        void StopProfiler();
+        // Every method called since StartProfiler, by total time, highest first. Works after StopProfiler.
+        bool GetProfile(std::vector<MethodProfile> &outProfile);
+
+        // Timeline tracing (see Trace.h): the managed core records invokes through method handles,
+        // batches, create, destroy, bind, load, reload, unload and GC pauses; engine code adds its own
+        // phases with Trace::Scope. Native and managed events share one clock and one track per thread.
+        bool StartTrace(uint32_t eventsPerThread = 1u << 16);
+        void StopTrace();
+        // Writes the events recorded since StartTrace or the previous WriteTrace as Chrome trace-event
+        // JSON, for chrome://tracing or ui.perfetto.dev.
+        bool WriteTrace(const std::filesystem::path &path);
+
+        // Runs callCount (method, instance) pairs in one managed transition, all with the same args and no
+        // return value. instances[i] is the target of a type-level binding, or an empty handle for a method
+        // bound to its own instance; instances may be null if no call needs one. statuses is optional.
+        // Returns the number of calls that succeeded.
+        int InvokeOnBatch(const MethodHandle *methods, const InstanceHandle *instances, int callCount, const void *const *args, int *statuses = nullptr);
+        // True if the call is marked [ParallelSafe] in managed code (on the method or the instance's class).
+        bool IsParallelSafe(MethodHandle method, InstanceHandle instance = {});
+
+        // State-preserving hot reload. BeginReload loads the new build on a background thread while
+        // scripts keep running; poll it once per frame and call CommitReload at a frame boundary once it
+        // is Ready. The background load runs no script code. The commit constructs every instance from
+        // the new build on the calling thread, under the same handle and GUID with its fields copied by
+        // name, and rebinds method handles and direct pointers in place.
+        bool BeginReload(const char *path);
+        ReloadStatus PollReload();
+        // Waits for the background load if it is still running. outStats is optional.
+        bool CommitReload(ReloadStats *outStats = nullptr);
+
+        // LoadAssembly, CommitReload and DestroyContext unload without waiting for the GC. Poll once per
+        // frame until Pending is 0: each poll asks for a background collection and waits at most budgetMs
+        // for it. Contexts that survive several collections are counted as Leaked and logged.
+        UnloadStatus PollUnload(double budgetMs = 0.0);
+
+        // Shares a native array with scripts, which index it in place through SharedBuffer<T>.Get(name):
+        // no copies and no invokes. Register the same name again after resizing or moving the array;
+        // scripts see the new one on their next access. Unregister before freeing it. Only resize,
+        // move or free a buffer between frames, while no script code runs. Returns the buffer's new
+        // generation, 0 on error.
+        uint32_t RegisterBuffer(const char *name, void *data, const char *elementTypeName, uint32_t stride, uint32_t count);
+        // Typed form; the element type's managed name comes from MOCHI_MANAGED_TYPE.
+        template<typename T> uint32_t RegisterBuffer(const char *name, T *data, uint32_t count);
+        uint32_t UnregisterBuffer(const char *name);
+
+        // Typed bindings (see BoundMethod.h), e.g. host.Bind<void(float)>(instance, "OnUpdate").
+        // The signature is registered on first use from the ManagedType registry.
+        template<typename Sig> BoundMethod<Sig> Bind(InstanceHandle instance, const char *methodName);
+        template<typename Sig> BoundMethod<Sig> Bind(const char *instanceGuid, const char *methodName);
+        template<typename Sig> BoundMethod<Sig> Bind(const ScriptGuid &instanceGuid, const char *methodName);
+        template<typename Sig> BoundMethod<Sig> BindStatic(const char *typeName, const char *methodName);
+        template<typename Sig> BoundMethod<Sig> BindStatic(ContextHandle context, const char *typeName, const char *methodName);
 
     private:
         bool LoadHostFxr();
+        std::string ResolveScriptPath(const char *path) const;
+        template<typename Sig> int EnsureSignature();
+    };
+
+    // A no-GC region for one scope, e.g. a level's gameplay after it has loaded (entering it collects;
+    // see BeginNoGCRegion):
+    //     MochiSharp::NoGCRegionScope noGC(host, 4 * 1024 * 1024);
+    // Active() says whether the region started; it ends with the scope.
+    class NoGCRegionScope
+    {
+    public:
+        NoGCRegionScope(DotNetHost &host, int64_t totalBytes) : m_Host(host), m_Active(host.BeginNoGCRegion(totalBytes)) {}
+        ~NoGCRegionScope()
+        {
+            if (m_Active)
+            {
+                m_Host.EndNoGCRegion();
+            }
+        }
+
+        NoGCRegionScope(const NoGCRegionScope &) = delete;
+        NoGCRegionScope &operator=(const NoGCRegionScope &) = delete;
+
+        bool Active() const { return m_Active; }
+
+    private:
+        DotNetHost &m_Host;
+        bool m_Active;
     };
 }
 
+#include "BoundMethod.h"
+
 #endif // !HOST_H
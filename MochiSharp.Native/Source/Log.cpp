@@ -0,0 +1,268 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace MochiSharp
+{
+    static constexpr uint32_t RecordAlignment = 16;
+    static constexpr std::align_val_t RingAlignment{ 64 };
+
+    static uint32_t RecordSize(size_t textLength)
+    {
+        return static_cast<uint32_t>((sizeof(LogRecordHeader) + textLength + RecordAlignment - 1) & ~size_t(RecordAlignment - 1));
+    }
+
+    // Same algorithm as LogRing.Reserve in MochiSharp.Managed; both sides share the ring.
+    // A record that would straddle the end of the ring is preceded by a padding record.
+    static uint8_t *Reserve(LogRingHeader &ring, uint32_t size)
+    {
+        std::atomic_ref<int64_t> head(ring.Head);
+        std::atomic_ref<int64_t> tail(ring.Tail);
+        const uint32_t mask = ring.Capacity - 1;
+
+        int64_t current = head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            uint32_t offset = static_cast<uint32_t>(current) & mask;
+            uint32_t padding = offset + size > ring.Capacity ? ring.Capacity - offset : 0;
+            if (current + padding + size - tail.load(std::memory_order_acquire) > ring.Capacity)
+            {
+                return nullptr;
+            }
+
+            if (head.compare_exchange_weak(current, current + padding + size, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                if (padding != 0)
+                {
+                    auto *filler = reinterpret_cast<LogRecordHeader *>(ring.Data + offset);
+                    filler->Flags = LogRecordPadding;
+                    std::atomic_ref<uint32_t>(filler->Size).store(padding, std::memory_order_release);
+                }
+
+                return ring.Data + ((static_cast<uint32_t>(current) + padding) & mask);
+            }
+        }
+    }
+
+    void LogPipeline::AlignedDelete::operator()(void *p) const
+    {
+        ::operator delete(p, RingAlignment);
+    }
+
+    LogPipeline::LogPipeline(uint32_t capacity)
+    {
+        // Round up to a power of two so offsets can be masked.
+        uint32_t size = 4096;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        m_Data.reset(static_cast<uint8_t *>(::operator new(size, RingAlignment)));
+        std::memset(m_Data.get(), 0, size);
+
+        m_Header.reset(new (::operator new(sizeof(LogRingHeader), RingAlignment)) LogRingHeader());
+        m_Header->Capacity = size;
+        m_Header->MinLevel = static_cast<int32_t>(LogLevel::Info);
+        m_Header->CategoryMask = LogCategory::All;
+        m_Header->MaxMessageBytes = std::min<uint32_t>(size / 4, 0xFFFF);
+        m_Header->Data = m_Data.get();
+    }
+
+    LogPipeline::~LogPipeline()
+    {
+        Stop();
+    }
+
+    void LogPipeline::AddSink(std::shared_ptr<LogSink> sink)
+    {
+        if (!m_Running)
+        {
+            m_Sinks.push_back(std::move(sink));
+        }
+    }
+
+    void LogPipeline::Start()
+    {
+        if (m_Running.exchange(true))
+        {
+            return;
+        }
+
+        if (m_Sinks.empty())
+        {
+            m_Sinks.push_back(std::make_shared<ConsoleLogSink>());
+        }
+
+        m_Thread = std::thread(&LogPipeline::DrainLoop, this);
+    }
+
+    void LogPipeline::Stop()
+    {
+        if (!m_Running.exchange(false))
+        {
+            return;
+        }
+
+        m_Wake.notify_one();
+        m_Thread.join();
+        Drain();
+    }
+
+    void LogPipeline::SetMinLevel(LogLevel level)
+    {
+        std::atomic_ref<int32_t>(m_Header->MinLevel).store(static_cast<int32_t>(level), std::memory_order_relaxed);
+    }
+
+    void LogPipeline::SetCategoryMask(uint32_t mask)
+    {
+        std::atomic_ref<uint32_t>(m_Header->CategoryMask).store(mask, std::memory_order_relaxed);
+    }
+
+    bool LogPipeline::IsEnabled(LogLevel level, uint32_t category) const
+    {
+        return static_cast<int32_t>(level) >= std::atomic_ref<int32_t>(m_Header->MinLevel).load(std::memory_order_relaxed)
+            && (std::atomic_ref<uint32_t>(m_Header->CategoryMask).load(std::memory_order_relaxed) & category) != 0;
+    }
+
+    bool LogPipeline::Write(LogLevel level, uint32_t category, std::string_view text)
+    {
+        if (!IsEnabled(level, category))
+        {
+            return false;
+        }
+
+        LogRingHeader &ring = *m_Header;
+        size_t length = text.size();
+        if (length > ring.MaxMessageBytes)
+        {
+            // Truncate on a UTF-8 boundary.
+            length = ring.MaxMessageBytes;
+            while (length > 0 && (static_cast<uint8_t>(text[length]) & 0xC0) == 0x80)
+            {
+                length--;
+            }
+        }
+
+        uint32_t size = RecordSize(length);
+        uint8_t *data = Reserve(ring, size);
+        if (!data)
+        {
+            std::atomic_ref<int64_t>(ring.Dropped).fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto *record = reinterpret_cast<LogRecordHeader *>(data);
+        record->Level = static_cast<uint8_t>(level);
+        record->Flags = 0;
+        record->Length = static_cast<uint16_t>(length);
+        record->Category = category;
+        std::memcpy(record + 1, text.data(), length);
+        std::atomic_ref<uint32_t>(record->Size).store(size, std::memory_order_release);
+        return true;
+    }
+
+    void LogPipeline::Flush()
+    {
+        Drain();
+    }
+
+    int64_t LogPipeline::DroppedCount() const
+    {
+        return std::atomic_ref<int64_t>(m_Header->Dropped).load(std::memory_order_relaxed);
+    }
+
+    size_t LogPipeline::Drain()
+    {
+        std::lock_guard lock(m_DrainMutex);
+
+        LogRingHeader &ring = *m_Header;
+        std::atomic_ref<int64_t> tailRef(ring.Tail);
+        const uint32_t mask = ring.Capacity - 1;
+        int64_t tail = tailRef.load(std::memory_order_relaxed);
+
+        size_t delivered = 0;
+        for (;;)
+        {
+            auto *record = reinterpret_cast<LogRecordHeader *>(ring.Data + (static_cast<uint32_t>(tail) & mask));
+            uint32_t size = std::atomic_ref<uint32_t>(record->Size).load(std::memory_order_acquire);
+            if (size == 0)
+            {
+                // Empty, or the next record is reserved but not yet published.
+                break;
+            }
+
+            if ((record->Flags & LogRecordPadding) == 0)
+            {
+                LogMessage message{ static_cast<LogLevel>(record->Level), record->Category,
+                    std::string_view(reinterpret_cast<const char *>(record + 1), record->Length) };
+                for (auto &sink : m_Sinks)
+                {
+                    sink->Write(message);
+                }
+                delivered++;
+            }
+
+            // Producers only see this space again once Tail moves past it.
+            std::memset(record, 0, size);
+            tail += size;
+            tailRef.store(tail, std::memory_order_release);
+        }
+
+        if (delivered != 0)
+        {
+            for (auto &sink : m_Sinks)
+            {
+                sink->Flush();
+            }
+        }
+
+        return delivered;
+    }
+
+    void LogPipeline::DrainLoop()
+    {
+        while (m_Running)
+        {
+            if (Drain() == 0)
+            {
+                std::unique_lock lock(m_WakeMutex);
+                m_Wake.wait_for(lock, std::chrono::milliseconds(2), [this] { return !m_Running; });
+            }
+        }
+    }
+
+    void ConsoleLogSink::Write(const LogMessage &message)
+    {
+        // Redirected console output is printed as the script wrote it.
+        if (message.Category != LogCategory::Console)
+        {
+            m_Batch += message.Category == LogCategory::Script ? "[C#] " : "[C++ Engine] ";
+        }
+
+        if (message.Level == LogLevel::Warning)
+        {
+            m_Batch += "Warning: ";
+        }
+        else if (message.Level == LogLevel::Error && message.Category != LogCategory::Console)
+        {
+            m_Batch += "Error: ";
+        }
+
+        m_Batch += message.Text;
+        m_Batch += '\n';
+    }
+
+    void ConsoleLogSink::Flush()
+    {
+        std::fwrite(m_Batch.data(), 1, m_Batch.size(), stdout);
+        std::fflush(stdout);
+        m_Batch.clear();
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace MochiSharp
+{
+    enum class LogLevel : int32_t
+    {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warning = 3,
+        Error = 4,
+        None = 5, // as a minimum level: log nothing
+    };
+
+    // Bit flags, matched against LogRingHeader::CategoryMask.
+    namespace LogCategory
+    {
+        constexpr uint32_t Host = 1u << 0;    // native host
+        constexpr uint32_t Core = 1u << 1;    // MochiSharp.Managed
+        constexpr uint32_t Script = 1u << 2;  // script code through Logger
+        constexpr uint32_t Console = 1u << 3; // redirected Console.Out/Console.Error
+        constexpr uint32_t All = 0xFFFFFFFFu;
+    }
+
+    // Shared with managed code (layout matches LogRingHeader in MochiSharp.Managed).
+    // Producers reserve space by advancing Head, write a record and publish it by storing its Size;
+    // the single consumer reads records at Tail, zeroes them and advances Tail. A full ring drops
+    // the message instead of blocking.
+    struct alignas(64) LogRingHeader
+    {
+        uint32_t Capacity = 0;        // bytes, power of two
+        int32_t MinLevel = 0;         // LogLevel
+        uint32_t CategoryMask = 0;    // LogCategory bits
+        uint32_t MaxMessageBytes = 0; // longer messages are truncated
+        uint8_t *Data = nullptr;
+        int64_t Dropped = 0;
+        alignas(64) int64_t Head = 0;
+        alignas(64) int64_t Tail = 0;
+    };
+
+    static_assert(sizeof(LogRingHeader) == 192, "LogRingHeader must match the managed layout");
+
+    // Record header, 16-byte aligned; the UTF-8 text follows it.
+    struct LogRecordHeader
+    {
+        uint32_t Size;     // total record bytes; 0 until the record is published
+        uint8_t Level;
+        uint8_t Flags;     // LogRecordPadding marks filler at the end of the ring
+        uint16_t Length;   // text bytes
+        uint32_t Category;
+        uint32_t Reserved;
+    };
+
+    constexpr uint8_t LogRecordPadding = 1;
+
+    struct LogMessage
+    {
+        LogLevel Level;
+        uint32_t Category;
+        std::string_view Text;
+    };
+
+    // Sinks run on the drain thread only, so they need no locking of their own.
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() = default;
+        virtual void Write(const LogMessage &message) = 0;
+        // Called once after each drained batch.
+        virtual void Flush() {}
+    };
+
+    // Writes messages to stdout with the host's usual prefixes, one fwrite per drained batch.
+    class ConsoleLogSink : public LogSink
+    {
+    public:
+        void Write(const LogMessage &message) override;
+        void Flush() override;
+
+    private:
+        std::string m_Batch;
+    };
+
+    class LogPipeline
+    {
+    public:
+        explicit LogPipeline(uint32_t capacity = 1u << 20);
+        ~LogPipeline();
+
+        LogPipeline(const LogPipeline &) = delete;
+        LogPipeline &operator=(const LogPipeline &) = delete;
+
+        // Sinks must be added before Start. Start adds a ConsoleLogSink if none were added.
+        void AddSink(std::shared_ptr<LogSink> sink);
+        void Start();
+        // Stops accepting messages, drains what is left and joins the drain thread.
+        void Stop();
+
+        // Filters are read by every producer before it formats anything.
+        void SetMinLevel(LogLevel level);
+        void SetCategoryMask(uint32_t mask);
+        bool IsEnabled(LogLevel level, uint32_t category) const;
+
+        // Never blocks; returns false if the message was filtered or dropped.
+        bool Write(LogLevel level, uint32_t category, std::string_view text);
+        // Delivers everything published so far on the calling thread.
+        void Flush();
+
+        int64_t DroppedCount() const;
+        LogRingHeader *Ring() { return m_Header.get(); }
+
+    private:
+        size_t Drain();
+        void DrainLoop();
+
+        struct AlignedDelete { void operator()(void *p) const; };
+
+        std::unique_ptr<LogRingHeader, AlignedDelete> m_Header;
+        std::unique_ptr<uint8_t, AlignedDelete> m_Data;
+        std::vector<std::shared_ptr<LogSink>> m_Sinks;
+        std::mutex m_DrainMutex;
+        std::mutex m_WakeMutex;
+        std::condition_variable m_Wake;
+        std::thread m_Thread;
+        std::atomic<bool> m_Running = false;
+    };
+}
+
+#endif // !LOG_H
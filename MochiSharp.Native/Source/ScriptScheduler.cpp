@@ -0,0 +1,258 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#include "ScriptScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace MochiSharp
+{
+    // Below this many parallel-safe calls the wake-up costs more than it saves.
+    static constexpr uint32_t MinParallelCalls = 64;
+    // Calls per chunk at least; each chunk is one managed transition.
+    static constexpr uint32_t MinChunkSize = 16;
+    // Chunks per thread, so faster threads have something to steal.
+    static constexpr uint32_t ChunksPerThread = 4;
+
+    static uint64_t PackRange(uint32_t begin, uint32_t end)
+    {
+        return (static_cast<uint64_t>(begin) << 32) | end;
+    }
+
+    static bool PopFront(std::atomic<uint64_t> &range, uint32_t &outChunk)
+    {
+        uint64_t current = range.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t begin = static_cast<uint32_t>(current >> 32);
+            uint32_t end = static_cast<uint32_t>(current);
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (range.compare_exchange_weak(current, PackRange(begin + 1, end), std::memory_order_acq_rel))
+            {
+                outChunk = begin;
+                return true;
+            }
+        }
+    }
+
+    static bool StealBack(std::atomic<uint64_t> &range, uint32_t &outChunk)
+    {
+        uint64_t current = range.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t begin = static_cast<uint32_t>(current >> 32);
+            uint32_t end = static_cast<uint32_t>(current);
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (range.compare_exchange_weak(current, PackRange(begin, end - 1), std::memory_order_acq_rel))
+            {
+                outChunk = end - 1;
+                return true;
+            }
+        }
+    }
+
+    static double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    ScriptScheduler::ScriptScheduler(DotNetHost &host, uint32_t workerCount)
+        : m_Host(host)
+    {
+        if (workerCount == 0)
+        {
+            uint32_t hardware = std::thread::hardware_concurrency();
+            workerCount = hardware > 1 ? hardware - 1 : 0;
+        }
+
+        m_QueueCount = workerCount + 1;
+        m_Queues = std::make_unique<WorkQueue[]>(m_QueueCount);
+
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_Workers.emplace_back(&ScriptScheduler::WorkerLoop, this, i);
+        }
+    }
+
+    ScriptScheduler::~ScriptScheduler()
+    {
+        m_Stopping.store(true, std::memory_order_relaxed);
+        m_Epoch.fetch_add(1, std::memory_order_release);
+        m_Epoch.notify_all();
+
+        for (auto &worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    ScriptGroupId ScriptScheduler::CreateGroup(std::string name)
+    {
+        m_Groups.push_back(Group{ std::move(name), {}, {}, {} });
+        return static_cast<ScriptGroupId>(m_Groups.size() - 1);
+    }
+
+    void ScriptScheduler::Add(ScriptGroupId group, ScriptCall call)
+    {
+        CallList &calls = m_Host.IsParallelSafe(call.Method, call.Instance) ? m_Groups[group].Parallel : m_Groups[group].Serial;
+        calls.Methods.push_back(call.Method);
+        calls.Instances.push_back(call.Instance);
+    }
+
+    void ScriptScheduler::Remove(ScriptGroupId group, ScriptCall call)
+    {
+        for (CallList *calls : { &m_Groups[group].Parallel, &m_Groups[group].Serial })
+        {
+            for (size_t i = 0; i < calls->Methods.size(); i++)
+            {
+                if (calls->Methods[i] == call.Method && calls->Instances[i] == call.Instance)
+                {
+                    // Erase rather than swap, so serial calls keep their order.
+                    calls->Methods.erase(calls->Methods.begin() + i);
+                    calls->Instances.erase(calls->Instances.begin() + i);
+                    return;
+                }
+            }
+        }
+    }
+
+    void ScriptScheduler::Clear(ScriptGroupId group)
+    {
+        Group &g = m_Groups[group];
+        g.Parallel = {};
+        g.Serial = {};
+    }
+
+    const ScriptPhaseStats &ScriptScheduler::Run(ScriptGroupId group, const void *const *args)
+    {
+        Group &g = m_Groups[group];
+        ScriptPhaseStats stats;
+        stats.ParallelCalls = g.Parallel.Size();
+        stats.SerialCalls = g.Serial.Size();
+
+        auto begin = std::chrono::steady_clock::now();
+
+        const uint32_t parallelCount = g.Parallel.Size();
+        if (parallelCount < MinParallelCalls || m_Workers.empty())
+        {
+            stats.FailedCalls += parallelCount - RunCalls(g.Parallel, 0, parallelCount, args);
+        }
+        else
+        {
+            m_ChunkSize = std::max(MinChunkSize, parallelCount / (m_QueueCount * ChunksPerThread));
+            const uint32_t chunkCount = (parallelCount + m_ChunkSize - 1) / m_ChunkSize;
+
+            // Deal contiguous chunk ranges; stealing evens out whatever the split gets wrong.
+            for (uint32_t i = 0; i < m_QueueCount; i++)
+            {
+                uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(chunkCount) * i / m_QueueCount);
+                uint32_t last = static_cast<uint32_t>(static_cast<uint64_t>(chunkCount) * (i + 1) / m_QueueCount);
+                m_Queues[i].Range.store(PackRange(first, last), std::memory_order_relaxed);
+            }
+
+            m_Job = &g.Parallel;
+            m_JobArgs = args;
+            m_Failed.store(0, std::memory_order_relaxed);
+            m_Steals.store(0, std::memory_order_relaxed);
+            m_Busy.store(static_cast<uint32_t>(m_Workers.size()), std::memory_order_relaxed);
+
+            m_Epoch.fetch_add(1, std::memory_order_release);
+            m_Epoch.notify_all();
+
+            // The calling thread works through its own share, then helps the others.
+            RunChunks(m_QueueCount - 1);
+
+            for (uint32_t busy = m_Busy.load(std::memory_order_acquire); busy != 0; busy = m_Busy.load(std::memory_order_acquire))
+            {
+                m_Busy.wait(busy, std::memory_order_acquire);
+            }
+
+            m_Job = nullptr;
+            m_JobArgs = nullptr;
+            stats.FailedCalls += m_Failed.load(std::memory_order_relaxed);
+            stats.Steals = m_Steals.load(std::memory_order_relaxed);
+        }
+
+        auto parallelEnd = std::chrono::steady_clock::now();
+
+        stats.FailedCalls += g.Serial.Size() - RunCalls(g.Serial, 0, g.Serial.Size(), args);
+
+        auto end = std::chrono::steady_clock::now();
+        stats.ParallelMs = ElapsedMs(begin, parallelEnd);
+        stats.SerialMs = ElapsedMs(parallelEnd, end);
+        stats.TotalMs = ElapsedMs(begin, end);
+
+        g.Stats = stats;
+        return g.Stats;
+    }
+
+    void ScriptScheduler::WorkerLoop(uint32_t queue)
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            m_Epoch.wait(seen, std::memory_order_acquire);
+            seen = m_Epoch.load(std::memory_order_acquire);
+            if (m_Stopping.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            RunChunks(queue);
+
+            if (m_Busy.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_Busy.notify_one();
+            }
+        }
+    }
+
+    void ScriptScheduler::RunChunks(uint32_t queue)
+    {
+        uint32_t chunk;
+        while (PopFront(m_Queues[queue].Range, chunk))
+        {
+            RunChunk(chunk);
+        }
+
+        for (uint32_t i = 1; i < m_QueueCount; i++)
+        {
+            auto &victim = m_Queues[(queue + i) % m_QueueCount].Range;
+            while (StealBack(victim, chunk))
+            {
+                m_Steals.fetch_add(1, std::memory_order_relaxed);
+                RunChunk(chunk);
+            }
+        }
+    }
+
+    void ScriptScheduler::RunChunk(uint32_t chunk)
+    {
+        const uint32_t begin = chunk * m_ChunkSize;
+        const uint32_t count = std::min(m_ChunkSize, m_Job->Size() - begin);
+        const int succeeded = RunCalls(*m_Job, begin, count, m_JobArgs);
+        if (static_cast<uint32_t>(succeeded) != count)
+        {
+            m_Failed.fetch_add(count - succeeded, std::memory_order_relaxed);
+        }
+    }
+
+    int ScriptScheduler::RunCalls(const CallList &calls, uint32_t begin, uint32_t count, const void *const *args)
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        return m_Host.InvokeOnBatch(calls.Methods.data() + begin, calls.Instances.data() + begin, static_cast<int>(count), args);
+    }
+}
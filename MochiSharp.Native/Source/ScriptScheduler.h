@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef SCRIPT_SCHEDULER_H
+#define SCRIPT_SCHEDULER_H
+
+#include "Host.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MochiSharp
+{
+    // One scheduled call: a type-level binding and the instance to run it on, or a method bound to its
+    // own instance with an empty Instance.
+    struct ScriptCall
+    {
+        MethodHandle Method;
+        InstanceHandle Instance;
+
+        bool operator==(const ScriptCall &) const = default;
+    };
+
+    // Timings of the last Run of a group, in milliseconds.
+    struct ScriptPhaseStats
+    {
+        double ParallelMs = 0.0; // parallel-safe calls, spread across the pool
+        double SerialMs = 0.0;   // the rest, on the calling thread
+        double TotalMs = 0.0;
+        uint32_t ParallelCalls = 0;
+        uint32_t SerialCalls = 0;
+        uint32_t FailedCalls = 0;
+        uint32_t Steals = 0;     // chunks run by a thread other than the one they were dealt to
+    };
+
+    using ScriptGroupId = uint32_t;
+
+    // Runs groups of script calls (e.g. every OnUpdate) once per frame. Calls marked [ParallelSafe] in
+    // managed code are split into chunks, dealt to the workers and the calling thread, and balanced by
+    // work stealing; each chunk is one managed transition (DotNetHost::InvokeOnBatch). All other calls
+    // then run in insertion order on the calling thread.
+    // CreateGroup, Add, Remove and Run must be called from one thread, typically the frame thread.
+    class ScriptScheduler
+    {
+    public:
+        // workerCount 0 starts one worker per hardware thread, minus the calling thread.
+        explicit ScriptScheduler(DotNetHost &host, uint32_t workerCount = 0);
+        ~ScriptScheduler();
+
+        ScriptScheduler(const ScriptScheduler &) = delete;
+        ScriptScheduler &operator=(const ScriptScheduler &) = delete;
+
+        ScriptGroupId CreateGroup(std::string name);
+        // Asks managed code once whether the call is [ParallelSafe] and files it accordingly.
+        void Add(ScriptGroupId group, ScriptCall call);
+        void Remove(ScriptGroupId group, ScriptCall call);
+        void Clear(ScriptGroupId group);
+
+        // Runs every call in the group with the same args (an args array as for DotNetHost::Invoke).
+        const ScriptPhaseStats &Run(ScriptGroupId group, const void *const *args);
+
+        const ScriptPhaseStats &Stats(ScriptGroupId group) const { return m_Groups[group].Stats; }
+        const std::string &GroupName(ScriptGroupId group) const { return m_Groups[group].Name; }
+        uint32_t WorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    private:
+        struct CallList
+        {
+            std::vector<MethodHandle> Methods;
+            std::vector<InstanceHandle> Instances;
+
+            uint32_t Size() const { return static_cast<uint32_t>(Methods.size()); }
+        };
+
+        struct Group
+        {
+            std::string Name;
+            CallList Parallel;
+            CallList Serial;
+            ScriptPhaseStats Stats;
+        };
+
+        // Chunk indices [Begin, End) dealt to one thread, packed as (Begin << 32) | End so both ends move
+        // with one CAS: the owner takes from the front, thieves from the back.
+        struct alignas(64) WorkQueue
+        {
+            std::atomic<uint64_t> Range = 0;
+        };
+
+        void WorkerLoop(uint32_t queue);
+        void RunChunks(uint32_t queue);
+        void RunChunk(uint32_t chunk);
+        int RunCalls(const CallList &calls, uint32_t begin, uint32_t count, const void *const *args);
+
+        DotNetHost &m_Host;
+        std::vector<Group> m_Groups;
+        std::vector<std::thread> m_Workers;
+        // One per worker, plus the calling thread's at the end.
+        std::unique_ptr<WorkQueue[]> m_Queues;
+        uint32_t m_QueueCount = 0;
+
+        // The current job; written before m_Epoch is bumped.
+        const CallList *m_Job = nullptr;
+        const void *const *m_JobArgs = nullptr;
+        uint32_t m_ChunkSize = 0;
+        std::atomic<uint32_t> m_Failed = 0;
+        std::atomic<uint32_t> m_Steals = 0;
+
+        std::atomic<uint64_t> m_Epoch = 0;
+        std::atomic<uint32_t> m_Busy = 0; // workers still inside the current job
+        std::atomic<bool> m_Stopping = false;
+    };
+}
+
+#endif // !SCRIPT_SCHEDULER_H
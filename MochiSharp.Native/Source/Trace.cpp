@@ -0,0 +1,306 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <unistd.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace MochiSharp::Trace
+{
+    // Single producer (its thread), single consumer (Drain, under s_Mutex).
+    struct ThreadBuffer
+    {
+        uint32_t ThreadId = 0;
+        uint32_t Mask = 0;
+        std::unique_ptr<TraceEvent[]> Events;
+        std::atomic<uint64_t> Write = 0;
+        std::atomic<uint64_t> Read = 0;
+        std::atomic<int64_t> Dropped = 0;
+        // Set when the thread exits; it records nothing after that.
+        std::atomic<bool> Exited = false;
+    };
+
+    // Flags the thread's buffer when the thread exits, so Drain can reclaim it.
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer *Buffer = nullptr;
+
+        ~ThreadBufferOwner()
+        {
+            if (Buffer)
+            {
+                Buffer->Exited.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static std::atomic<bool> s_Enabled = false;
+    static std::atomic<int64_t> s_StartNs = 0;
+    static std::atomic<uint32_t> s_EventsPerThread = 1u << 16;
+    static std::mutex s_Mutex;
+    // A buffer lives until its thread has exited and Drain has read it; its event array then goes to
+    // s_FreeEvents for the next thread to register, so thread churn does not grow the trace.
+    static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+    // Arrays of s_EventsPerThread events each.
+    static std::vector<std::unique_ptr<TraceEvent[]>> s_FreeEvents;
+    static std::unordered_map<uint32_t, std::string> s_ThreadNames;
+    static thread_local ThreadBufferOwner t_Buffer;
+
+    int64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint32_t CurrentThreadId()
+    {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentThreadId());
+#else
+        return static_cast<uint32_t>(syscall(SYS_gettid));
+#endif
+    }
+
+    void Start(uint32_t eventsPerThread)
+    {
+        std::lock_guard lock(s_Mutex);
+        uint32_t capacity = std::bit_ceil(std::max(eventsPerThread, 16u));
+        if (capacity != s_EventsPerThread)
+        {
+            s_FreeEvents.clear();
+        }
+        s_EventsPerThread = capacity;
+        for (auto &buffer : s_Buffers)
+        {
+            buffer->Read.store(buffer->Write.load(std::memory_order_acquire), std::memory_order_release);
+            buffer->Dropped = 0;
+        }
+        s_StartNs = NowNs();
+        s_Enabled.store(true, std::memory_order_release);
+    }
+
+    void Stop()
+    {
+        s_Enabled.store(false, std::memory_order_release);
+    }
+
+    bool IsEnabled()
+    {
+        return s_Enabled.load(std::memory_order_relaxed);
+    }
+
+    int64_t StartNs()
+    {
+        return s_StartNs.load(std::memory_order_relaxed);
+    }
+
+    static ThreadBuffer *RegisterThread()
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->ThreadId = CurrentThreadId();
+
+        std::lock_guard lock(s_Mutex);
+        uint32_t capacity = s_EventsPerThread;
+        buffer->Mask = capacity - 1;
+        if (!s_FreeEvents.empty())
+        {
+            buffer->Events = std::move(s_FreeEvents.back());
+            s_FreeEvents.pop_back();
+        }
+        else
+        {
+            buffer->Events = std::make_unique<TraceEvent[]>(capacity);
+        }
+        t_Buffer.Buffer = buffer.get();
+        s_Buffers.push_back(std::move(buffer));
+        return t_Buffer.Buffer;
+    }
+
+    void Record(const TraceEvent &event)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        ThreadBuffer *buffer = t_Buffer.Buffer ? t_Buffer.Buffer : RegisterThread();
+        uint64_t write = buffer->Write.load(std::memory_order_relaxed);
+        if (write - buffer->Read.load(std::memory_order_acquire) > buffer->Mask)
+        {
+            buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer->Events[write & buffer->Mask] = event;
+        buffer->Write.store(write + 1, std::memory_order_release);
+    }
+
+    void Record(const char *name, int64_t beginNs, int64_t endNs, int32_t arg)
+    {
+        TraceEvent event;
+        event.BeginNs = beginNs;
+        event.EndNs = endNs;
+        event.Name = reinterpret_cast<uint64_t>(name);
+        event.ThreadId = CurrentThreadId();
+        event.Arg = arg;
+        Record(event);
+    }
+
+    void SetThreadName(uint32_t threadId, const char *name)
+    {
+        std::lock_guard lock(s_Mutex);
+        s_ThreadNames.try_emplace(threadId, name);
+    }
+
+    void SetThreadName(const char *name)
+    {
+        SetThreadName(CurrentThreadId(), name);
+    }
+
+    int64_t Drain(std::vector<TraceEvent> &out)
+    {
+        std::lock_guard lock(s_Mutex);
+        int64_t dropped = 0;
+        for (size_t i = 0; i < s_Buffers.size();)
+        {
+            ThreadBuffer &buffer = *s_Buffers[i];
+            // Read before Write: once the thread has exited, this drain gets its last event.
+            bool exited = buffer.Exited.load(std::memory_order_acquire);
+            uint64_t read = buffer.Read.load(std::memory_order_relaxed);
+            uint64_t write = buffer.Write.load(std::memory_order_acquire);
+            for (; read != write; read++)
+            {
+                out.push_back(buffer.Events[read & buffer.Mask]);
+            }
+            buffer.Read.store(write, std::memory_order_release);
+            dropped += buffer.Dropped.exchange(0, std::memory_order_relaxed);
+
+            if (!exited)
+            {
+                i++;
+                continue;
+            }
+
+            if (buffer.Mask + 1 == s_EventsPerThread)
+            {
+                s_FreeEvents.push_back(std::move(buffer.Events));
+            }
+            s_Buffers[i] = std::move(s_Buffers.back());
+            s_Buffers.pop_back();
+        }
+        return dropped;
+    }
+
+    static void WriteJsonString(std::ostream &out, std::string_view text)
+    {
+        out << '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                }
+                else
+                {
+                    out << c;
+                }
+            }
+        }
+        out << '"';
+    }
+
+    static const char *Category(TraceEventKind kind)
+    {
+        switch (kind)
+        {
+        case TraceEventKind::Native: return "engine";
+        case TraceEventKind::Invoke:
+        case TraceEventKind::InvokeBatch: return "script";
+        case TraceEventKind::GCPause: return "gc";
+        default: return "host";
+        }
+    }
+
+    // Microseconds with nanosecond precision, as the format expects.
+    static void WriteMicros(std::ostream &out, int64_t ns)
+    {
+        const long long magnitude = ns < 0 ? -static_cast<long long>(ns) : static_cast<long long>(ns);
+        char text[32];
+        std::snprintf(text, sizeof(text), "%s%lld.%03lld", ns < 0 ? "-" : "", magnitude / 1000, magnitude % 1000);
+        out << text;
+    }
+
+    bool WriteChromeJson(const std::filesystem::path &path, const std::vector<TraceEvent> &events,
+        const std::function<std::string(const TraceEvent &)> &name)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        std::unordered_map<uint32_t, std::string> threadNames;
+        {
+            std::lock_guard lock(s_Mutex);
+            threadNames = s_ThreadNames;
+        }
+        threadNames.try_emplace(0, "GC pauses");
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"MochiSharp\"}}";
+        for (const auto &[threadId, threadName] : threadNames)
+        {
+            out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            WriteJsonString(out, threadName);
+            out << "}}";
+        }
+
+        const int64_t startNs = StartNs();
+        for (const TraceEvent &event : events)
+        {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << event.ThreadId << ",\"cat\":\"" << Category(event.Kind) << "\",\"name\":";
+            if (event.Kind == TraceEventKind::Native)
+            {
+                WriteJsonString(out, event.Name ? reinterpret_cast<const char *>(event.Name) : "(unnamed)");
+            }
+            else
+            {
+                WriteJsonString(out, name(event));
+            }
+            out << ",\"ts\":";
+            WriteMicros(out, event.BeginNs - startNs);
+            out << ",\"dur\":";
+            WriteMicros(out, std::max<int64_t>(event.EndNs - event.BeginNs, 0));
+            if (event.Arg != 0 || event.Count != 0)
+            {
+                out << ",\"args\":{\"arg\":" << event.Arg << ",\"count\":" << event.Count << "}";
+            }
+            out << "}";
+        }
+
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Evangelion Manuhutu
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MochiSharp
+{
+    // What a trace event measured (values match TraceEventKind in MochiSharp.Managed). Everything but
+    // Native is recorded by the managed core.
+    enum class TraceEventKind : int32_t
+    {
+        Native = 0,          // a Trace::Scope or Trace::Record span, named by Name
+        Invoke = 1,          // one script call through a method handle
+        InvokeBatch = 2,     // InvokeBatch or InvokeOnBatch; Count is the number of calls
+        CreateInstance = 3,
+        DestroyInstance = 4,
+        Bind = 5,
+        LoadAssembly = 6,    // a synchronous load, a background load, or publishing one
+        Reload = 7,          // BeginReload's background load, or CommitReload
+        Unload = 8,          // PollUnload; Count is the number of contexts still pending
+        GCPause = 9,         // the runtime was suspended for a collection; Arg is the generation
+    };
+
+    // One complete span (layout matches TraceEvent in MochiSharp.Managed).
+    struct TraceEvent
+    {
+        int64_t BeginNs = 0;  // Trace::NowNs clock
+        int64_t EndNs = 0;
+        // Native: a const char * that outlives the trace. Managed: a name id for DotNetHost to resolve,
+        // 0 to name the event by its kind.
+        uint64_t Name = 0;
+        uint32_t ThreadId = 0; // OS thread id; 0 is the GC track
+        TraceEventKind Kind = TraceEventKind::Native;
+        int32_t Arg = 0;
+        int32_t Count = 0;
+    };
+
+    static_assert(sizeof(TraceEvent) == 40, "TraceEvent must match the managed layout");
+
+    // Timeline recording for Chrome's trace viewer (chrome://tracing, ui.perfetto.dev). Each thread
+    // records into its own ring buffer, so recording takes no lock; a full buffer drops events until
+    // the next drain. A buffer is reused once its thread has exited and its events are drained.
+    // Tracing is off until Start; while off, a Scope costs one relaxed load.
+    namespace Trace
+    {
+        // Monotonic nanoseconds from steady_clock, which reads the same counter as .NET's Stopwatch
+        // (QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere), so native and managed
+        // timestamps line up without conversion.
+        int64_t NowNs();
+        uint32_t CurrentThreadId();
+
+        // eventsPerThread is rounded up to a power of two and fixed for a thread when it first records.
+        // Starting again discards events not yet drained.
+        void Start(uint32_t eventsPerThread);
+        void Stop();
+        bool IsEnabled();
+        // When the current trace started, in NowNs time.
+        int64_t StartNs();
+
+        // name must outlive the trace, e.g. a string literal.
+        void Record(const char *name, int64_t beginNs, int64_t endNs, int32_t arg = 0);
+        void Record(const TraceEvent &event);
+        // Shown as the thread's track name. The first name given to a thread sticks.
+        void SetThreadName(uint32_t threadId, const char *name);
+        void SetThreadName(const char *name);
+
+        // Moves every thread's recorded events to out (appending) and returns how many were dropped
+        // since the previous drain.
+        int64_t Drain(std::vector<TraceEvent> &out);
+
+        // Writes events as Chrome trace-event JSON, timestamps relative to StartNs. name(event) names
+        // events other than Native ones.
+        bool WriteChromeJson(const std::filesystem::path &path, const std::vector<TraceEvent> &events,
+            const std::function<std::string(const TraceEvent &)> &name);
+
+        // Records its lifetime as one Native event.
+        class Scope
+        {
+        public:
+            explicit Scope(const char *name) : m_Name(name), m_BeginNs(IsEnabled() ? NowNs() : 0) {}
+            ~Scope()
+            {
+                if (m_BeginNs != 0)
+                {
+                    Record(m_Name, m_BeginNs, NowNs());
+                }
+            }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            const char *m_Name;
+            int64_t m_BeginNs;
+        };
+    }
+}
+
+#endif // !TRACE_H
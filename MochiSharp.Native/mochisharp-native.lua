@@ -21,13 +21,12 @@ project "MochiSharp.Native"
         "%{IncludeDirs.Hostfxr}"
     }
 
-    links {
-        "%{THIRDPARTY_DIR}/dotnet/host/fxr/9.0.11/x64/nethost.lib"
-    }
-
     filter "system:windows"
         systemversion "latest"
         buildoptions { "/utf-8" }
+        links {
+            "%{THIRDPARTY_DIR}/dotnet/host/fxr/9.0.11/x64/nethost.lib"
+        }
         defines {
             "_WINDOWS",
             "_WIN32",
@@ -35,6 +34,9 @@ project "MochiSharp.Native"
             "_CRT_SECURE_NO_WARNINGS"
         }
 
+    filter "system:linux"
+        pic "On"
+
     filter "configurations:Debug"
         runtime "Debug"
         optimize "off"
@@ -0,0 +1,231 @@
+-- Generates an engine API table from one definition: the native struct the engine fills with
+-- callbacks and hands to DotNetHost::SetEngineApi, and the C# facade scripts call it through.
+-- Entries are plain C function pointers called as delegate* unmanaged[Cdecl], so every type must be
+-- blittable: the built-in types below or structs listed under Types. bool crosses as int32.
+--
+-- A definition is a Lua file returning:
+--   Version   = 1,  -- bump only when an existing entry changes meaning; append new entries instead
+--   Native    = { Namespace = "...", Struct = "...", Includes = { "..." } },
+--   Managed   = { Namespace = "...", Class = "...", Struct = "..." },
+--   Types     = { Name = { Native = "...", Managed = "..." } },
+--   Functions = { { Name = "...", Returns = "...", Params = { { "name", "type", Out = true } }, Doc = "..." } },
+-- An Out param is passed as a pointer natively and as an out parameter in the facade.
+--
+-- Usage from a workspace script:
+--   dofile("Tools/engine-api.lua").generate { root = _MAIN_SCRIPT_DIR, definition = "...", native = "...", managed = "..." }
+-- Paths are relative to root (default: the working directory). Files are only rewritten when their
+-- content changes.
+
+local BuiltinTypes = {
+    void   = { Native = "void",     Managed = "void" },
+    bool   = { Native = "int32_t",  Managed = "int", Bool = true },
+    int    = { Native = "int32_t",  Managed = "int" },
+    uint   = { Native = "uint32_t", Managed = "uint" },
+    int64  = { Native = "int64_t",  Managed = "long" },
+    uint64 = { Native = "uint64_t", Managed = "ulong" },
+    float  = { Native = "float",    Managed = "float" },
+    double = { Native = "double",   Managed = "double" },
+    ptr    = { Native = "void *",   Managed = "void*" },
+}
+
+local function resolveType(def, name, where)
+    local t = BuiltinTypes[name] or (def.Types and def.Types[name])
+    if not t then
+        error(string.format("engine-api: unknown type '%s' in %s", tostring(name), where), 0)
+    end
+    return t
+end
+
+-- Facade type of a value; bool entries return and take C# bool.
+local function facadeType(t)
+    return t.Bool and "bool" or t.Managed
+end
+
+local function nativeParam(t, name, out)
+    local type = t.Native .. (out and " *" or "")
+    if type:sub(-1) == "*" then
+        return type .. name
+    end
+    return type .. " " .. name
+end
+
+local function generateNative(def, source)
+    local lines = {}
+    local function add(line) lines[#lines + 1] = line or "" end
+
+    local guard = (def.Native.Struct .. "_GEN_H"):gsub("(%l)(%u)", "%1_%2"):upper()
+
+    add("// Copyright (c) 2025 Evangelion Manuhutu")
+    add()
+    add("// Generated by Tools/engine-api.lua from " .. source .. "; do not edit.")
+    add()
+    add("#ifndef " .. guard)
+    add("#define " .. guard)
+    add()
+    add("#include \"Host.h\"")
+    for _, include in ipairs(def.Native.Includes or {}) do
+        add("#include \"" .. include .. "\"")
+    end
+    add()
+    add("#include <cstdint>")
+    add()
+    add("namespace " .. def.Native.Namespace)
+    add("{")
+    add("    // Fill in the callbacks and pass &Header to DotNetHost::SetEngineApi before Init. bool is int32_t.")
+    add("    struct " .. def.Native.Struct)
+    add("    {")
+    add("        static constexpr uint32_t CurrentVersion = " .. def.Version .. ";")
+    add()
+    add("        MochiSharp::EngineApiHeader Header = { CurrentVersion, static_cast<uint32_t>(sizeof(" .. def.Native.Struct .. ")) };")
+    for _, fn in ipairs(def.Functions) do
+        local where = def.Native.Struct .. "::" .. fn.Name
+        local params = {}
+        for _, p in ipairs(fn.Params or {}) do
+            params[#params + 1] = nativeParam(resolveType(def, p[2], where), p[1], p.Out)
+        end
+        if fn.Doc then
+            add("        // " .. fn.Doc)
+        end
+        local ret = resolveType(def, fn.Returns or "void", where).Native
+        add(string.format("        %s (*%s)(%s) = nullptr;", ret, fn.Name, table.concat(params, ", ")))
+    end
+    add("    };")
+    add("}")
+    add()
+    add("#endif // !" .. guard)
+    return table.concat(lines, "\n") .. "\n"
+end
+
+local function generateManaged(def, source)
+    local lines = {}
+    local function add(line) lines[#lines + 1] = line or "" end
+
+    local table_ = def.Managed.Struct
+    add("// <auto-generated>")
+    add("// Generated by Tools/engine-api.lua from " .. source .. "; do not edit.")
+    add("// </auto-generated>")
+    add("using System.Runtime.InteropServices;")
+    add("using MochiSharp.Managed.Core;")
+    add()
+    add("namespace " .. def.Managed.Namespace)
+    add("{")
+    add("    // Layout matches " .. def.Native.Namespace .. "::" .. def.Native.Struct .. ".")
+    add("    [StructLayout(LayoutKind.Sequential)]")
+    add("    public unsafe struct " .. table_)
+    add("    {")
+    add("        public const uint CurrentVersion = " .. def.Version .. ";")
+    add()
+    add("        public EngineApiHeader Header;")
+    for _, fn in ipairs(def.Functions) do
+        local where = table_ .. "." .. fn.Name
+        local types = {}
+        for _, p in ipairs(fn.Params or {}) do
+            types[#types + 1] = resolveType(def, p[2], where).Managed .. (p.Out and "*" or "")
+        end
+        types[#types + 1] = resolveType(def, fn.Returns or "void", where).Managed
+        add(string.format("        public delegate* unmanaged[Cdecl]<%s> %s;", table.concat(types, ", "), fn.Name))
+    end
+    add("    }")
+    add()
+    add("    // Calls into the engine: one load of the cached table and an indirect call, nothing marshaled.")
+    add("    // Check IsAvailable (or Has<Name> for entries added after the engine was built) before calling.")
+    add("    public static unsafe class " .. def.Managed.Class)
+    add("    {")
+    add("        private static readonly " .. table_ .. "* _table = EngineApi.Get<" .. table_ .. ">(" .. table_ .. ".CurrentVersion);")
+    add()
+    add("        public static bool IsAvailable => _table != null;")
+    for _, fn in ipairs(def.Functions) do
+        local where = def.Managed.Class .. "." .. fn.Name
+        local ret = resolveType(def, fn.Returns or "void", where)
+        local params, args, outs = {}, {}, {}
+        for _, p in ipairs(fn.Params or {}) do
+            local t = resolveType(def, p[2], where)
+            if p.Out then
+                params[#params + 1] = "out " .. facadeType(t) .. " " .. p[1]
+                args[#args + 1] = p[1] .. "Ptr"
+                outs[#outs + 1] = { Type = t, Name = p[1] }
+            else
+                params[#params + 1] = facadeType(t) .. " " .. p[1]
+                args[#args + 1] = t.Bool and ("(" .. p[1] .. " ? 1 : 0)") or p[1]
+            end
+        end
+
+        local call = "_table->" .. fn.Name .. "(" .. table.concat(args, ", ") .. ")"
+        if ret.Bool then
+            call = call .. " != 0"
+        end
+
+        add()
+        if fn.Doc then
+            add("        // " .. fn.Doc)
+        end
+        local signature = string.format("        public static %s %s(%s)", facadeType(ret), fn.Name, table.concat(params, ", "))
+        if #outs == 0 then
+            add(signature .. " => " .. call .. ";")
+        else
+            add(signature)
+            add("        {")
+            local indent = "            "
+            for _, o in ipairs(outs) do
+                add(indent .. o.Name .. " = default;")
+            end
+            for _, o in ipairs(outs) do
+                add(indent .. "fixed (" .. o.Type.Managed .. "* " .. o.Name .. "Ptr = &" .. o.Name .. ")")
+            end
+            add(indent .. "{")
+            add(indent .. "    " .. (ret.Managed == "void" and "" or "return ") .. call .. ";")
+            add(indent .. "}")
+            add("        }")
+        end
+        add(string.format("        public static bool Has%s => _table != null && _table->%s != null;", fn.Name, fn.Name))
+    end
+    add("    }")
+    add("}")
+    return table.concat(lines, "\n") .. "\n"
+end
+
+local function writeIfChanged(path, content)
+    local file = io.open(path, "rb")
+    if file then
+        local existing = file:read("a")
+        file:close()
+        if existing == content then
+            return
+        end
+    end
+
+    file = assert(io.open(path, "wb"))
+    file:write(content)
+    file:close()
+    print("engine-api: wrote " .. path)
+end
+
+local M = {}
+
+function M.generate(options)
+    local function resolve(path)
+        return options.root and (options.root .. "/" .. path) or path
+    end
+
+    local def = dofile(resolve(options.definition))
+    if type(def.Version) ~= "number" or def.Version < 1 then
+        error("engine-api: " .. options.definition .. " needs a Version >= 1", 0)
+    end
+
+    for _, fn in ipairs(def.Functions) do
+        for _, p in ipairs(fn.Params or {}) do
+            if p.Out and resolveType(def, p[2], fn.Name).Bool then
+                error("engine-api: bool out parameters are not supported (" .. fn.Name .. "." .. p[1] .. ")", 0)
+            end
+        end
+    end
+
+    if options.native then
+        writeIfChanged(resolve(options.native), generateNative(def, options.definition))
+    end
+    if options.managed then
+        writeIfChanged(resolve(options.managed), generateManaged(def, options.definition))
+    end
+end
+
+return M
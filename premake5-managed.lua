@@ -11,9 +11,21 @@ workspace "MochiSharp-Managed"
     -- Thirdparty
     THIRDPARTY_DIR = "%{wks.location}/ThirdParty"
 
+    -- Example engine API table: native struct and C# facade generated from one definition
+    dofile("Tools/engine-api.lua").generate {
+        root = _MAIN_SCRIPT_DIR,
+        definition = "Example/example-engine-api.lua",
+        native = "Example/Native/Source/EngineApi.gen.h",
+        managed = "Example/Managed/EngineApi.gen.cs",
+    }
+
     -- Projects
     include "MochiSharp.Managed/mochisharp-managed.lua"
     
     group "Example"
     include "Example/Managed/example-managed.lua"
+    group ""
+
+    group "Benchmarks"
+    include "Benchmarks/Managed/benchmarks-managed.lua"
     group ""
\ No newline at end of file
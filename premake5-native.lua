@@ -1,3 +1,49 @@
+-- Linux links the static nethost from the .NET SDK's apphost pack instead of a vendored copy: the newest
+-- packs/Microsoft.NETCore.App.Host.linux-x64/<version>/runtimes/linux-x64/native under NETHOST_DIR (the
+-- native directory itself), DOTNET_ROOT, ~/.dotnet or a distribution install.
+local function VersionNewer(a, b)
+    local partsA, partsB = {}, {}
+    for part in a:gmatch("%d+") do table.insert(partsA, tonumber(part)) end
+    for part in b:gmatch("%d+") do table.insert(partsB, tonumber(part)) end
+    for i = 1, math.max(#partsA, #partsB) do
+        local x, y = partsA[i] or 0, partsB[i] or 0
+        if x ~= y then
+            return x > y
+        end
+    end
+    return false
+end
+
+local function FindLinuxNetHost()
+    local override = os.getenv("NETHOST_DIR")
+    if override and os.isfile(override .. "/libnethost.a") then
+        return override
+    end
+
+    local roots = {}
+    if os.getenv("DOTNET_ROOT") then table.insert(roots, os.getenv("DOTNET_ROOT")) end
+    if os.getenv("HOME") then table.insert(roots, os.getenv("HOME") .. "/.dotnet") end
+    table.insert(roots, "/usr/share/dotnet")
+    table.insert(roots, "/usr/lib/dotnet")
+    table.insert(roots, "/usr/lib64/dotnet")
+
+    for _, root in ipairs(roots) do
+        local found, foundVersion
+        for _, dir in ipairs(os.matchdirs(root .. "/packs/Microsoft.NETCore.App.Host.linux-x64/*")) do
+            local native = dir .. "/runtimes/linux-x64/native"
+            local version = path.getname(dir)
+            if os.isfile(native .. "/libnethost.a") and (not found or VersionNewer(version, foundVersion)) then
+                found, foundVersion = native, version
+            end
+        end
+        if found then
+            return found
+        end
+    end
+
+    error("libnethost.a not found: install the .NET SDK, or set DOTNET_ROOT or NETHOST_DIR")
+end
+
 workspace "MochiSharp"
     flags { "MultiProcessorCompile" }
     configurations {"Debug", "Release" }
@@ -17,9 +63,25 @@ workspace "MochiSharp"
     IncludeDirs = {}
     IncludeDirs["Hostfxr"] = "%{wks.location}/NetCore/include"
 
+    if os.target() == "linux" then
+        NETHOST_LINUX_DIR = FindLinuxNetHost()
+    end
+
+    -- Example engine API table: native struct and C# facade generated from one definition
+    dofile("Tools/engine-api.lua").generate {
+        root = _MAIN_SCRIPT_DIR,
+        definition = "Example/example-engine-api.lua",
+        native = "Example/Native/Source/EngineApi.gen.h",
+        managed = "Example/Managed/EngineApi.gen.cs",
+    }
+
     -- Projects
     include "MochiSharp.Native/mochisharp-native.lua"
 
     group "Example"
     include "Example/Native/example-native.lua"
+    group ""
+
+    group "Benchmarks"
+    include "Benchmarks/Native/benchmarks-native.lua"
     group ""
\ No newline at end of file